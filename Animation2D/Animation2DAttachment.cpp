@@ -307,6 +307,7 @@ MeshAttachment::MeshAttachment()
 	, m_vuBoneCounts()
 	, m_vLinks()
 	, m_vVertices()
+	, m_SkinningLayout()
 {
 }
 
@@ -348,6 +349,20 @@ Bool MeshAttachment::Load(ReadWriteUtil& r)
 	bReturn = bReturn && r.Read(m_vuBoneCounts);
 	bReturn = bReturn && r.Read(m_vLinks);
 	bReturn = bReturn && r.Read(m_vVertices);
+	bReturn = bReturn && m_SkinningLayout.Load(r);
+
+	// Sanity check that the cooked layout matches the mesh - a weighted
+	// mesh must have a layout, or it would silently never be skinned.
+	if (bReturn && !m_vuBoneCounts.IsEmpty())
+	{
+		bReturn = bReturn && !m_SkinningLayout.IsEmpty();
+		bReturn = bReturn && (m_SkinningLayout.GetVertexCount() == m_vuBoneCounts.GetSize());
+		bReturn = bReturn && (m_SkinningLayout.GetSourceCount() == m_vVertices.GetSize());
+	}
+	else if (bReturn)
+	{
+		bReturn = bReturn && m_SkinningLayout.IsEmpty();
+	}
 	return bReturn;
 }
 
@@ -365,13 +380,16 @@ Bool MeshAttachment::Save(ReadWriteUtil& r) const
 	bReturn = bReturn && r.Write(m_vuBoneCounts);
 	bReturn = bReturn && r.Write(m_vLinks);
 	bReturn = bReturn && r.Write(m_vVertices);
+	bReturn = bReturn && m_SkinningLayout.Save(r);
 	return bReturn;
 }
 
+/**
+ * Cook time only - the edge list is serialized
+ * with the mesh and not recomputed on load.
+ */
 void MeshAttachment::ComputeEdges()
 {
-	// TODO: Move this into the cooker.
-
 	// TODO: Configure - three edges is 3 triangles worth
 	// of unique edges.
 	static const UInt32 kuMaxEdges = 9u;
@@ -405,6 +423,28 @@ void MeshAttachment::ComputeEdges()
 	m_vEdges.Resize(Min(m_vEdges.GetSize(), kuMaxEdges));
 }
 
+/**
+ * Cook time only - flatten m_vuBoneCounts and m_vLinks into the layout
+ * consumed by the skinning kernel. Empty for meshes without bone links.
+ */
+void MeshAttachment::ComputeSkinningLayout()
+{
+	m_SkinningLayout.Clear();
+
+	// Malformed data, leave the layout empty so skinning is skipped.
+	UInt32 uLinks = 0u;
+	for (auto const u : m_vuBoneCounts)
+	{
+		uLinks += u;
+	}
+	if (uLinks != m_vLinks.GetSize() || uLinks != m_vVertices.GetSize())
+	{
+		return;
+	}
+
+	m_SkinningLayout.Build(m_vuBoneCounts.Data(), m_vuBoneCounts.GetSize(), m_vLinks.Data());
+}
+
 /**
  * Insert an edge - if successful, compute terms that
  * will later be used for texture resolution computation.
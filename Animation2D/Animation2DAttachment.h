@@ -13,6 +13,8 @@
 #define ANIMATION2D_ATTACHMENT_H
 
 #include "FilePath.h"
+#include "Animation2DMemoryUsage.h"
+#include "Animation2DSkinning.h"
 #include "HashSet.h"
 #include "Prereqs.h"
 #include "ReflectionDeclare.h"
@@ -65,6 +67,9 @@ public:
 
 	virtual AttachmentType GetType() const = 0;
 
+	// Total memory footprint of this attachment, in bytes.
+	virtual UInt32 GetMemoryUsage() const = 0;
+
 protected:
 	SEOUL_REFERENCE_COUNTED(Attachment);
 
@@ -88,6 +93,7 @@ public:
 	virtual Bool Save(ReadWriteUtil& r) const SEOUL_OVERRIDE;
 
 	virtual AttachmentType GetType() const SEOUL_OVERRIDE { return AttachmentType::kBitmap; }
+	virtual UInt32 GetMemoryUsage() const SEOUL_OVERRIDE { return (UInt32)sizeof(*this); }
 
 	FilePath GetFilePath() const { return m_FilePath; }
 
@@ -137,6 +143,7 @@ public:
 	virtual Bool Save(ReadWriteUtil& r) const SEOUL_OVERRIDE;
 
 	virtual AttachmentType GetType() const SEOUL_OVERRIDE { return AttachmentType::kBoundingBox; }
+	virtual UInt32 GetMemoryUsage() const SEOUL_OVERRIDE { return (UInt32)sizeof(*this); }
 
 private:
 	SEOUL_REFERENCE_COUNTED_SUBCLASS(BoundingBoxAttachment);
@@ -254,8 +261,20 @@ public:
 	virtual Bool Save(ReadWriteUtil& r) const SEOUL_OVERRIDE;
 
 	void ComputeEdges();
+	void ComputeSkinningLayout();
 
 	virtual AttachmentType GetType() const SEOUL_OVERRIDE { return AttachmentType::kMesh; }
+	virtual UInt32 GetMemoryUsage() const SEOUL_OVERRIDE
+	{
+		return (UInt32)sizeof(*this) +
+			GetHeapSize(m_vEdges) +
+			GetHeapSize(m_vuIndices) +
+			GetHeapSize(m_vTexCoords) +
+			GetHeapSize(m_vuBoneCounts) +
+			GetHeapSize(m_vLinks) +
+			GetHeapSize(m_vVertices) +
+			m_SkinningLayout.GetHeapSize();
+	}
 
 	const Indices& GetBoneCounts() const { return m_vuBoneCounts; }
 	RGBA GetColor() const { return m_Color; }
@@ -264,6 +283,7 @@ public:
 	Float32 GetHeight() const { return m_fHeight; }
 	const Indices& GetIndices() const { return m_vuIndices; }
 	const Links& GetLinks() const { return m_vLinks; }
+	const SkinningLayout& GetSkinningLayout() const { return m_SkinningLayout; }
 	const Vector2Ds& GetTexCoords() const { return m_vTexCoords; }
 	const Vector2Ds& GetVertices() const { return m_vVertices; }
 	Float32 GetWidth() const { return m_fWidth; }
@@ -294,6 +314,10 @@ private:
 	Links m_vLinks;
 	Vector2Ds m_vVertices;
 
+	// Built from m_vuBoneCounts and m_vLinks at cook time and
+	// serialized with the mesh.
+	SkinningLayout m_SkinningLayout;
+
 	Bool CustomDeserializeTexCoords(
 		Reflection::SerializeContext* pContext,
 		DataStore const* pDataStore,
@@ -322,6 +346,7 @@ public:
 	virtual Bool Save(ReadWriteUtil& r) const SEOUL_OVERRIDE;
 
 	virtual AttachmentType GetType() const SEOUL_OVERRIDE { return AttachmentType::kLinkedMesh; }
+	virtual UInt32 GetMemoryUsage() const SEOUL_OVERRIDE { return (UInt32)sizeof(*this); }
 
 	RGBA GetColor() const { return m_Color; }
 	Bool GetDeform() const { return m_bDeform; }
@@ -370,6 +395,14 @@ public:
 	virtual Bool Save(ReadWriteUtil& r) const SEOUL_OVERRIDE;
 
 	virtual AttachmentType GetType() const SEOUL_OVERRIDE { return AttachmentType::kPath; }
+	virtual UInt32 GetMemoryUsage() const SEOUL_OVERRIDE
+	{
+		return (UInt32)sizeof(*this) +
+			GetHeapSize(m_vBoneCounts) +
+			GetHeapSize(m_vLengths) +
+			GetHeapSize(m_vVertices) +
+			GetHeapSize(m_vWeights);
+	}
 
 	const BoneCounts& GetBoneCounts() const { return m_vBoneCounts; }
 	Bool GetClosed() const { return m_bClosed; }
@@ -417,6 +450,7 @@ public:
 	virtual Bool Save(ReadWriteUtil& r) const SEOUL_OVERRIDE;
 
 	virtual AttachmentType GetType() const SEOUL_OVERRIDE { return AttachmentType::kPoint; }
+	virtual UInt32 GetMemoryUsage() const SEOUL_OVERRIDE { return (UInt32)sizeof(*this); }
 
 private:
 	SEOUL_REFERENCE_COUNTED_SUBCLASS(PointAttachment);
@@ -448,6 +482,13 @@ public:
 	virtual Bool Save(ReadWriteUtil& r) const SEOUL_OVERRIDE;
 
 	virtual AttachmentType GetType() const SEOUL_OVERRIDE { return AttachmentType::kClipping; }
+	virtual UInt32 GetMemoryUsage() const SEOUL_OVERRIDE
+	{
+		return (UInt32)sizeof(*this) +
+			GetHeapSize(m_vBoneCounts) +
+			GetHeapSize(m_vVertices) +
+			GetHeapSize(m_vWeights);
+	}
 
 	const BoneCounts& GetBoneCounts() const { return m_vBoneCounts; }
 	const Vertices& GetVertices() const { return m_vVertices; }
@@ -0,0 +1,243 @@
+/**
+ * \file Animation2DBakedClip.cpp
+ * \brief Offline sampled form of an Animation2D::Clip. Stores
+ * the posed skinning palette, slot state and draw order of a clip
+ * at a fixed sample rate, so that playback is a blend of two
+ * samples instead of timeline evaluation and constraint solving.
+ *
+ * Copyright (c) 2016-2022 Demiurge Studios Inc. All rights reserved.
+ */
+
+#include "AnimationClipSettings.h"
+#include "AnimationEventInterface.h"
+#include "Animation2DBakedClip.h"
+#include "Animation2DClipDefinition.h"
+#include "Animation2DClipInstance.h"
+#include "Animation2DDataDefinition.h"
+#include "Animation2DMemoryUsage.h"
+#include "Animation2DReadWriteUtil.h"
+#include "SeoulMath.h"
+
+#if SEOUL_WITH_ANIMATION_2D
+
+namespace Seoul::Animation2D
+{
+
+/** Component-wise blend of two palette entries. */
+static inline void LerpPaletteEntry(const Matrix2x3& m0, const Matrix2x3& m1, Float fT, Matrix2x3& r)
+{
+	r.M00 = Lerp(m0.M00, m1.M00, fT);
+	r.M01 = Lerp(m0.M01, m1.M01, fT);
+	r.M02 = Lerp(m0.M02, m1.M02, fT);
+	r.M10 = Lerp(m0.M10, m1.M10, fT);
+	r.M11 = Lerp(m0.M11, m1.M11, fT);
+	r.M12 = Lerp(m0.M12, m1.M12, fT);
+}
+
+BakedClip::BakedClip()
+	: m_vPalettes()
+	, m_vAttachments()
+	, m_vColors()
+	, m_viDrawOrder()
+	, m_fSampleRate(0.0f)
+	, m_uBones(0u)
+	, m_uFrames(0u)
+	, m_uSlots(0u)
+{
+}
+
+BakedClip::~BakedClip()
+{
+}
+
+/**
+ * Sample pClip into r. Each sample is the fully posed state of a
+ * DataInstance of pData with only pClip applied, at full weight.
+ * Deform timelines are not supported, since deformed vertices are
+ * instance state that is not captured by a baked clip.
+ */
+Bool BakedClip::Bake(
+	const SharedPtr<DataDefinition const>& pData,
+	const SharedPtr<Clip>& pClip,
+	Float fSampleRate,
+	BakedClip& r)
+{
+	if (!pData.IsValid() || !pClip.IsValid() || !(fSampleRate > 0.0f))
+	{
+		return false;
+	}
+
+	if (!pClip->GetDeforms().IsEmpty())
+	{
+		return false;
+	}
+
+	DataInstance instance(pData, SharedPtr<Animation::EventInterface>());
+	ClipInstance clip(instance, pClip, Animation::ClipSettings());
+
+	// Always include a sample at (or past) the end of the clip.
+	auto const fMaxTime = clip.GetMaxTime();
+	UInt32 const uFrames = (UInt32)Ceil(fMaxTime * fSampleRate) + 1u;
+	UInt32 const uBones = pData->GetBones().GetSize();
+	UInt32 const uSlots = pData->GetSlots().GetSize();
+
+	r.m_vPalettes.Clear();
+	r.m_vAttachments.Clear();
+	r.m_vColors.Clear();
+	r.m_viDrawOrder.Clear();
+	r.m_vPalettes.Reserve(uFrames * uBones);
+	r.m_vAttachments.Reserve(uFrames * uSlots);
+	r.m_vColors.Reserve(uFrames * uSlots);
+	r.m_viDrawOrder.Reserve(uFrames * uSlots);
+
+	for (UInt32 uFrame = 0u; uFrame < uFrames; ++uFrame)
+	{
+		auto const fTime = Min((Float)uFrame / fSampleRate, fMaxTime);
+		clip.Evaluate(fTime, 1.0f, false);
+		instance.ApplyCache();
+		instance.Pose();
+
+		for (auto const& m : instance.GetSkinningPalette())
+		{
+			r.m_vPalettes.PushBack(m);
+		}
+		for (auto const& slot : instance.GetSlots())
+		{
+			r.m_vAttachments.PushBack(slot.m_AttachmentId);
+			r.m_vColors.PushBack(slot.m_Color);
+		}
+		for (auto const i : instance.GetDrawOrder())
+		{
+			r.m_viDrawOrder.PushBack(i);
+		}
+	}
+
+	r.m_fSampleRate = fSampleRate;
+	r.m_uBones = uBones;
+	r.m_uFrames = uFrames;
+	r.m_uSlots = uSlots;
+	return true;
+}
+
+Bool BakedClip::Load(ReadWriteUtil& r)
+{
+	Bool bReturn = true;
+	bReturn = bReturn && r.Read(m_vPalettes);
+	bReturn = bReturn && r.Read(m_vAttachments);
+	bReturn = bReturn && r.Read(m_vColors);
+	bReturn = bReturn && r.Read(m_viDrawOrder);
+	bReturn = bReturn && r.Read(m_fSampleRate);
+	bReturn = bReturn && r.Read(m_uBones);
+	bReturn = bReturn && r.Read(m_uFrames);
+	bReturn = bReturn && r.Read(m_uSlots);
+
+	// Sanity check sizes, Sample() relies on them. Products are
+	// in 64-bits so that corrupt counts cannot wrap. Bone and slot counts
+	// are checked against the owning definition (see DataDefinition::Load()).
+	UInt64 const uBoneEntries = ((UInt64)m_uFrames * (UInt64)m_uBones);
+	UInt64 const uSlotEntries = ((UInt64)m_uFrames * (UInt64)m_uSlots);
+	bReturn = bReturn && (m_uFrames > 0u);
+	bReturn = bReturn && (m_fSampleRate > 0.0f);
+	bReturn = bReturn && ((UInt64)m_vPalettes.GetSize() == uBoneEntries);
+	bReturn = bReturn && ((UInt64)m_vAttachments.GetSize() == uSlotEntries);
+	bReturn = bReturn && ((UInt64)m_vColors.GetSize() == uSlotEntries);
+	bReturn = bReturn && ((UInt64)m_viDrawOrder.GetSize() == uSlotEntries);
+
+	// Draw order entries index slots.
+	if (bReturn)
+	{
+		for (auto const i : m_viDrawOrder)
+		{
+			if (i < 0 || (UInt32)i >= m_uSlots)
+			{
+				bReturn = false;
+				break;
+			}
+		}
+	}
+
+	return bReturn;
+}
+
+Bool BakedClip::Save(ReadWriteUtil& r) const
+{
+	Bool bReturn = true;
+	bReturn = bReturn && r.Write(m_vPalettes);
+	bReturn = bReturn && r.Write(m_vAttachments);
+	bReturn = bReturn && r.Write(m_vColors);
+	bReturn = bReturn && r.Write(m_viDrawOrder);
+	bReturn = bReturn && r.Write(m_fSampleRate);
+	bReturn = bReturn && r.Write(m_uBones);
+	bReturn = bReturn && r.Write(m_uFrames);
+	bReturn = bReturn && r.Write(m_uSlots);
+	return bReturn;
+}
+
+void BakedClip::Sample(
+	Float fTime,
+	DataInstance::SkinningPalette& rvPalette,
+	DataInstance::SlotInstances& rvSlots,
+	DataInstance::DrawOrder& rvDrawOrder) const
+{
+	SEOUL_ASSERT(rvPalette.GetSize() == m_uBones);
+	SEOUL_ASSERT(rvSlots.GetSize() == m_uSlots);
+	SEOUL_ASSERT(rvDrawOrder.GetSize() == m_uSlots);
+
+	UInt32 const uLast = m_uFrames - 1u;
+	auto const fFrame = Clamp(fTime * m_fSampleRate, 0.0f, (Float)uLast);
+	UInt32 const u0 = Min((UInt32)fFrame, uLast);
+	UInt32 const u1 = Min(u0 + 1u, uLast);
+	auto const fT = (fFrame - (Float)u0);
+
+	// Palette, blended.
+	{
+		auto p0 = m_vPalettes.Get(u0 * m_uBones);
+		auto p1 = m_vPalettes.Get(u1 * m_uBones);
+		for (UInt32 i = 0u; i < m_uBones; ++i)
+		{
+			LerpPaletteEntry(p0[i], p1[i], fT, rvPalette[i]);
+		}
+	}
+
+	// Slots and draw order, stepped.
+	UInt32 const uOffset = u0 * m_uSlots;
+	for (UInt32 i = 0u; i < m_uSlots; ++i)
+	{
+		auto& r = rvSlots[i];
+		r.m_AttachmentId = m_vAttachments[uOffset + i];
+		r.m_Color = m_vColors[uOffset + i];
+	}
+	if (m_uSlots > 0u)
+	{
+		memcpy(rvDrawOrder.Data(), m_viDrawOrder.Get(uOffset), m_uSlots * sizeof(Int16));
+	}
+}
+
+/** @return The total memory footprint of this clip, in bytes. */
+UInt32 BakedClip::GetMemoryUsage() const
+{
+	return
+		(UInt32)sizeof(*this) +
+		GetHeapSize(m_vPalettes) +
+		GetHeapSize(m_vAttachments) +
+		GetHeapSize(m_vColors) +
+		GetHeapSize(m_viDrawOrder);
+}
+
+Bool BakedClip::operator==(const BakedClip& b) const
+{
+	Bool bReturn = true;
+	bReturn = bReturn && (m_vPalettes == b.m_vPalettes);
+	bReturn = bReturn && (m_vAttachments == b.m_vAttachments);
+	bReturn = bReturn && (m_vColors == b.m_vColors);
+	bReturn = bReturn && (m_viDrawOrder == b.m_viDrawOrder);
+	bReturn = bReturn && (m_fSampleRate == b.m_fSampleRate);
+	bReturn = bReturn && (m_uBones == b.m_uBones);
+	bReturn = bReturn && (m_uFrames == b.m_uFrames);
+	bReturn = bReturn && (m_uSlots == b.m_uSlots);
+	return bReturn;
+}
+
+} // namespace Seoul::Animation2D
+
+#endif // /#if SEOUL_WITH_ANIMATION_2D
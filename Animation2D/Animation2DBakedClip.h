@@ -0,0 +1,97 @@
+/**
+ * \file Animation2DBakedClip.h
+ * \brief Offline sampled form of an Animation2D::Clip. Stores
+ * the posed skinning palette, slot state and draw order of a clip
+ * at a fixed sample rate, so that playback is a blend of two
+ * samples instead of timeline evaluation and constraint solving.
+ *
+ * Copyright (c) 2016-2022 Demiurge Studios Inc. All rights reserved.
+ */
+
+#pragma once
+#ifndef ANIMATION2D_BAKED_CLIP_H
+#define ANIMATION2D_BAKED_CLIP_H
+
+#include "Animation2DDataInstance.h"
+#include "Matrix2x3.h"
+#include "Prereqs.h"
+#include "SharedPtr.h"
+#include "Vector.h"
+namespace Seoul { namespace Animation2D { class Clip; } }
+namespace Seoul { namespace Animation2D { class DataDefinition; } }
+namespace Seoul { namespace Animation2D { class ReadWriteUtil; } }
+
+#if SEOUL_WITH_ANIMATION_2D
+
+namespace Seoul::Animation2D
+{
+
+class BakedClip SEOUL_SEALED
+{
+public:
+	typedef Vector<HString, MemoryBudgets::Animation2D> Attachments;
+	typedef Vector<RGBA, MemoryBudgets::Animation2D> Colors;
+	typedef Vector<Int16, MemoryBudgets::Animation2D> DrawOrders;
+	typedef Vector<Matrix2x3, MemoryBudgets::Animation2D> Palettes;
+
+	BakedClip();
+	~BakedClip();
+
+	// Cook time only - sample pClip of pData at fSampleRate samples per second.
+	// Returns false if pClip cannot be baked (e.g. it has deform timelines,
+	// which are per instance state).
+	static Bool Bake(
+		const SharedPtr<DataDefinition const>& pData,
+		const SharedPtr<Clip>& pClip,
+		Float fSampleRate,
+		BakedClip& r);
+
+	// Direct to binary support.
+	Bool Load(ReadWriteUtil& r);
+	Bool Save(ReadWriteUtil& r) const;
+
+	// Set the skinning palette, slots and draw order of a DataInstance
+	// to the state of this clip at fTime. Palettes are blended between
+	// the two nearest samples, discrete state is taken from the sample
+	// at or before fTime. Output arrays must be sized to the definition.
+	void Sample(
+		Float fTime,
+		DataInstance::SkinningPalette& rvPalette,
+		DataInstance::SlotInstances& rvSlots,
+		DataInstance::DrawOrder& rvDrawOrder) const;
+
+	UInt32 GetBoneCount() const { return m_uBones; }
+	UInt32 GetFrameCount() const { return m_uFrames; }
+	Float32 GetSampleRate() const { return m_fSampleRate; }
+	UInt32 GetSlotCount() const { return m_uSlots; }
+
+	// Total memory footprint of this clip, in bytes.
+	UInt32 GetMemoryUsage() const;
+
+	Bool operator==(const BakedClip& b) const;
+	Bool operator!=(const BakedClip& b) const
+	{
+		return !(*this == b);
+	}
+
+private:
+	SEOUL_REFERENCE_COUNTED(BakedClip);
+
+	// Sample u is at m_vPalettes[u * m_uBones], etc.
+	Palettes m_vPalettes;
+	Attachments m_vAttachments;
+	Colors m_vColors;
+	DrawOrders m_viDrawOrder;
+	Float32 m_fSampleRate;
+	UInt32 m_uBones;
+	UInt32 m_uFrames;
+	UInt32 m_uSlots;
+
+	SEOUL_DISABLE_COPY(BakedClip);
+}; // class BakedClip
+
+} // namespace Seoul::Animation2D
+
+#endif // /#if SEOUL_WITH_ANIMATION_2D
+
+#endif // include guard
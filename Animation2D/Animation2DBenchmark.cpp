@@ -0,0 +1,726 @@
+/**
+ * \file Animation2DBenchmark.cpp
+ * \brief Developer only benchmark of the Animation2D runtime. Times
+ * each phase of the runtime (definition load, instance construction,
+ * clip evaluation, cache application and posing) against cooked rigs
+ * or against synthetic rigs of configurable complexity, and reports
+ * results in a machine readable (JSON) format.
+ *
+ * Copyright (c) 2016-2022 Demiurge Studios Inc. All rights reserved.
+ */
+
+#include "AnimationClipSettings.h"
+#include "Animation2DBenchmark.h"
+#include "Animation2DClipDefinition.h"
+#include "Animation2DClipInstance.h"
+#include "Animation2DDataDefinition.h"
+#include "Animation2DDataInstance.h"
+#include "Animation2DReadWriteUtil.h"
+#include "CheckedPtr.h"
+#include "Compress.h"
+#include "DataStore.h"
+#include "DataStoreParser.h"
+#include "FileManager.h"
+#include "JobsJob.h"
+#include "ReflectionDeserialize.h"
+#include "SeoulMath.h"
+#include "SeoulTime.h"
+
+#if SEOUL_WITH_ANIMATION_2D && !SEOUL_SHIP
+
+namespace Seoul::Animation2D
+{
+
+BenchmarkResult::BenchmarkResult()
+	: m_sRig()
+	, m_Settings()
+	, m_aPhases{
+		BenchmarkPhase("DefinitionLoad"),
+		BenchmarkPhase("InstanceConstruct"),
+		BenchmarkPhase("InstanceClone"),
+		BenchmarkPhase("ClipInstanceConstruct"),
+		BenchmarkPhase("Evaluate"),
+		BenchmarkPhase("ApplyCache"),
+		BenchmarkPhase("PoseSkinningPalette") }
+	, m_iFrameWallTicks(0)
+	, m_bSuccess(false)
+{
+	SEOUL_STATIC_ASSERT(7u == (UInt32)BenchmarkPhaseType::COUNT);
+}
+
+namespace Benchmark
+{
+
+namespace
+{
+
+typedef Vector<CheckedPtr<ClipInstance>, MemoryBudgets::Animation2D> ClipInstances;
+typedef Vector<CheckedPtr<DataInstance>, MemoryBudgets::Animation2D> DataInstances;
+
+/** Subset of the instances of a run, advanced by a single thread. */
+struct Worker SEOUL_SEALED
+{
+	Worker()
+		: m_pClips(nullptr)
+		, m_pInstances(nullptr)
+		, m_uBegin(0u)
+		, m_uEnd(0u)
+		, m_uFrames(0u)
+		, m_fDeltaTimeInSeconds(0.0f)
+		, m_Evaluate()
+		, m_ApplyCache()
+		, m_Pose()
+	{
+	}
+
+	ClipInstances const* m_pClips;
+	DataInstances const* m_pInstances;
+	UInt32 m_uBegin;
+	UInt32 m_uEnd;
+	UInt32 m_uFrames;
+	Float32 m_fDeltaTimeInSeconds;
+	BenchmarkPhase m_Evaluate;
+	BenchmarkPhase m_ApplyCache;
+	BenchmarkPhase m_Pose;
+}; // struct Worker
+typedef Vector<Worker, MemoryBudgets::Animation2D> Workers;
+
+/**
+ * Advance all instances of r for all frames. Each phase is run over
+ * the entire subset before the next, so that a sample measures the
+ * phase and not the cache effects of interleaving.
+ */
+void RunFrames(Worker& r)
+{
+	auto const& vClips = *r.m_pClips;
+	auto const& vInstances = *r.m_pInstances;
+
+	for (UInt32 uFrame = 0u; uFrame < r.m_uFrames; ++uFrame)
+	{
+		auto const fFrameTime = (Float)uFrame * r.m_fDeltaTimeInSeconds;
+
+		auto iStart = SeoulTime::GetGameTimeInTicks();
+		for (UInt32 i = r.m_uBegin; i < r.m_uEnd; ++i)
+		{
+			auto p = vClips[i];
+			if (!p.IsValid())
+			{
+				continue;
+			}
+
+			// Offset each instance, so instances do not sample in lockstep.
+			auto const fMaxTime = p->GetMaxTime();
+			auto fTime = fFrameTime + (Float)i * 0.013f;
+			if (fMaxTime > 0.0f)
+			{
+				fTime -= Floor(fTime / fMaxTime) * fMaxTime;
+			}
+			p->Evaluate(fTime, 1.0f, false);
+		}
+		auto iEnd = SeoulTime::GetGameTimeInTicks();
+		r.m_Evaluate.Add(iEnd - iStart);
+
+		iStart = iEnd;
+		for (UInt32 i = r.m_uBegin; i < r.m_uEnd; ++i)
+		{
+			vInstances[i]->ApplyCache();
+		}
+		iEnd = SeoulTime::GetGameTimeInTicks();
+		r.m_ApplyCache.Add(iEnd - iStart);
+
+		iStart = iEnd;
+		for (UInt32 i = r.m_uBegin; i < r.m_uEnd; ++i)
+		{
+			vInstances[i]->PoseSkinningPalette();
+		}
+		iEnd = SeoulTime::GetGameTimeInTicks();
+		r.m_Pose.Add(iEnd - iStart);
+	}
+}
+
+/** Job used to advance a Worker on a worker thread. */
+class WorkerJob SEOUL_SEALED : public Jobs::Job
+{
+public:
+	WorkerJob(Worker& r)
+		: m_r(r)
+	{
+	}
+
+	~WorkerJob()
+	{
+		WaitUntilJobIsNotRunning();
+	}
+
+private:
+	SEOUL_DISABLE_COPY(WorkerJob);
+	SEOUL_REFERENCE_COUNTED_SUBCLASS(WorkerJob);
+
+	Worker& m_r;
+
+	virtual void InternalExecuteJob(Jobs::State& reNextState, ThreadId& rNextThreadId) SEOUL_OVERRIDE
+	{
+		RunFrames(m_r);
+		reNextState = Jobs::State::kComplete;
+	}
+}; // class WorkerJob
+
+/** Generates the Spine JSON of a synthetic rig. */
+class RigWriter SEOUL_SEALED
+{
+public:
+	RigWriter(const BenchmarkRigSettings& settings)
+		: m_Settings(settings)
+		, m_uBones(Max(settings.m_uBones, 1u))
+		, m_uIk(settings.m_uBones >= 3u ? settings.m_uIk : 0u)
+		, m_uKeyFrames(Max(settings.m_uKeyFrames, 2u))
+		, m_uMeshVertices(Max(settings.m_uMeshVertices / 2u, 2u) * 2u)
+		, m_s()
+	{
+	}
+
+	const String& Write()
+	{
+		m_s.Clear();
+		m_s.Append("{\"skeleton\":{\"fps\":30,\"width\":256,\"height\":256}");
+		WriteBones();
+		WriteSlots();
+		WriteIk();
+		WritePaths();
+		WriteSkins();
+		WriteClips();
+		m_s.Append("}");
+		return m_s;
+	}
+
+private:
+	BenchmarkRigSettings const m_Settings;
+	UInt32 const m_uBones;
+	UInt32 const m_uIk;
+	UInt32 const m_uKeyFrames;
+	UInt32 const m_uMeshVertices;
+	String m_s;
+
+	// Bones form a binary tree, so chains are log2 deep.
+	static UInt32 GetParent(UInt32 uBone) { return (uBone - 1u) / 2u; }
+
+	// IK k constrains the (child, parent) pair ending at the last
+	// bones of the tree, with a dedicated target bone under the root.
+	UInt32 GetIkChild(UInt32 k) const { return Max(m_uBones - 1u - (k % (m_uBones - 2u)), 2u); }
+
+	// Path k constrains a single bone.
+	UInt32 GetPathBone(UInt32 k) const { return (m_uBones > 1u ? 1u + (k % (m_uBones - 1u)) : 0u); }
+
+	// Mesh k is bound to a bone and its parent.
+	UInt32 GetMeshBone(UInt32 k) const { return (m_uBones > 1u ? 1u + (k % (m_uBones - 1u)) : 0u); }
+
+	void AppendBoneName(UInt32 uBone)
+	{
+		if (0u == uBone)
+		{
+			m_s.Append("\"root\"");
+		}
+		else
+		{
+			m_s.Append(String::Printf("\"b%u\"", uBone));
+		}
+	}
+
+	void AppendComma(UInt32 i)
+	{
+		if (0u != i)
+		{
+			m_s.Append(",");
+		}
+	}
+
+	Float32 GetKeyTime(UInt32 j) const
+	{
+		return m_Settings.m_fClipDuration * (Float32)j / (Float32)(m_uKeyFrames - 1u);
+	}
+
+	void WriteBones()
+	{
+		m_s.Append(",\"bones\":[{\"name\":\"root\"}");
+		for (UInt32 i = 1u; i < m_uBones; ++i)
+		{
+			m_s.Append(String::Printf(",{\"name\":\"b%u\",\"parent\":", i));
+			AppendBoneName(GetParent(i));
+			m_s.Append(String::Printf(",\"length\":10,\"x\":10,\"rotation\":%u}", (i % 4u) * 15u));
+		}
+		for (UInt32 k = 0u; k < m_uIk; ++k)
+		{
+			m_s.Append(String::Printf(",{\"name\":\"ikt%u\",\"parent\":\"root\",\"x\":%u,\"y\":20}", k, 10u * k));
+		}
+		m_s.Append("]");
+	}
+
+	void WriteSlots()
+	{
+		m_s.Append(",\"slots\":[");
+		UInt32 uSlot = 0u;
+		for (UInt32 k = 0u; k < m_Settings.m_uMeshes; ++k)
+		{
+			AppendComma(uSlot++);
+			m_s.Append(String::Printf("{\"name\":\"mesh%u\",\"bone\":", k));
+			AppendBoneName(GetMeshBone(k));
+			m_s.Append(String::Printf(",\"attachment\":\"mesh%u\"}", k));
+		}
+		for (UInt32 k = 0u; k < m_Settings.m_uPaths; ++k)
+		{
+			AppendComma(uSlot++);
+			m_s.Append(String::Printf("{\"name\":\"path%u\",\"bone\":\"root\",\"attachment\":\"path%u\"}", k, k));
+		}
+		m_s.Append("]");
+	}
+
+	void WriteIk()
+	{
+		m_s.Append(",\"ik\":[");
+		for (UInt32 k = 0u; k < m_uIk; ++k)
+		{
+			auto const uChild = GetIkChild(k);
+			AppendComma(k);
+			m_s.Append(String::Printf("{\"name\":\"ik%u\",\"order\":%u,\"bones\":[", k, k));
+			AppendBoneName(GetParent(uChild));
+			m_s.Append(",");
+			AppendBoneName(uChild);
+			m_s.Append(String::Printf("],\"target\":\"ikt%u\"}", k));
+		}
+		m_s.Append("]");
+	}
+
+	void WritePaths()
+	{
+		m_s.Append(",\"path\":[");
+		for (UInt32 k = 0u; k < m_Settings.m_uPaths; ++k)
+		{
+			AppendComma(k);
+			m_s.Append(String::Printf("{\"name\":\"pathc%u\",\"order\":%u,\"bones\":[", k, m_uIk + k));
+			AppendBoneName(GetPathBone(k));
+			m_s.Append(String::Printf("],\"target\":\"path%u\",\"rotateMode\":\"chain\"}", k));
+		}
+		m_s.Append("]");
+	}
+
+	void WriteMesh(UInt32 k)
+	{
+		auto const uBone = GetMeshBone(k);
+		auto const uParent = (0u == uBone ? 0u : GetParent(uBone));
+		UInt32 const uColumns = (m_uMeshVertices / 2u);
+
+		// A 2 x uColumns strip.
+		m_s.Append(String::Printf("\"mesh%u\":{\"mesh%u\":{\"type\":\"mesh\",\"hull\":%u,\"uvs\":[", k, k, m_uMeshVertices));
+		for (UInt32 i = 0u; i < m_uMeshVertices; ++i)
+		{
+			AppendComma(i);
+			m_s.Append(String::Printf("%.4f,%u", (Float32)(i % uColumns) / (Float32)(uColumns - 1u), i / uColumns));
+		}
+		m_s.Append("],\"triangles\":[");
+		for (UInt32 c = 0u; c + 1u < uColumns; ++c)
+		{
+			AppendComma(c);
+			m_s.Append(String::Printf("%u,%u,%u,%u,%u,%u",
+				c, c + 1u, uColumns + c,
+				c + 1u, uColumns + c + 1u, uColumns + c));
+		}
+		m_s.Append("],\"vertices\":[");
+		for (UInt32 i = 0u; i < m_uMeshVertices; ++i)
+		{
+			auto const uX = 4u * (i % uColumns);
+			auto const uY = 4u * (i / uColumns);
+			AppendComma(i);
+			m_s.Append(String::Printf("2,%u,%u,%u,0.5,%u,%u,%u,0.5", uBone, uX, uY, uParent, uX + 10u, uY));
+		}
+		m_s.Append("]}}");
+	}
+
+	void WriteSkins()
+	{
+		m_s.Append(",\"skins\":[{\"name\":\"default\",\"attachments\":{");
+		UInt32 uSlot = 0u;
+		for (UInt32 k = 0u; k < m_Settings.m_uMeshes; ++k)
+		{
+			AppendComma(uSlot++);
+			WriteMesh(k);
+		}
+		for (UInt32 k = 0u; k < m_Settings.m_uPaths; ++k)
+		{
+			AppendComma(uSlot++);
+			m_s.Append(String::Printf(
+				"\"path%u\":{\"path%u\":{\"type\":\"path\",\"constantSpeed\":true,\"vertexCount\":6,"
+				"\"vertices\":[0,0,10,10,20,0,30,-10,40,0,50,10],\"lengths\":[40,80]}}", k, k));
+		}
+		m_s.Append("}}]");
+	}
+
+	void WriteClip(UInt32 uClip)
+	{
+		m_s.Append(String::Printf("\"clip%u\":{\"bones\":{", uClip));
+		for (UInt32 i = 0u; i < m_uBones; ++i)
+		{
+			AppendComma(i);
+			AppendBoneName(i);
+			m_s.Append(":{\"rotate\":[");
+			for (UInt32 j = 0u; j < m_uKeyFrames; ++j)
+			{
+				AppendComma(j);
+				m_s.Append(String::Printf("{\"time\":%.4f,\"angle\":%u}", GetKeyTime(j), ((i + j + uClip) % 7u) * 5u));
+			}
+			m_s.Append("],\"translate\":[");
+			for (UInt32 j = 0u; j < m_uKeyFrames; ++j)
+			{
+				AppendComma(j);
+				m_s.Append(String::Printf("{\"time\":%.4f,\"x\":%u,\"y\":%u}", GetKeyTime(j), (i + j) % 3u, (j + uClip) % 3u));
+			}
+			m_s.Append("]}");
+		}
+		m_s.Append("},\"ik\":{");
+		for (UInt32 k = 0u; k < m_uIk; ++k)
+		{
+			AppendComma(k);
+			m_s.Append(String::Printf("\"ik%u\":[{\"time\":0,\"mix\":1},{\"time\":%.4f,\"mix\":0.5}]", k, m_Settings.m_fClipDuration));
+		}
+		m_s.Append("},\"paths\":{");
+		for (UInt32 k = 0u; k < m_Settings.m_uPaths; ++k)
+		{
+			AppendComma(k);
+			m_s.Append(String::Printf("\"pathc%u\":{\"position\":[{\"time\":0,\"position\":0},{\"time\":%.4f,\"position\":1}]}", k, m_Settings.m_fClipDuration));
+		}
+		m_s.Append("},\"deform\":{\"default\":{");
+		UInt32 const uDeforms = Min(m_Settings.m_uDeforms, m_Settings.m_uMeshes);
+		for (UInt32 k = 0u; k < uDeforms; ++k)
+		{
+			AppendComma(k);
+			m_s.Append(String::Printf("\"mesh%u\":{\"mesh%u\":[{\"time\":0},{\"time\":%.4f,\"offset\":0,\"vertices\":[", k, k, m_Settings.m_fClipDuration));
+
+			// Offsets of both bone local positions of each vertex.
+			UInt32 const uFloats = 4u * m_uMeshVertices;
+			for (UInt32 i = 0u; i < uFloats; ++i)
+			{
+				AppendComma(i);
+				m_s.Append((0u == (i % 2u)) ? "1" : "-1");
+			}
+			m_s.Append("]}]}");
+		}
+		m_s.Append("}}}");
+	}
+
+	void WriteClips()
+	{
+		m_s.Append(",\"animations\":{");
+		for (UInt32 c = 0u; c < m_Settings.m_uClips; ++c)
+		{
+			AppendComma(c);
+			WriteClip(c);
+		}
+		m_s.Append("}");
+	}
+
+	SEOUL_DISABLE_COPY(RigWriter);
+}; // class RigWriter
+
+/** @return Milliseconds of iTicks, for reporting. */
+inline Double ToMilliseconds(Int64 iTicks)
+{
+	return SeoulTime::ConvertTicksToMilliseconds(iTicks);
+}
+
+} // namespace anonymous
+
+/**
+ * Generate, deserialize and save a rig with the complexity of settings.
+ * This is the same path used by the cooker, so the result is identical
+ * in form to cooked content.
+ */
+Bool CookSyntheticRig(const BenchmarkRigSettings& settings, StreamBuffer& rBuffer)
+{
+	RigWriter writer(settings);
+
+	DataStore dataStore;
+	if (!DataStoreParser::FromString(writer.Write(), dataStore))
+	{
+		SEOUL_WARN("Animation2D benchmark: failed parsing synthetic rig JSON.");
+		return false;
+	}
+
+	SharedPtr<DataDefinition> pData(SEOUL_NEW(MemoryBudgets::Animation2D) DataDefinition(FilePath()));
+	if (!Reflection::DeserializeObject(FilePath(), dataStore, dataStore.GetRootNode(), pData.GetPtr()))
+	{
+		SEOUL_WARN("Animation2D benchmark: failed deserializing synthetic rig.");
+		return false;
+	}
+
+	if (!DataDefinition::Cook(pData))
+	{
+		SEOUL_WARN("Animation2D benchmark: failed cooking synthetic rig.");
+		return false;
+	}
+
+	StreamBuffer buffer;
+	ReadWriteUtil util(buffer, keCurrentPlatform);
+	if (!pData->Save(util) || !util.EndWrite())
+	{
+		SEOUL_WARN("Animation2D benchmark: failed saving synthetic rig.");
+		return false;
+	}
+
+	rBuffer.Swap(buffer);
+	rBuffer.SeekToOffset(0u);
+	return true;
+}
+
+/** Read, deobfuscate and decompress the cooked rig at filePath (see DataContentLoader). */
+Bool ReadCookedRig(FilePath filePath, StreamBuffer& rBuffer)
+{
+	void* pRawData = nullptr;
+	UInt32 uRawData = 0u;
+	if (!FileManager::Get()->ReadAll(
+		filePath,
+		pRawData,
+		uRawData,
+		kLZ4MinimumAlignment,
+		MemoryBudgets::Content,
+		kDefaultMaxReadSize))
+	{
+		return false;
+	}
+
+	Obfuscate((Byte*)pRawData, uRawData, filePath);
+
+	void* pData = nullptr;
+	UInt32 uData = 0u;
+	Bool const bReturn = ZSTDDecompress(
+		pRawData,
+		uRawData,
+		pData,
+		uData,
+		MemoryBudgets::Content);
+	MemoryManager::Deallocate(pRawData);
+
+	if (!bReturn)
+	{
+		return false;
+	}
+
+	StreamBuffer buffer;
+	buffer.TakeOwnership((Byte*)pData, uData);
+	rBuffer.Swap(buffer);
+	rBuffer.SeekToOffset(0u);
+	return true;
+}
+
+void Run(
+	const String& sRig,
+	const StreamBuffer& buffer,
+	const BenchmarkSettings& settings,
+	BenchmarkResult& rResult)
+{
+	rResult = BenchmarkResult();
+	rResult.m_sRig = sRig;
+	rResult.m_Settings = settings;
+	auto& aPhases = rResult.m_aPhases;
+
+	// Load - each iteration reads from a fresh copy of the binary data.
+	SharedPtr<DataDefinition> pData;
+	UInt32 const uLoads = Max(settings.m_uLoads, 1u);
+	for (UInt32 i = 0u; i < uLoads; ++i)
+	{
+		StreamBuffer copy;
+		copy.Write(buffer.GetBuffer(), buffer.GetTotalDataSizeInBytes());
+		copy.SeekToOffset(0u);
+
+		SharedPtr<DataDefinition> p(SEOUL_NEW(MemoryBudgets::Animation2D) DataDefinition(FilePath()));
+		auto const iStart = SeoulTime::GetGameTimeInTicks();
+		ReadWriteUtil util(copy, keCurrentPlatform);
+		Bool const bLoaded = util.BeginRead() && p->Load(util);
+		aPhases[(UInt32)BenchmarkPhaseType::kDefinitionLoad].Add(SeoulTime::GetGameTimeInTicks() - iStart);
+
+		if (!bLoaded)
+		{
+			SEOUL_WARN("Animation2D benchmark: failed loading rig '%s'.", sRig.CStr());
+			return;
+		}
+
+		pData.Swap(p);
+	}
+	DataDefinition::ComputeSetupPose(pData);
+
+	// Clips are decompressed on first access, GetClips() is empty
+	// after Load().
+	Vector<SharedPtr<Clip>, MemoryBudgets::Animation2D> vClips;
+	{
+		DataDefinition::ClipIds vIds;
+		pData->GetClipIds(vIds);
+		for (auto const& id : vIds)
+		{
+			auto pClip(pData->GetClip(id));
+			if (pClip.IsValid())
+			{
+				vClips.PushBack(pClip);
+			}
+		}
+	}
+
+	UInt32 const uInstances = settings.m_uInstances;
+	DataInstances vInstances;
+	ClipInstances vClipInstances;
+	vInstances.Reserve(uInstances);
+	vClipInstances.Reserve(uInstances);
+
+	// Construction.
+	SharedPtr<DataDefinition const> pConstData(pData.GetPtr());
+	for (UInt32 i = 0u; i < uInstances; ++i)
+	{
+		auto const iStart = SeoulTime::GetGameTimeInTicks();
+		CheckedPtr<DataInstance> p(SEOUL_NEW(MemoryBudgets::Animation2D) DataInstance(pConstData, SharedPtr<Animation::EventInterface>()));
+		aPhases[(UInt32)BenchmarkPhaseType::kInstanceConstruct].Add(SeoulTime::GetGameTimeInTicks() - iStart);
+		vInstances.PushBack(p);
+	}
+
+	// Clone - clones are discarded, only the timing is of interest.
+	for (auto const& p : vInstances)
+	{
+		auto const iStart = SeoulTime::GetGameTimeInTicks();
+		CheckedPtr<DataInstance> pClone(p->Clone());
+		aPhases[(UInt32)BenchmarkPhaseType::kInstanceClone].Add(SeoulTime::GetGameTimeInTicks() - iStart);
+		SafeDelete(pClone);
+	}
+
+	// Each instance plays a single clip, assigned round robin.
+	for (UInt32 i = 0u; i < uInstances; ++i)
+	{
+		CheckedPtr<ClipInstance> p;
+		if (!vClips.IsEmpty())
+		{
+			auto const iStart = SeoulTime::GetGameTimeInTicks();
+			p = SEOUL_NEW(MemoryBudgets::Animation2D) ClipInstance(*vInstances[i], vClips[i % vClips.GetSize()], Animation::ClipSettings());
+			aPhases[(UInt32)BenchmarkPhaseType::kClipInstanceConstruct].Add(SeoulTime::GetGameTimeInTicks() - iStart);
+		}
+		vClipInstances.PushBack(p);
+	}
+
+	// Per-frame phases, split evenly across threads.
+	UInt32 const uThreads = Max(Min(settings.m_uThreads, Max(uInstances, 1u)), 1u);
+	Workers vWorkers;
+	vWorkers.Resize(uThreads);
+	for (UInt32 i = 0u; i < uThreads; ++i)
+	{
+		auto& r = vWorkers[i];
+		r.m_pClips = &vClipInstances;
+		r.m_pInstances = &vInstances;
+		r.m_uBegin = (uInstances * i) / uThreads;
+		r.m_uEnd = (uInstances * (i + 1u)) / uThreads;
+		r.m_uFrames = settings.m_uFrames;
+		r.m_fDeltaTimeInSeconds = settings.m_fDeltaTimeInSeconds;
+	}
+
+	auto const iStart = SeoulTime::GetGameTimeInTicks();
+	if (1u == uThreads)
+	{
+		RunFrames(vWorkers[0]);
+	}
+	else
+	{
+		Vector<SharedPtr<Jobs::Job>, MemoryBudgets::Animation2D> vJobs;
+		for (auto& r : vWorkers)
+		{
+			SharedPtr<Jobs::Job> pJob(SEOUL_NEW(MemoryBudgets::Animation2D) WorkerJob(r));
+			pJob->StartJob();
+			vJobs.PushBack(pJob);
+		}
+		for (auto const& pJob : vJobs)
+		{
+			pJob->WaitUntilJobIsNotRunning();
+		}
+	}
+	rResult.m_iFrameWallTicks = (SeoulTime::GetGameTimeInTicks() - iStart);
+
+	for (auto const& r : vWorkers)
+	{
+		aPhases[(UInt32)BenchmarkPhaseType::kEvaluate].Merge(r.m_Evaluate);
+		aPhases[(UInt32)BenchmarkPhaseType::kApplyCache].Merge(r.m_ApplyCache);
+		aPhases[(UInt32)BenchmarkPhaseType::kPoseSkinningPalette].Merge(r.m_Pose);
+	}
+
+	// Clip instances reference their DataInstance, release them first.
+	SafeDeleteVector(vClipInstances);
+	SafeDeleteVector(vInstances);
+
+	rResult.m_bSuccess = true;
+}
+
+void RunScaling(
+	const String& sRig,
+	const StreamBuffer& buffer,
+	const BenchmarkSettings& settings,
+	const Counts& vInstances,
+	const Counts& vThreads,
+	Results& rvResults)
+{
+	rvResults.Clear();
+	rvResults.Reserve(vInstances.GetSize() * vThreads.GetSize());
+	for (auto const uInstances : vInstances)
+	{
+		for (auto const uThreads : vThreads)
+		{
+			auto s = settings;
+			s.m_uInstances = uInstances;
+			s.m_uThreads = uThreads;
+
+			rvResults.PushBack(BenchmarkResult());
+			Run(sRig, buffer, s, rvResults.Back());
+		}
+	}
+}
+
+/**
+ * Times are reported in milliseconds (totals) and microseconds
+ * (per call). Rig labels are emitted as is and are expected
+ * to not require escaping (e.g. file paths or generated names).
+ */
+String ToJson(const Results& vResults)
+{
+	String s;
+	s.Append("{\"results\":[");
+	for (UInt32 i = 0u; i < vResults.GetSize(); ++i)
+	{
+		auto const& r = vResults[i];
+		if (0u != i)
+		{
+			s.Append(",");
+		}
+
+		s.Append(String::Printf(
+			"{\"rig\":\"%s\",\"success\":%s,\"instances\":%u,\"threads\":%u,\"frames\":%u,\"frameWallMs\":%.4f,\"phases\":{",
+			r.m_sRig.CStr(),
+			(r.m_bSuccess ? "true" : "false"),
+			r.m_Settings.m_uInstances,
+			r.m_Settings.m_uThreads,
+			r.m_Settings.m_uFrames,
+			ToMilliseconds(r.m_iFrameWallTicks)));
+		for (UInt32 j = 0u; j < (UInt32)BenchmarkPhaseType::COUNT; ++j)
+		{
+			auto const& phase = r.m_aPhases[j];
+			auto const fTotalMs = ToMilliseconds(phase.m_iTotalTicks);
+			s.Append(String::Printf(
+				"%s\"%s\":{\"calls\":%u,\"totalMs\":%.4f,\"meanUs\":%.4f,\"minUs\":%.4f,\"maxUs\":%.4f}",
+				(0u == j ? "" : ","),
+				phase.m_sName,
+				phase.m_uCalls,
+				fTotalMs,
+				(0u == phase.m_uCalls ? 0.0 : (fTotalMs * 1000.0) / (Double)phase.m_uCalls),
+				ToMilliseconds(phase.m_iMinTicks) * 1000.0,
+				ToMilliseconds(phase.m_iMaxTicks) * 1000.0));
+		}
+		s.Append("}}");
+	}
+	s.Append("]}");
+	return s;
+}
+
+} // namespace Benchmark
+
+} // namespace Seoul::Animation2D
+
+#endif // /#if SEOUL_WITH_ANIMATION_2D && !SEOUL_SHIP
@@ -0,0 +1,186 @@
+/**
+ * \file Animation2DBenchmark.h
+ * \brief Developer only benchmark of the Animation2D runtime. Times
+ * each phase of the runtime (definition load, instance construction,
+ * clip evaluation, cache application and posing) against cooked rigs
+ * or against synthetic rigs of configurable complexity, and reports
+ * results in a machine readable (JSON) format.
+ *
+ * Copyright (c) 2016-2022 Demiurge Studios Inc. All rights reserved.
+ */
+
+#pragma once
+#ifndef ANIMATION2D_BENCHMARK_H
+#define ANIMATION2D_BENCHMARK_H
+
+#include "FilePath.h"
+#include "Prereqs.h"
+#include "SeoulMath.h"
+#include "SeoulString.h"
+#include "StreamBuffer.h"
+#include "Vector.h"
+
+#if SEOUL_WITH_ANIMATION_2D && !SEOUL_SHIP
+
+namespace Seoul::Animation2D
+{
+
+/** Complexity of a generated rig. */
+struct BenchmarkRigSettings SEOUL_SEALED
+{
+	BenchmarkRigSettings()
+		: m_uBones(64u)
+		, m_uIk(4u)
+		, m_uPaths(1u)
+		, m_uMeshes(4u)
+		, m_uMeshVertices(64u)
+		, m_uDeforms(2u)
+		, m_uClips(4u)
+		, m_uKeyFrames(8u)
+		, m_fClipDuration(1.0f)
+	{
+	}
+
+	// Bones, including the root.
+	UInt32 m_uBones;
+	// 2-bone IK constraints.
+	UInt32 m_uIk;
+	// Path constraints, each with its own path slot.
+	UInt32 m_uPaths;
+	// Weighted mesh slots (2 bones per vertex).
+	UInt32 m_uMeshes;
+	UInt32 m_uMeshVertices;
+	// Meshes (of m_uMeshes) with deform timelines in every clip.
+	UInt32 m_uDeforms;
+	UInt32 m_uClips;
+	// Key frames per timeline.
+	UInt32 m_uKeyFrames;
+	Float32 m_fClipDuration;
+}; // struct BenchmarkRigSettings
+
+/** Workload of a single benchmark run. */
+struct BenchmarkSettings SEOUL_SEALED
+{
+	BenchmarkSettings()
+		: m_uInstances(100u)
+		, m_uThreads(1u)
+		, m_uFrames(120u)
+		, m_uLoads(10u)
+		, m_fDeltaTimeInSeconds(1.0f / 60.0f)
+	{
+	}
+
+	UInt32 m_uInstances;
+	// Number of jobs the per-frame phases are split across.
+	UInt32 m_uThreads;
+	UInt32 m_uFrames;
+	// Number of times the definition is loaded for the load phase.
+	UInt32 m_uLoads;
+	Float32 m_fDeltaTimeInSeconds;
+}; // struct BenchmarkSettings
+
+/** Timing of one phase. Times of parallel phases are summed across threads. */
+struct BenchmarkPhase SEOUL_SEALED
+{
+	BenchmarkPhase(Byte const* sName = "")
+		: m_sName(sName)
+		, m_uCalls(0u)
+		, m_iTotalTicks(0)
+		, m_iMinTicks(0)
+		, m_iMaxTicks(0)
+	{
+	}
+
+	void Add(Int64 iTicks)
+	{
+		m_iMinTicks = (0u == m_uCalls ? iTicks : Min(m_iMinTicks, iTicks));
+		m_iMaxTicks = (0u == m_uCalls ? iTicks : Max(m_iMaxTicks, iTicks));
+		m_iTotalTicks += iTicks;
+		++m_uCalls;
+	}
+
+	void Merge(const BenchmarkPhase& b)
+	{
+		if (0u == b.m_uCalls)
+		{
+			return;
+		}
+
+		m_iMinTicks = (0u == m_uCalls ? b.m_iMinTicks : Min(m_iMinTicks, b.m_iMinTicks));
+		m_iMaxTicks = (0u == m_uCalls ? b.m_iMaxTicks : Max(m_iMaxTicks, b.m_iMaxTicks));
+		m_iTotalTicks += b.m_iTotalTicks;
+		m_uCalls += b.m_uCalls;
+	}
+
+	Byte const* m_sName;
+	UInt32 m_uCalls;
+	Int64 m_iTotalTicks;
+	Int64 m_iMinTicks;
+	Int64 m_iMaxTicks;
+}; // struct BenchmarkPhase
+
+/** Phases timed by Benchmark::Run(). */
+enum class BenchmarkPhaseType
+{
+	kDefinitionLoad,
+	kInstanceConstruct,
+	kInstanceClone,
+	kClipInstanceConstruct,
+	kEvaluate,
+	kApplyCache,
+	kPoseSkinningPalette,
+	COUNT,
+};
+
+struct BenchmarkResult SEOUL_SEALED
+{
+	BenchmarkResult();
+
+	String m_sRig;
+	BenchmarkSettings m_Settings;
+	BenchmarkPhase m_aPhases[(UInt32)BenchmarkPhaseType::COUNT];
+	// Wall time of the per-frame phases, all threads.
+	Int64 m_iFrameWallTicks;
+	Bool m_bSuccess;
+}; // struct BenchmarkResult
+
+namespace Benchmark
+{
+
+typedef Vector<BenchmarkResult, MemoryBudgets::Animation2D> Results;
+typedef Vector<UInt32, MemoryBudgets::Animation2D> Counts;
+
+// Populate rBuffer with the binary (ReadWriteUtil) form of a
+// generated rig. Returns false on cook failure.
+Bool CookSyntheticRig(const BenchmarkRigSettings& settings, StreamBuffer& rBuffer);
+
+// Populate rBuffer with the binary form of the cooked rig at filePath.
+Bool ReadCookedRig(FilePath filePath, StreamBuffer& rBuffer);
+
+// Time all phases of the rig in buffer (see CookSyntheticRig() and
+// ReadCookedRig()) under settings. sRig is used to label the result.
+void Run(
+	const String& sRig,
+	const StreamBuffer& buffer,
+	const BenchmarkSettings& settings,
+	BenchmarkResult& rResult);
+
+// Run() once for each pair of instance and thread counts.
+void RunScaling(
+	const String& sRig,
+	const StreamBuffer& buffer,
+	const BenchmarkSettings& settings,
+	const Counts& vInstances,
+	const Counts& vThreads,
+	Results& rvResults);
+
+// Machine readable form of results.
+String ToJson(const Results& vResults);
+
+} // namespace Benchmark
+
+} // namespace Seoul::Animation2D
+
+#endif // /#if SEOUL_WITH_ANIMATION_2D && !SEOUL_SHIP
+
+#endif // include guard
@@ -11,18 +11,277 @@
 #ifndef ANIMATION2D_CACHE_H
 #define ANIMATION2D_CACHE_H
 
-#include "HashSet.h"
-#include "HashTable.h"
+#include "Animation2DMemoryUsage.h"
+#include "FixedArray.h"
 #include "Vector.h"
 #include "Vector2D.h"
 #include "Vector3D.h"
 #include "Vector4D.h"
+namespace Seoul { namespace Animation2D { class Clip; } }
 
 #if SEOUL_WITH_ANIMATION_2D
 
 namespace Seoul::Animation2D
 {
 
+typedef Vector<UInt32, MemoryBudgets::Animation2D> CacheStamps;
+
+/**
+ * Dense accumulator of a single channel of animation data. One entry
+ * exists per target (bone, slot, constraint). An entry is only
+ * considered set when its stamp matches the current generation of
+ * the owning Cache, which makes clearing a channel O(1).
+ */
+template <typename T>
+class CacheChannel SEOUL_SEALED
+{
+public:
+	typedef Vector<T, MemoryBudgets::Animation2D> Values;
+
+	CacheChannel()
+		: m_vValues()
+		, m_vStamps()
+	{
+	}
+
+	void Accum(UInt32 uGeneration, Int16 i, const T& v)
+	{
+		auto& ru = m_vStamps[i];
+		if (ru == uGeneration)
+		{
+			m_vValues[i] += v;
+		}
+		else
+		{
+			ru = uGeneration;
+			m_vValues[i] = v;
+		}
+	}
+
+	T const* Find(UInt32 uGeneration, Int16 i) const
+	{
+		return (m_vStamps[i] == uGeneration ? m_vValues.Get((UInt32)i) : nullptr);
+	}
+
+	UInt32 GetHeapSize() const { return Animation2D::GetHeapSize(m_vValues) + Animation2D::GetHeapSize(m_vStamps); }
+	UInt32 GetSize() const { return m_vValues.GetSize(); }
+
+	void Initialize(UInt32 uSize)
+	{
+		m_vValues.Resize(uSize);
+		m_vStamps.Resize(uSize);
+		ResetStamps();
+	}
+
+	void ResetStamps()
+	{
+		if (!m_vStamps.IsEmpty())
+		{
+			memset(m_vStamps.Data(), 0, m_vStamps.GetSizeInBytes());
+		}
+	}
+
+private:
+	Values m_vValues;
+	CacheStamps m_vStamps;
+
+	SEOUL_DISABLE_COPY(CacheChannel);
+}; // class CacheChannel
+
+/**
+ * Identifies the clip samples accumulated into a Cache during a frame.
+ * Only recorded for instances with shared posing enabled (see
+ * DataInstance::SetPoseShared()). Two instances of the same definition
+ * with equal signatures compute identical poses.
+ */
+struct CacheSignature SEOUL_SEALED
+{
+	static const UInt32 kuMaxSamples = 4u;
+
+	struct Sample SEOUL_SEALED
+	{
+		Sample()
+			: m_pClip(nullptr)
+			, m_uFrame(0u)
+			, m_uAlpha(0u)
+		{
+		}
+
+		Bool operator==(const Sample& b) const
+		{
+			return (
+				m_pClip == b.m_pClip &&
+				m_uFrame == b.m_uFrame &&
+				m_uAlpha == b.m_uAlpha);
+		}
+
+		Clip const* m_pClip;
+		UInt32 m_uFrame;
+		UInt32 m_uAlpha;
+	}; // struct Sample
+
+	CacheSignature()
+		: m_aSamples()
+		, m_uSamples(0u)
+		, m_bValid(true)
+	{
+	}
+
+	void Add(Clip const* pClip, UInt32 uFrame, UInt32 uAlpha)
+	{
+		// Too many samples to share, treat as unique.
+		if (m_uSamples >= kuMaxSamples)
+		{
+			m_bValid = false;
+			return;
+		}
+
+		auto& r = m_aSamples[m_uSamples++];
+		r.m_pClip = pClip;
+		r.m_uFrame = uFrame;
+		r.m_uAlpha = uAlpha;
+	}
+
+	UInt32 GetHash() const
+	{
+		UInt32 uReturn = 0u;
+		for (UInt32 i = 0u; i < m_uSamples; ++i)
+		{
+			auto const& r = m_aSamples[i];
+			IncrementalHash(uReturn, (UInt32)(size_t)r.m_pClip);
+			IncrementalHash(uReturn, r.m_uFrame);
+			IncrementalHash(uReturn, r.m_uAlpha);
+		}
+		return uReturn;
+	}
+
+	// Mark the accumulated state as not reproducible from the samples alone.
+	void Invalidate() { m_bValid = false; }
+
+	Bool IsValid() const { return m_bValid && m_uSamples > 0u; }
+
+	void Reset()
+	{
+		m_uSamples = 0u;
+		m_bValid = true;
+	}
+
+	Bool operator==(const CacheSignature& b) const
+	{
+		if (m_uSamples != b.m_uSamples || m_bValid != b.m_bValid)
+		{
+			return false;
+		}
+
+		for (UInt32 i = 0u; i < m_uSamples; ++i)
+		{
+			if (!(m_aSamples[i] == b.m_aSamples[i]))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	FixedArray<Sample, kuMaxSamples> m_aSamples;
+	UInt32 m_uSamples;
+	Bool m_bValid;
+}; // struct CacheSignature
+
+/**
+ * Identifies the clip samples accumulated into a Cache during a frame
+ * when the output of each sampled clip is constant over a range of time
+ * (e.g. a non-looping clip clamped at its end, or stepped key frames).
+ * A sample is identified by the start of its constant range rather than
+ * by its time, so two frames with equal holds accumulate identical state.
+ */
+struct CacheHold SEOUL_SEALED
+{
+	static const UInt32 kuMaxSamples = 4u;
+
+	struct Sample SEOUL_SEALED
+	{
+		Sample()
+			: m_pClip(nullptr)
+			, m_fBegin(0.0f)
+			, m_fAlpha(0.0f)
+			, m_bBlendDiscreteState(false)
+		{
+		}
+
+		Bool operator==(const Sample& b) const
+		{
+			return (
+				m_pClip == b.m_pClip &&
+				m_fBegin == b.m_fBegin &&
+				m_fAlpha == b.m_fAlpha &&
+				m_bBlendDiscreteState == b.m_bBlendDiscreteState);
+		}
+
+		Clip const* m_pClip;
+		Float32 m_fBegin;
+		Float32 m_fAlpha;
+		Bool m_bBlendDiscreteState;
+	}; // struct Sample
+
+	CacheHold()
+		: m_aSamples()
+		, m_uSamples(0u)
+		, m_bValid(true)
+	{
+	}
+
+	void Add(Clip const* pClip, Float fBegin, Float fAlpha, Bool bBlendDiscreteState)
+	{
+		// Too many samples to track, treat as changing.
+		if (m_uSamples >= kuMaxSamples)
+		{
+			m_bValid = false;
+			return;
+		}
+
+		auto& r = m_aSamples[m_uSamples++];
+		r.m_pClip = pClip;
+		r.m_fBegin = fBegin;
+		r.m_fAlpha = fAlpha;
+		r.m_bBlendDiscreteState = bBlendDiscreteState;
+	}
+
+	// Mark the accumulated state as (potentially) changing over time.
+	void Invalidate() { m_bValid = false; }
+
+	Bool IsValid() const { return m_bValid && m_uSamples > 0u; }
+
+	void Reset()
+	{
+		m_uSamples = 0u;
+		m_bValid = true;
+	}
+
+	Bool operator==(const CacheHold& b) const
+	{
+		if (m_uSamples != b.m_uSamples || m_bValid != b.m_bValid)
+		{
+			return false;
+		}
+
+		for (UInt32 i = 0u; i < m_uSamples; ++i)
+		{
+			if (!(m_aSamples[i] == b.m_aSamples[i]))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	FixedArray<Sample, kuMaxSamples> m_aSamples;
+	UInt32 m_uSamples;
+	Bool m_bValid;
+}; // struct CacheHold
+
 struct Cache SEOUL_SEALED
 {
 	struct IkEntry SEOUL_SEALED
@@ -68,6 +327,12 @@ struct Cache SEOUL_SEALED
 
 	struct TwoColorEntry SEOUL_SEALED
 	{
+		TwoColorEntry()
+			: m_vLight()
+			, m_vDark()
+		{
+		}
+
 		TwoColorEntry(
 			Float fLightR,
 			Float fLightG,
@@ -93,98 +358,175 @@ struct Cache SEOUL_SEALED
 		Vector3D m_vDark;
 	};
 
-	typedef HashTable<Int64, IkEntry, MemoryBudgets::Animation2D> CacheIk;
-	typedef HashSet<Int16, MemoryBudgets::Animation2D> CacheSlot;
-	typedef HashTable<Int16, Float, MemoryBudgets::Animation2D> Cache1D;
-	typedef HashTable<Int16, Vector2D, MemoryBudgets::Animation2D> Cache2D;
-	typedef HashTable<Int16, Vector3D, MemoryBudgets::Animation2D> Cache3D;
-	typedef HashTable<Int16, Vector4D, MemoryBudgets::Animation2D> Cache4D;
+	typedef CacheChannel<IkEntry> CacheIk;
+	typedef CacheChannel<Float> Cache1D;
+	typedef CacheChannel<Vector2D> Cache2D;
+	typedef CacheChannel<Vector3D> Cache3D;
+	typedef CacheChannel<Vector4D> Cache4D;
 	typedef Vector<SlotAttachmentEntry, MemoryBudgets::Animation2D> CacheSlotAttachments;
-	typedef HashTable<Int64, TwoColorEntry, MemoryBudgets::Animation2D> CacheTwoColor;
+	typedef CacheChannel<TwoColorEntry> CacheTwoColor;
 	typedef Vector<Int16, MemoryBudgets::Animation2D> DrawOrder;
 
-	template <typename T, typename U>
-	static void AccumCommon(T& r, Int16 i, const U& v)
+	Cache(
+		UInt32 uBones,
+		UInt32 uIk,
+		UInt32 uPaths,
+		UInt32 uSlots,
+		UInt32 uTransforms)
+		: m_vAttachments()
+		, m_Color()
+		, m_TwoColor()
+		, m_vDrawOrder()
+		, m_Ik()
+		, m_PathMix()
+		, m_PathPosition()
+		, m_PathSpacing()
+		, m_Position()
+		, m_Rotation()
+		, m_Scale()
+		, m_Shear()
+		, m_Transform()
+		, m_vSlotScratch()
+		, m_vDrawOrderScratch()
+		, m_Signature()
+		, m_Hold()
+		, m_AppliedHold()
+		, m_uGeneration(1u)
+		, m_bDirty(false)
 	{
-		auto const e = r.Insert(i, v);
-		if (!e.Second)
-		{
-			e.First->Second += v;
-		}
+		m_Color.Initialize(uSlots);
+		m_TwoColor.Initialize(uSlots);
+		m_Ik.Initialize(uIk);
+		m_PathMix.Initialize(uPaths);
+		m_PathPosition.Initialize(uPaths);
+		m_PathSpacing.Initialize(uPaths);
+		m_Position.Initialize(uBones);
+		m_Rotation.Initialize(uBones);
+		m_Scale.Initialize(uBones);
+		m_Shear.Initialize(uBones);
+		m_Transform.Initialize(uTransforms);
+		m_vSlotScratch.Resize(uSlots, 0u);
 	}
 
-	void AccumIk(Int16 i, const IkEntry& e) { AccumCommon(m_tIk, i, e); }
-	void AccumPathMix(Int16 i, const Vector2D& v) { AccumCommon(m_tPathMix, i, v); }
-	void AccumPathPosition(Int16 i, Float f) { AccumCommon(m_tPathPosition, i, f); }
-	void AccumPathSpacing(Int16 i, Float f) { AccumCommon(m_tPathSpacing, i, f); }
-	void AccumPosition(Int16 i, const Vector2D& v) { AccumCommon(m_tPosition, i, v); }
-	void AccumRotation(Int16 i, Float f) { AccumCommon(m_tRotation, i, f); }
-	void AccumScale(Int16 i, const Vector2D& v, Float fAlpha) { AccumCommon(m_tScale, i, Vector3D(v, fAlpha)); }
-	void AccumShear(Int16 i, const Vector2D& v) { AccumCommon(m_tShear, i, v); }
+	void AccumIk(Int16 i, const IkEntry& e) { m_Ik.Accum(m_uGeneration, i, e); m_bDirty = true; }
+	void AccumPathMix(Int16 i, const Vector2D& v) { m_PathMix.Accum(m_uGeneration, i, v); m_bDirty = true; }
+	void AccumPathPosition(Int16 i, Float f) { m_PathPosition.Accum(m_uGeneration, i, f); m_bDirty = true; }
+	void AccumPathSpacing(Int16 i, Float f) { m_PathSpacing.Accum(m_uGeneration, i, f); m_bDirty = true; }
+	void AccumPosition(Int16 i, const Vector2D& v) { m_Position.Accum(m_uGeneration, i, v); m_bDirty = true; }
+	void AccumRotation(Int16 i, Float f) { m_Rotation.Accum(m_uGeneration, i, f); m_bDirty = true; }
+	void AccumScale(Int16 i, const Vector2D& v, Float fAlpha) { m_Scale.Accum(m_uGeneration, i, Vector3D(v, fAlpha)); m_bDirty = true; }
+	void AccumShear(Int16 i, const Vector2D& v) { m_Shear.Accum(m_uGeneration, i, v); m_bDirty = true; }
 
 	void AccumSlotAttachment(Int16 iSlot, HString attachmentId, Float fAlpha)
 	{
 		m_vAttachments.PushBack(SlotAttachmentEntry(iSlot, attachmentId, fAlpha));
 	}
 
-	void AccumSlotColor(Int16 i, const Vector4D& v) { AccumCommon(m_tColor, i, v); }
-	void AccumSlotTwoColor(Int16 i, const TwoColorEntry& e) { AccumCommon(m_tTwoColor, i, e); }
-	void AccumTransform(Int16 i, const Vector4D& v) { AccumCommon(m_tTransform, i, v); }
+	void AccumSlotColor(Int16 i, const Vector4D& v) { m_Color.Accum(m_uGeneration, i, v); m_bDirty = true; }
+	void AccumSlotTwoColor(Int16 i, const TwoColorEntry& e) { m_TwoColor.Accum(m_uGeneration, i, e); m_bDirty = true; }
+	void AccumTransform(Int16 i, const Vector4D& v) { m_Transform.Accum(m_uGeneration, i, v); m_bDirty = true; }
 
+	/**
+	 * Invalidate all accumulated state. O(1) for the dense
+	 * channels, since only the generation is advanced -
+	 * stamps are only reset when the generation wraps.
+	 */
 	void Clear()
 	{
 		m_vAttachments.Clear();
-		m_tColor.Clear();
-		m_tTwoColor.Clear();
 		m_vDrawOrder.Clear();
-		m_tIk.Clear();
-		m_tPathMix.Clear();
-		m_tPathPosition.Clear();
-		m_tPathSpacing.Clear();
-		m_tPosition.Clear();
-		m_tRotation.Clear();
-		m_tScale.Clear();
-		m_tShear.Clear();
-		m_tTransform.Clear();
+		m_Signature.Reset();
+		m_Hold.Reset();
+
+		++m_uGeneration;
+		if (0u == m_uGeneration)
+		{
+			m_Color.ResetStamps();
+			m_TwoColor.ResetStamps();
+			m_Ik.ResetStamps();
+			m_PathMix.ResetStamps();
+			m_PathPosition.ResetStamps();
+			m_PathSpacing.ResetStamps();
+			m_Position.ResetStamps();
+			m_Rotation.ResetStamps();
+			m_Scale.ResetStamps();
+			m_Shear.ResetStamps();
+			m_Transform.ResetStamps();
+			if (!m_vSlotScratch.IsEmpty())
+			{
+				memset(m_vSlotScratch.Data(), 0, m_vSlotScratch.GetSizeInBytes());
+			}
 
-		m_SlotScratch.Clear();
+			m_uGeneration = 1u;
+		}
+
+		m_bDirty = false;
 	}
 
+	/** @return The total memory footprint of this cache, in bytes. */
+	UInt32 GetMemoryUsage() const
+	{
+		return
+			(UInt32)sizeof(*this) +
+			Animation2D::GetHeapSize(m_vAttachments) +
+			m_Color.GetHeapSize() +
+			m_TwoColor.GetHeapSize() +
+			Animation2D::GetHeapSize(m_vDrawOrder) +
+			m_Ik.GetHeapSize() +
+			m_PathMix.GetHeapSize() +
+			m_PathPosition.GetHeapSize() +
+			m_PathSpacing.GetHeapSize() +
+			m_Position.GetHeapSize() +
+			m_Rotation.GetHeapSize() +
+			m_Scale.GetHeapSize() +
+			m_Shear.GetHeapSize() +
+			m_Transform.GetHeapSize() +
+			Animation2D::GetHeapSize(m_vSlotScratch) +
+			Animation2D::GetHeapSize(m_vDrawOrderScratch);
+	}
+
+	/** @return The stamp of entries set since the last call to Clear(). */
+	UInt32 GetGeneration() const { return m_uGeneration; }
+
 	Bool IsDirty() const
 	{
 		return
+			m_bDirty ||
 			!m_vAttachments.IsEmpty() ||
-			!m_tColor.IsEmpty() ||
-			!m_tTwoColor.IsEmpty() ||
-			!m_vDrawOrder.IsEmpty() ||
-			!m_tIk.IsEmpty() ||
-			!m_tPathMix.IsEmpty() ||
-			!m_tPathPosition.IsEmpty() ||
-			!m_tPathSpacing.IsEmpty() ||
-			!m_tPosition.IsEmpty() ||
-			!m_tRotation.IsEmpty() ||
-			!m_tScale.IsEmpty() ||
-			!m_tShear.IsEmpty() ||
-			!m_tTransform.IsEmpty();
+			!m_vDrawOrder.IsEmpty();
 	}
 
 	CacheSlotAttachments m_vAttachments;
-	Cache4D m_tColor;
-	CacheTwoColor m_tTwoColor;
+	Cache4D m_Color;
+	CacheTwoColor m_TwoColor;
 	DrawOrder m_vDrawOrder;
-	CacheIk m_tIk;
-	Cache2D m_tPathMix;
-	Cache1D m_tPathPosition;
-	Cache1D m_tPathSpacing;
-	Cache2D m_tPosition;
-	Cache1D m_tRotation;
-	Cache3D m_tScale;
-	Cache2D m_tShear;
-	Cache4D m_tTransform;
+	CacheIk m_Ik;
+	Cache2D m_PathMix;
+	Cache1D m_PathPosition;
+	Cache1D m_PathSpacing;
+	Cache2D m_Position;
+	Cache1D m_Rotation;
+	Cache3D m_Scale;
+	Cache2D m_Shear;
+	Cache4D m_Transform;
 
 	// Part of processing, not public state.
-	CacheSlot m_SlotScratch;
+	CacheStamps m_vSlotScratch;
 	DrawOrder m_vDrawOrderScratch;
+
+	// Clip samples accumulated since the last call to Clear(), shared posing only.
+	CacheSignature m_Signature;
+
+	// Held clip samples accumulated since the last call to Clear(), and
+	// the holds of the state last applied (see DataInstance::ApplyCache()).
+	CacheHold m_Hold;
+	CacheHold m_AppliedHold;
+
+private:
+	UInt32 m_uGeneration;
+	Bool m_bDirty;
+
+	SEOUL_DISABLE_COPY(Cache);
 }; // struct Cache
 
 static inline void SetDefaultDrawOrder(UInt32 uSlots, Cache::DrawOrder& rv)
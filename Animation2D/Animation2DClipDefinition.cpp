@@ -9,7 +9,9 @@
  */
 
 #include "Animation2DClipDefinition.h"
+#include "Animation2DClipInstance.h"
 #include "Animation2DDataDefinition.h"
+#include "Animation2DMemoryUsage.h"
 #include "Animation2DReadWriteUtil.h"
 #include "Logger.h"
 #include "ReflectionCoreTemplateTypes.h"
@@ -425,11 +427,10 @@ Bool BaseKeyFrame::CustomDeserializeCurve(
 		}
 
 		auto pData = pContext->GetUserData().Cast<Animation2D::DataDefinition*>();
-		auto& v = pData->GetCurves();
-		m_uCurveDataOffset = (UInt32)v.GetSize();
+		BezierCurve curve;
+		PopulateCurve(aControlPoints, curve);
+		m_uCurveDataOffset = pData->AddCurve(curve);
 		m_uCurveType = (UInt32)CurveType::kBezier;
-		v.PushBack(BezierCurve());
-		PopulateCurve(aControlPoints, v.Back());
 		return true;
 	}
 	else
@@ -456,6 +457,15 @@ Bool BaseKeyFrame::CustomDeserializeCurve(
 }
 
 Clip::Clip()
+	: m_tBones()
+	, m_tDeforms()
+	, m_vDrawOrder()
+	, m_vEvents()
+	, m_tIk()
+	, m_tPaths()
+	, m_tSlots()
+	, m_tTransforms()
+	, m_pBinding(SEOUL_NEW(MemoryBudgets::Animation2D) ClipBinding)
 {
 }
 
@@ -477,6 +487,60 @@ Bool Clip::Load(ReadWriteUtil& r)
 	return bReturn;
 }
 
+/**
+ * Prebuild the ClipBinding of this clip against data. This is the
+ * only point at which the timeline names of the clip are resolved -
+ * instancing the clip copies the binding.
+ */
+void Clip::Bind(const DataDefinition& data)
+{
+	m_pBinding->Bind(data, *this);
+}
+
+/**
+ * @return The total memory footprint of this clip (keyframes and
+ * resolved binding), in bytes.
+ */
+UInt32 Clip::GetMemoryUsage() const
+{
+	// Deforms are nested by skin, slot, and attachment.
+	auto const deform = [](const KeyFrameDeform& e) { return GetHeapSize(e.m_vVertices); };
+	auto const deforms = [&](const KeyFramesDeform& v) { return GetHeapSize(v, deform); };
+	auto const deformAttachments = [&](const auto& t) { return GetHeapSize(t, deforms); };
+	auto const deformSlots = [&](const auto& t) { return GetHeapSize(t, deformAttachments); };
+
+	UInt32 uReturn = (UInt32)sizeof(*this);
+	uReturn += GetHeapSize(m_tBones, [](const BoneKeyFrames& e)
+	{
+		return
+			GetHeapSize(e.m_vRotation) +
+			GetHeapSize(e.m_vScale) +
+			GetHeapSize(e.m_vShear) +
+			GetHeapSize(e.m_vTranslation);
+	});
+	uReturn += GetHeapSize(m_tDeforms, deformSlots);
+	uReturn += GetHeapSize(m_vDrawOrder, [](const KeyFrameDrawOrder& e) { return GetHeapSize(e.m_vOffsets); });
+	uReturn += GetHeapSize(m_vEvents, [](const KeyFrameEvent& e) { return GetHeapSize(e.m_s); });
+	uReturn += GetHeapSize(m_tIk, [](const KeyFramesIk& v) { return GetHeapSize(v); });
+	uReturn += GetHeapSize(m_tPaths, [](const PathKeyFrames& e)
+	{
+		return
+			GetHeapSize(e.m_vMix) +
+			GetHeapSize(e.m_vPosition) +
+			GetHeapSize(e.m_vSpacing);
+	});
+	uReturn += GetHeapSize(m_tSlots, [](const SlotKeyFrames& e)
+	{
+		return
+			GetHeapSize(e.m_vAttachment) +
+			GetHeapSize(e.m_vColor) +
+			GetHeapSize(e.m_vTwoColor);
+	});
+	uReturn += GetHeapSize(m_tTransforms, [](const KeyFramesTransform& v) { return GetHeapSize(v); });
+	uReturn += (UInt32)sizeof(ClipBinding) + m_pBinding->GetHeapSize();
+	return uReturn;
+}
+
 Bool Clip::Save(ReadWriteUtil& r) const
 {
 	Bool bReturn = true;
@@ -16,12 +16,16 @@
 #include "HashTable.h"
 #include "Prereqs.h"
 #include "ReflectionDeclare.h"
+#include "ScopedPtr.h"
 #include "SeoulHString.h"
+#include "SeoulMath.h"
 #include "SharedPtr.h"
 #include "StandardVertex2D.h"
 #include "Vector.h"
 namespace Seoul { class DataNode; }
 namespace Seoul { class DataStore; }
+namespace Seoul { namespace Animation2D { struct ClipBinding; } }
+namespace Seoul { namespace Animation2D { class DataDefinition; } }
 namespace Seoul { namespace Animation2D { class DataInstance; } }
 namespace Seoul { namespace Animation2D { class ReadWriteUtil; } }
 namespace Seoul { namespace Reflection { struct SerializeContext; } }
@@ -543,6 +547,64 @@ static const UInt32 kuBezierCurvePoints = 18u;
 typedef FixedArray<Float, kuBezierCurvePoints> BezierCurve;
 typedef Vector<BezierCurve, MemoryBudgets::Animation2D> BezierCurves;
 
+/**
+ * @return The eased alpha of a at fLinearAlpha, by walking the
+ * piecewise linear segments of a.
+ */
+static inline Float32 GetBezierCurveAlpha(Float fLinearAlpha, const BezierCurve& a)
+{
+	Float fX = a[0];
+	if (fX >= fLinearAlpha)
+	{
+		return (a[1] * fLinearAlpha) / fX;
+	}
+
+	for (UInt32 i = 2u; i < a.GetSize(); i += 2u)
+	{
+		fX = a[i];
+		if (fX >= fLinearAlpha)
+		{
+			Float const fPrevX = a[i-2];
+			Float const fPrevY = a[i-1];
+			return fPrevY + (((a[i+1] - fPrevY) * (fLinearAlpha - fPrevX)) / (fX - fPrevX));
+		}
+	}
+
+	Float const fY = a.Back();
+	return fY + (((1.0f - fY) * (fLinearAlpha - fX)) / (1.0f - fX));
+}
+
+// When enabled, each BezierCurve is resampled at load into a
+// UniformCurve, and evaluation uses the table instead of walking
+// the curve segments. Selectable per build to allow fidelity
+// comparisons against the reference runtime.
+#ifndef SEOUL_ANIMATION2D_UNIFORM_CURVES
+#define SEOUL_ANIMATION2D_UNIFORM_CURVES 0
+#endif
+
+#if SEOUL_ANIMATION2D_UNIFORM_CURVES
+static const UInt32 kuUniformCurveSegments = 32u;
+typedef FixedArray<Float, kuUniformCurveSegments + 1u> UniformCurve;
+typedef Vector<UniformCurve, MemoryBudgets::Animation2D> UniformCurves;
+
+/** Resample a at even intervals of linear alpha into rOut. */
+static inline void ResampleCurve(const BezierCurve& a, UniformCurve& rOut)
+{
+	for (UInt32 i = 0u; i <= kuUniformCurveSegments; ++i)
+	{
+		rOut[i] = GetBezierCurveAlpha((Float)i / (Float)kuUniformCurveSegments, a);
+	}
+}
+
+/** @return The eased alpha of a at fLinearAlpha, which must be on [0, 1]. */
+static inline Float32 GetUniformCurveAlpha(Float fLinearAlpha, const UniformCurve& a)
+{
+	Float const f = fLinearAlpha * (Float)kuUniformCurveSegments;
+	UInt32 const u = Min((UInt32)f, kuUniformCurveSegments - 1u);
+	return Lerp(a[u], a[u + 1u], f - (Float)u);
+}
+#endif // /#if SEOUL_ANIMATION2D_UNIFORM_CURVES
+
 struct BoneKeyFrames SEOUL_SEALED
 {
 	BoneKeyFrames()
@@ -644,6 +706,17 @@ public:
 	Bool Load(ReadWriteUtil& r);
 	Bool Save(ReadWriteUtil& r) const;
 
+	// Resolve the timelines of this clip against data. Must be called
+	// once the owning DataDefinition is fully loaded, and before the
+	// clip is instanced.
+	void Bind(const DataDefinition& data);
+
+	// Runtime only - the timelines of this clip, resolved by Bind().
+	const ClipBinding& GetBinding() const { return *m_pBinding; }
+
+	// Total memory footprint of this clip, in bytes.
+	UInt32 GetMemoryUsage() const;
+
 	const Bones& GetBones() const { return m_tBones; }
 	const Deforms& GetDeforms() const { return m_tDeforms; }
 	const KeyFramesDrawOrder& GetDrawOrder() const { return m_vDrawOrder; }
@@ -667,6 +740,7 @@ private:
 	Paths m_tPaths;
 	Slots m_tSlots;
 	Transforms m_tTransforms;
+	ScopedPtr<ClipBinding> const m_pBinding;
 
 	static Bool CustomDeserializeType(
 		Reflection::SerializeContext& rContext,
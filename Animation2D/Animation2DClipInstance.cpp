@@ -12,6 +12,8 @@
 #include "Animation2DClipInstance.h"
 #include "Animation2DDataDefinition.h"
 #include "Animation2DDataInstance.h"
+#include "Animation2DMemoryUsage.h"
+#include "Animation2DProfile.h"
 #include "SeoulMath.h"
 
 #if SEOUL_WITH_ANIMATION_2D
@@ -34,413 +36,223 @@ static inline Float ToEditorTime(Float fTimeInSeconds)
 	return (Float)f;
 }
 
-class IEvaluator SEOUL_ABSTRACT
-{
-public:
-	IEvaluator()
-	{
-	}
-
-	virtual ~IEvaluator()
-	{
-	}
-
-	virtual void Evaluate(Float fTime, Float fAlpha, Bool bBlendDiscreteState) = 0;
-
-private:
-	SEOUL_DISABLE_COPY(IEvaluator);
-}; // class IEvaluator
+/**
+ * Number of keyframes that FindKeyFrame() will step forward from
+ * its cursor before falling back to a binary search. Playback is
+ * typically monotonic and advances by at most a key or two per
+ * frame, so the cursor is almost always a hit.
+ */
+static const UInt32 kuKeyFrameCursorSteps = 4u;
 
-class DrawOrderEvaluator SEOUL_SEALED : public IEvaluator
+/**
+ * @return The index of the first keyframe in v, at or after uBegin,
+ * with a time > fTime, or v.GetSize() if no such keyframe exists.
+ */
+template <typename T>
+static inline UInt32 KeyFrameUpperBound(const T& v, Float fTime, UInt32 uBegin = 0u)
 {
-public:
-	DrawOrderEvaluator(DataInstance& r, const KeyFramesDrawOrder& v)
-		: m_r(r)
-		, m_v(v)
+	UInt32 uLow = uBegin;
+	UInt32 uHigh = v.GetSize();
+	while (uLow < uHigh)
 	{
-	}
-
-	virtual void Evaluate(Float fTime, Float fAlpha, Bool bBlendDiscreteState) SEOUL_OVERRIDE
-	{
-		// If prior to the start of the curve, don't apply.
-		if (fTime < m_v.Front().m_fTime) { return; }
-
-		// TODO: Optimize as with standard KeyFrameEvalutors.
-		UInt32 u = 0u;
-		UInt32 const uEnd = m_v.GetSize();
-		while (u + 1u < uEnd && m_v[u + 1u].m_fTime <= fTime)
-		{
-			++u;
-		}
-
-		auto const& p = m_r.GetData();
-		auto& drawOrder = m_r.GetCache().m_vDrawOrder;
-		auto& scratch = m_r.GetCache().m_vDrawOrderScratch;
-		auto const& v = m_v[u].m_vOffsets;
-
-		// If no explicit draw order changes, set
-		// nothing (this will commit the default).
-		if (!v.IsEmpty())
+		UInt32 const uMid = uLow + ((uHigh - uLow) >> 1u);
+		if (v[uMid].m_fTime > fTime)
 		{
-			// Initialize scratch.
-			SetDefaultDrawOrder(m_r.GetSlots().GetSize(), scratch);
-
-			// Clear the draw order to -1 markers initially.
-			Int32 const iDraws = (Int32)scratch.GetSize();
-			drawOrder.Clear();
-			drawOrder.Resize((UInt32)iDraws, (Int16)-1);
-
-			// Now walk offsets and fill in orders that are changed.
-			for (auto i = v.Begin(); v.End() != i; ++i)
-			{
-				// For this index, insert it at its final position.
-				// in the draw order, and then (temporarily) clear
-				// it in the pending draw order.
-				Int16 iSlot = p->GetSlotIndex(i->m_Slot);
-				drawOrder[iSlot + i->m_iOffset] = iSlot;
-				scratch[iSlot] = -1;
-			}
-
-			// Finally, fill in any unchanged slots, and restore
-			// the pending slots, so it is always left in sequential
-			// order.
-			Int16 iOutSlot = (Int16)(iDraws - 1);
-			for (auto i = iDraws - 1; i >= 0; --i)
-			{
-				// Keep decrementing iOutSlot until we hit a valid
-				// slot.
-				while (iOutSlot >= 0 && scratch[iOutSlot] < 0)
-				{
-					// Fill in pending so, when we're done, it
-					// is back to being a sequential list.
-					scratch[iOutSlot] = iOutSlot;
-					--iOutSlot;
-				}
-
-				// If the slot was already assigned (drawOrder >= 0),
-				// skip it.
-				if (drawOrder[i] >= 0)
-				{
-					continue;
-				}
-
-				// Sanity check - if we get here, iOutSlot must be valid (>= 0);
-				SEOUL_ASSERT(iOutSlot >= 0);
-
-				// Otherwise, assign iOut.
-				drawOrder[i] = iOutSlot;
-				--iOutSlot;
-			}
-
-			while (iOutSlot >= 0)
-			{
-				// Sanity check - if we get here, pending[iOutSlot] must be invalid (< 0).
-				SEOUL_ASSERT(scratch[iOutSlot] < 0);
-				scratch[iOutSlot] = iOutSlot;
-				--iOutSlot;
-			}
-		}
-
-		// Sanity check that we properly fixed up pending, and that the sorted
-		// drawOrder has all slots
-#if !SEOUL_ASSERTIONS_DISABLED
-		{
-			auto copy = drawOrder;
-			QuickSort(copy.Begin(), copy.End());
-			for (UInt32 i = 0u; i < copy.GetSize(); ++i)
-			{
-				SEOUL_ASSERT(i == (UInt32)copy[i]);
-			}
+			uHigh = uMid;
 		}
-		for (UInt32 i = 0u; i < scratch.GetSize(); ++i)
+		else
 		{
-			SEOUL_ASSERT(i == (UInt32)scratch[i]);
+			uLow = uMid + 1u;
 		}
-#endif // /#if !SEOUL_ASSERTIONS_DISABLED
 	}
 
-private:
-	DataInstance& m_r;
-	const KeyFramesDrawOrder& m_v;
-
-	SEOUL_DISABLE_COPY(DrawOrderEvaluator);
-}; // class DrawOrderEvaluator
+	return uLow;
+}
 
-class EventEvaluator SEOUL_SEALED : public IEvaluator
+/**
+ * @return The index of the last keyframe in v with a time <= fTime,
+ * or 0 if fTime is before the first keyframe.
+ *
+ * ruCursor is the result of the previous search against v. It is
+ * checked first and stepped forward a few frames, with a binary
+ * search as the fallback (e.g. on a rewind or a large time step),
+ * so lookup is O(1) for regular playback and O(log n) otherwise.
+ */
+template <typename T>
+static inline UInt32 FindKeyFrame(const T& v, Float fTime, UInt32& ruCursor)
 {
-public:
-	EventEvaluator(
-		const KeyFramesEvent& v,
-		Float fEventMixThreshold)
-		: m_v(v)
-		, m_fEventMixThreshold(fEventMixThreshold)
-	{
-	}
+	SEOUL_ASSERT(!v.IsEmpty());
 
-	Bool GetNextEventTime(HString sEventName, Float fStartTime, Float& fEventTime) const
-	{
-		// Find the starting index.
-		UInt32 u = 0u;
-		UInt32 const uEnd = m_v.GetSize();
+	UInt32 const uSize = v.GetSize();
+	UInt32 u = (ruCursor < uSize ? ruCursor : 0u);
 
-		// Iterate and search for the start time
-		for (; u < uEnd; ++u)
-		{
-			if (m_v[u].m_fTime > fStartTime)
-			{
-				break;
-			}
-		}
-
-		// Iterate until we find a matching event name
-		for (; u < uEnd; ++u)
-		{
-			if (m_v[u].m_Id == sEventName)
-			{
-				fEventTime = m_v[u].m_fTime;
-				return true;
-			}
-		}
-
-		// no match
-		return false;
-	}
-
-	void EvaluateRange(DataInstance& r, Float fStartTime, Float fEndTime, Float fAlpha)
+	// Cursor is still valid (time has not moved backwards past it),
+	// try a short forward step.
+	UInt32 uBegin = 0u;
+	if (v[u].m_fTime <= fTime)
 	{
-		// Early out if we're below the mix threshold.
-		if (fAlpha < m_fEventMixThreshold)
+		for (UInt32 uStep = 0u; uStep < kuKeyFrameCursorSteps; ++uStep)
 		{
-			return;
-		}
-
-		// Early out if we don't have an evaluator.
-		auto pEventInterface = r.GetEventInterface();
-		if (!pEventInterface.IsValid())
-		{
-			return;
-		}
-
-		// Find the starting index.
-		UInt32 u = 0u;
-		UInt32 const uEnd = m_v.GetSize();
-
-		// fStartTime == 0.0 and m_v.Front().m_fTime == 0.0f
-		// is a special case. Normally, the evaluation range is (start, end], so that
-		// we don't play the event at end twice (when, on the next evaluation,
-		// end becomes start of the next range). However, since no time before 0.0 exists,
-		// we must treat 0.0 as a special case and include it in the range.
-		if (fStartTime != 0.0f || m_v.Front().m_fTime != 0.0f)
-		{
-			// Iterate and search for the normal start. Open range,
-			// so m_v[u].m_fTime must be > fStartTime to begin evaluation
-			// at it.
-			for (; u < uEnd; ++u)
-			{
-				if (m_v[u].m_fTime > fStartTime)
-				{
-					break;
-				}
-			}
-		}
-
-		// Iterate until we hit the end, dispatch an event
-		// at each frame.
-		for (; u < uEnd; ++u)
-		{
-			// Closed range - we include an index u if its time is <= fEndTime.
-			if (m_v[u].m_fTime > fEndTime)
+			if (u + 1u >= uSize || v[u + 1u].m_fTime > fTime)
 			{
-				break;
+				ruCursor = u;
+				return u;
 			}
 
-			auto const& e = m_v[u];
-			pEventInterface->DispatchEvent(e.m_Id, e.m_i, e.m_f, e.m_s);
+			++u;
 		}
-	}
 
-	virtual void Evaluate(Float fTime, Float fAlpha, Bool bBlendDiscreteState) SEOUL_OVERRIDE
-	{
-		// Nop
+		// Everything up to and including u is <= fTime.
+		uBegin = u;
 	}
 
-private:
-	const KeyFramesEvent& m_v;
-	Float const m_fEventMixThreshold;
-
-	SEOUL_DISABLE_COPY(EventEvaluator);
-}; // class EventEvaluator
+	// Fallback, binary search.
+	u = KeyFrameUpperBound(v, fTime, uBegin);
+	u = (u > 0u ? u - 1u : 0u);
+	ruCursor = u;
+	return u;
+}
 
-class KeyFrameEvaluator SEOUL_ABSTRACT : public IEvaluator
+/**
+ * @return The index of the first keyframe in v with a time > fTime,
+ * or v.GetSize() if no such keyframe exists. Cursored variation
+ * of KeyFrameUpperBound(), see also FindKeyFrame().
+ */
+template <typename T>
+static inline UInt32 FindKeyFrameAfter(const T& v, Float fTime, UInt32& ruCursor)
 {
-public:
-	KeyFrameEvaluator(const BezierCurves& vCurves)
-		: m_vCurves(vCurves)
-		, m_uLastKeyFrame(0)
-	{
-	}
-
-	virtual ~KeyFrameEvaluator()
+	if (fTime < v.Front().m_fTime)
 	{
+		return 0u;
 	}
 
-	template <typename T>
-	Float32 GetAlpha(
-		Float fTime,
-		const T& r0,
-		const T& r1) const
-	{
-		switch (r0.GetCurveType())
-		{
-		case CurveType::kLinear:
-			return Clamp((fTime - r0.m_fTime) / (r1.m_fTime - r0.m_fTime), 0.0f, 1.0f);
-		case CurveType::kStepped:
-			return 0.0f;
-		case CurveType::kBezier:
-			return GetBezierCurveAlpha(
-				Clamp((fTime - r0.m_fTime) / (r1.m_fTime - r0.m_fTime), 0.0f, 1.0f),
-				m_vCurves[r0.m_uCurveDataOffset]);
-		default:
-			SEOUL_FAIL("Out-of-sync enum, programmer error.");
-			return 0.0f;
-		};
-	}
+	return FindKeyFrame(v, fTime, ruCursor) + 1u;
+}
 
-	template <typename T>
-	Float32 GetFrames(
-		const T& v,
-		Float fTime,
-		typename T::ValueType const*& pr0,
-		typename T::ValueType const*& pr1)
+#if SEOUL_ANIMATION2D_UNIFORM_CURVES
+typedef UniformCurves CurveTables;
+static inline const CurveTables& GetCurveTables(const DataDefinition& data) { return data.GetUniformCurves(); }
+static inline Float32 GetCurveAlpha(Float fLinearAlpha, const UniformCurve& a) { return GetUniformCurveAlpha(fLinearAlpha, a); }
+#else
+typedef BezierCurves CurveTables;
+static inline const CurveTables& GetCurveTables(const DataDefinition& data) { return data.GetCurves(); }
+static inline Float32 GetCurveAlpha(Float fLinearAlpha, const BezierCurve& a) { return GetBezierCurveAlpha(fLinearAlpha, a); }
+#endif // /#if SEOUL_ANIMATION2D_UNIFORM_CURVES
+
+template <typename T>
+static inline Float32 GetAlpha(
+	const CurveTables& vCurves,
+	Float fTime,
+	const T& r0,
+	const T& r1)
+{
+	switch (r0.GetCurveType())
 	{
-		SEOUL_ASSERT(!v.IsEmpty());
+	case CurveType::kLinear:
+		return Clamp((fTime - r0.m_fTime) / (r1.m_fTime - r0.m_fTime), 0.0f, 1.0f);
+	case CurveType::kStepped:
+		return 0.0f;
+	case CurveType::kBezier:
+		return GetCurveAlpha(
+			Clamp((fTime - r0.m_fTime) / (r1.m_fTime - r0.m_fTime), 0.0f, 1.0f),
+			vCurves[r0.m_uCurveDataOffset]);
+	default:
+		SEOUL_FAIL("Out-of-sync enum, programmer error.");
+		return 0.0f;
+	};
+}
 
-		if (v[m_uLastKeyFrame].m_fTime > fTime)
-		{
-			if (0u == m_uLastKeyFrame)
-			{
-				pr0 = v.Get(m_uLastKeyFrame);
-				pr1 = pr0;
+/**
+ * Find the keyframes of rTrack that bracket fTime and
+ * return the interpolation alpha between them.
+ */
+template <typename T, typename TARGET>
+static inline Float32 GetFrames(
+	const CurveTables& vCurves,
+	ClipTrack<T, TARGET>& rTrack,
+	Float fTime,
+	typename T::ValueType const*& pr0,
+	typename T::ValueType const*& pr1)
+{
+	auto const& v = *rTrack.m_pKeyFrames;
+	SEOUL_ASSERT(!v.IsEmpty());
 
-				return GetAlpha(fTime, *pr0, *pr1);
-			}
+	UInt32 const u = FindKeyFrame(v, fTime, rTrack.m_uLastKeyFrame);
 
-			m_uLastKeyFrame = 0u;
-		}
+	// Interpolate to the next frame unless fTime is
+	// before the first frame or at/after the last frame.
+	pr0 = v.Get(u);
+	pr1 = ((u + 1u < v.GetSize() && pr0->m_fTime <= fTime) ? v.Get(u + 1u) : pr0);
 
-		UInt32 const uSize = v.GetSize();
-		for (; m_uLastKeyFrame + 1u < uSize; ++m_uLastKeyFrame)
-		{
-			if (v[m_uLastKeyFrame + 1u].m_fTime > fTime)
-			{
-				pr0 = v.Get(m_uLastKeyFrame);
-				pr1 = v.Get(m_uLastKeyFrame + 1u);
+	return GetAlpha(vCurves, fTime, *pr0, *pr1);
+}
 
-				return GetAlpha(fTime, *pr0, *pr1);
-			}
-		}
+static Float32 LerpBoolean(Bool bBase, Bool b0, Bool b1, Float fT, Float fAlpha)
+{
+	auto const fB = (bBase ? 1.0f : 0.0f);
+	auto const f0 = (b0 ? 1.0f : 0.0f);
+	auto const f1 = (b1 ? 1.0f : 0.0f);
 
-		pr0 = v.Get(m_uLastKeyFrame);
-		pr1 = pr0;
+	return  (Lerp(f0, f1, fT) - fB) * fAlpha;
+}
 
-		return GetAlpha(fTime, *pr0, *pr1);
+/** Register a reference to the deform data of key, held by a ClipInstance. */
+static void AcquireDeform(DataInstance& r, const DeformKey& key)
+{
+	auto& rRefs = r.GetDeformReferences();
+	auto p = rRefs.Find(key);
+	if (nullptr == p)
+	{
+		SEOUL_VERIFY(rRefs.Insert(key, 1).Second);
 	}
-
-private:
-	const BezierCurves& m_vCurves;
-	UInt32 m_uLastKeyFrame;
-
-	static Float32 GetBezierCurveAlpha(Float fLinearAlpha, const BezierCurve& a)
+	else
 	{
-		Float fX = a[0];
-		if (fX >= fLinearAlpha)
-		{
-			return (a[1] * fLinearAlpha) / fX;
-		}
-
-		for (UInt32 i = 2u; i < a.GetSize(); i += 2u)
-		{
-			fX = a[i];
-			if (fX >= fLinearAlpha)
-			{
-				Float const fPrevX = a[i-2];
-				Float const fPrevY = a[i-1];
-				return fPrevY + (((a[i+1] - fPrevY) * (fLinearAlpha - fPrevX)) / (fX - fPrevX));
-			}
-		}
-
-		Float const fY = a.Back();
-		return fY + (((1.0f - fY) * (fLinearAlpha - fX)) / (1.0f - fX));
+		(*p)++;
 	}
+}
 
-	SEOUL_DISABLE_COPY(KeyFrameEvaluator);
-}; // class KeyFrameEvaluator
-
-class DeformEvaluator SEOUL_SEALED : public KeyFrameEvaluator
+/** Release a reference acquired with AcquireDeform(), deactivating the deform data on the last reference. */
+static void ReleaseDeform(DataInstance& r, const DeformKey& key)
 {
-public:
-	DeformEvaluator(
-		DataInstance& r,
-		const KeyFramesDeform& v,
-		const BezierCurves& vCurves,
-		const DeformKey& key)
-		: KeyFrameEvaluator(vCurves)
-		, m_r(r)
-		, m_v(v)
-		, m_Key(key)
-	{
-		auto& rRefs = m_r.GetDeformReferences();
-		auto p = rRefs.Find(m_Key);
-		if (nullptr == p)
-		{
-			SEOUL_VERIFY(rRefs.Insert(m_Key, 1).Second);
-		}
-		else
-		{
-			(*p)++;
-		}
-	}
+	auto& rRefs = r.GetDeformReferences();
+	auto p = rRefs.Find(key);
+	SEOUL_ASSERT(nullptr != p);
+	SEOUL_ASSERT(*p > 0);
+	--(*p);
 
-	~DeformEvaluator()
+	if (*p == 0)
 	{
-		auto& rRefs = m_r.GetDeformReferences();
-		auto p = rRefs.Find(m_Key);
-		SEOUL_ASSERT(nullptr != p);
-		SEOUL_ASSERT(*p > 0);
-		--(*p);
-
-		if (*p == 0)
-		{
-			SEOUL_VERIFY(rRefs.Erase(m_Key));
-			CheckedPtr<DataInstance::DeformData> p;
-			(void)m_r.GetDeforms().GetValue(m_Key, p);
-			(void)m_r.GetDeforms().Erase(m_Key);
-			SafeDelete(p);
-		}
+		SEOUL_VERIFY(rRefs.Erase(key));
+		r.DeactivateDeform(key);
 	}
+}
 
-	virtual void Evaluate(Float fTime, Float fAlpha, Bool bBlendDiscreteState) SEOUL_OVERRIDE
+static void EvaluateDeforms(
+	DataInstance& r,
+	const CurveTables& vCurves,
+	ClipBinding::DeformTracks& v,
+	Float fTime,
+	Float fAlpha)
+{
+	for (auto& t : v)
 	{
 		// If prior to the start of the curve, don't apply.
-		if (fTime < m_v.Front().m_fTime)
+		if (fTime < t.m_pKeyFrames->Front().m_fTime)
 		{
-			auto& rRefs = m_r.GetDeformReferences();
-			auto p = rRefs.Find(m_Key);
+			auto& rRefs = r.GetDeformReferences();
+			auto p = rRefs.Find(t.m_Target);
 			SEOUL_ASSERT(nullptr != p);
 			if (*p == 1)
 			{
-				CheckedPtr<DataInstance::DeformData> pDeform;
-				(void)m_r.GetDeforms().GetValue(m_Key, pDeform);
-				(void)m_r.GetDeforms().Erase(m_Key);
-				SafeDelete(pDeform);
+				r.DeactivateDeform(t.m_Target);
 			}
 
-			return;
+			continue;
 		}
 
 		KeyFrameDeform const* pk0 = nullptr;
 		KeyFrameDeform const* pk1 = nullptr;
-		Float const fT = GetFrames(m_v, fTime, pk0, pk1);
+		Float const fT = GetFrames(vCurves, t, fTime, pk0, pk1);
 
 		auto const& v0 = (pk0->m_vVertices);
 		auto const& v1 = (pk1->m_vVertices);
@@ -448,27 +260,24 @@ public:
 		// Sanity check, this should be enforced by the data loader.
 		SEOUL_ASSERT(v0.GetSize() == v1.GetSize());
 
-		auto& deforms = m_r.GetDeforms();
-		CheckedPtr<DataInstance::DeformData> pData;
-		if (!deforms.GetValue(m_Key, pData))
+		Float fDeformAlpha = fAlpha;
+		Bool bActivated = false;
+		auto& vOut = r.ActivateDeform(t.m_Target, v0.GetSize(), bActivated);
+		if (bActivated)
 		{
-			pData = SEOUL_NEW(MemoryBudgets::Animation2D) DataInstance::DeformData(v0.GetSize());
-			SEOUL_VERIFY(deforms.Insert(m_Key, pData).Second);
-
 			// Since we are initializing the data for the first time, don't
 			// want to blend.
-			fAlpha = 1.0f;
+			fDeformAlpha = 1.0f;
 		}
 
 		// Perform the actual interpolation. Two different loops to avoid
-		// some extra work when fAlpha < 1.0f.
-		auto& vOut = *pData;
+		// some extra work when fDeformAlpha < 1.0f.
 		UInt32 const uSize = vOut.GetSize();
-		if (fAlpha < 1.0f)
+		if (fDeformAlpha < 1.0f)
 		{
 			for (UInt32 i = 0u; i < uSize; ++i)
 			{
-				vOut[i] += (Lerp(v0[i], v1[i], fT) - vOut[i]) * fAlpha;
+				vOut[i] += (Lerp(v0[i], v1[i], fT) - vOut[i]) * fDeformAlpha;
 			}
 		}
 		else
@@ -479,53 +288,126 @@ public:
 			}
 		}
 	}
+}
 
-private:
-	DataInstance& m_r;
-	const KeyFramesDeform& m_v;
-	DeformKey const m_Key;
+static void EvaluateDrawOrder(
+	DataInstance& r,
+	const ClipBinding& binding,
+	ClipBinding::DrawOrderTrack& t,
+	Float fTime)
+{
+	// If prior to the start of the curve, don't apply.
+	if (fTime < t.m_pKeyFrames->Front().m_fTime) { return; }
 
-	SEOUL_DISABLE_COPY(DeformEvaluator);
-}; // class DeformEvaluator
+	UInt32 const u = FindKeyFrame(*t.m_pKeyFrames, fTime, t.m_uLastKeyFrame);
 
-static Float32 LerpBoolean(Bool bBase, Bool b0, Bool b1, Float fT, Float fAlpha)
-{
-	auto const fB = (bBase ? 1.0f : 0.0f);
-	auto const f0 = (b0 ? 1.0f : 0.0f);
-	auto const f1 = (b1 ? 1.0f : 0.0f);
+	auto& drawOrder = r.GetCache().m_vDrawOrder;
+	auto& scratch = r.GetCache().m_vDrawOrderScratch;
+	auto const& v = (*t.m_pKeyFrames)[u].m_vOffsets;
 
-	return  (Lerp(f0, f1, fT) - fB) * fAlpha;
-}
+	// If no explicit draw order changes, set
+	// nothing (this will commit the default).
+	if (!v.IsEmpty())
+	{
+		// Initialize scratch.
+		SetDefaultDrawOrder(r.GetSlots().GetSize(), scratch);
+
+		// Clear the draw order to -1 markers initially.
+		Int32 const iDraws = (Int32)scratch.GetSize();
+		drawOrder.Clear();
+		drawOrder.Resize((UInt32)iDraws, (Int16)-1);
+
+		// Now walk offsets and fill in orders that are changed.
+		auto const piSlots = binding.m_viDrawOrderSlots.Get(binding.m_vDrawOrderOffsets[u]);
+		UInt32 const uOffsets = v.GetSize();
+		for (UInt32 i = 0u; i < uOffsets; ++i)
+		{
+			// For this index, insert it at its final position.
+			// in the draw order, and then (temporarily) clear
+			// it in the pending draw order.
+			Int16 const iSlot = piSlots[i];
+			drawOrder[iSlot + v[i].m_iOffset] = iSlot;
+			scratch[iSlot] = -1;
+		}
 
-class IkEvaluator SEOUL_SEALED : public KeyFrameEvaluator
-{
-public:
-	IkEvaluator(
-		DataInstance& r,
-		const KeyFramesIk& v,
-		const BezierCurves& vCurves,
-		Int16 iIk)
-		: KeyFrameEvaluator(vCurves)
-		, m_r(r)
-		, m_v(v)
-		, m_iIk(iIk)
+		// Finally, fill in any unchanged slots, and restore
+		// the pending slots, so it is always left in sequential
+		// order.
+		Int16 iOutSlot = (Int16)(iDraws - 1);
+		for (auto i = iDraws - 1; i >= 0; --i)
+		{
+			// Keep decrementing iOutSlot until we hit a valid
+			// slot.
+			while (iOutSlot >= 0 && scratch[iOutSlot] < 0)
+			{
+				// Fill in pending so, when we're done, it
+				// is back to being a sequential list.
+				scratch[iOutSlot] = iOutSlot;
+				--iOutSlot;
+			}
+
+			// If the slot was already assigned (drawOrder >= 0),
+			// skip it.
+			if (drawOrder[i] >= 0)
+			{
+				continue;
+			}
+
+			// Sanity check - if we get here, iOutSlot must be valid (>= 0);
+			SEOUL_ASSERT(iOutSlot >= 0);
+
+			// Otherwise, assign iOut.
+			drawOrder[i] = iOutSlot;
+			--iOutSlot;
+		}
+
+		while (iOutSlot >= 0)
+		{
+			// Sanity check - if we get here, pending[iOutSlot] must be invalid (< 0).
+			SEOUL_ASSERT(scratch[iOutSlot] < 0);
+			scratch[iOutSlot] = iOutSlot;
+			--iOutSlot;
+		}
+	}
+
+	// Sanity check that we properly fixed up pending, and that the sorted
+	// drawOrder has all slots
+#if !SEOUL_ASSERTIONS_DISABLED
+	{
+		auto copy = drawOrder;
+		QuickSort(copy.Begin(), copy.End());
+		for (UInt32 i = 0u; i < copy.GetSize(); ++i)
+		{
+			SEOUL_ASSERT(i == (UInt32)copy[i]);
+		}
+	}
+	for (UInt32 i = 0u; i < scratch.GetSize(); ++i)
 	{
+		SEOUL_ASSERT(i == (UInt32)scratch[i]);
 	}
+#endif // /#if !SEOUL_ASSERTIONS_DISABLED
+}
 
-	virtual void Evaluate(Float fTime, Float fAlpha, Bool bBlendDiscreteState) SEOUL_OVERRIDE
+static void EvaluateIk(
+	DataInstance& r,
+	const CurveTables& vCurves,
+	ClipBinding::IkTracks& v,
+	Float fTime,
+	Float fAlpha)
+{
+	auto const& vBase = r.GetData()->GetIk();
+	auto& cache = r.GetCache();
+	for (auto& t : v)
 	{
 		// If prior to the start of the curve, don't apply.
-		if (fTime < m_v.Front().m_fTime) { return; }
+		if (fTime < t.m_pKeyFrames->Front().m_fTime) { continue; }
 
-		// Cache common values.
-		auto const& p = m_r.GetData();
-		auto const& base = p->GetIk()[m_iIk];
-		auto& cache = m_r.GetCache();
+		auto const& base = vBase[t.m_Target];
 
 		// Standard case, interpolate between frames.
 		KeyFrameIk const* pk0 = nullptr;
 		KeyFrameIk const* pk1 = nullptr;
-		Float const fT = GetFrames(m_v, fTime, pk0, pk1);
+		Float const fT = GetFrames(vCurves, t, fTime, pk0, pk1);
 
 		// Setup values - these are deltas from the t-pose value.
 		Cache::IkEntry entry;
@@ -536,389 +418,240 @@ public:
 		entry.m_fStretch = LerpBoolean(base.m_bStretch, pk0->m_bStretch, pk1->m_bStretch, fT, fAlpha);
 
 		// Accumulate.
-		cache.AccumIk(m_iIk, entry);
+		cache.AccumIk(t.m_Target, entry);
 	}
+}
 
-private:
-	DataInstance& m_r;
-	const KeyFramesIk& m_v;
-	Int16 const m_iIk;
-
-	SEOUL_DISABLE_COPY(IkEvaluator);
-}; // class IkEvaluator
-
-class PathMixEvaluator SEOUL_SEALED : public KeyFrameEvaluator
+static void EvaluatePathMix(
+	DataInstance& r,
+	const CurveTables& vCurves,
+	ClipBinding::PathMixTracks& v,
+	Float fTime,
+	Float fAlpha)
 {
-public:
-	PathMixEvaluator(
-		DataInstance& r,
-		const KeyFramesPathMix& v,
-		const BezierCurves& vCurves,
-		Int16 iPath)
-		: KeyFrameEvaluator(vCurves)
-		, m_r(r)
-		, m_v(v)
-		, m_iPath(iPath)
-	{
-	}
-
-	virtual void Evaluate(Float fTime, Float fAlpha, Bool bBlendDiscreteState) SEOUL_OVERRIDE
+	auto const& vBase = r.GetData()->GetPaths();
+	auto& cache = r.GetCache();
+	for (auto& t : v)
 	{
 		// If prior to the start of the curve, don't apply.
-		if (fTime < m_v.Front().m_fTime) { return; }
+		if (fTime < t.m_pKeyFrames->Front().m_fTime) { continue; }
 
-		// Cache common values.
-		auto const& p = m_r.GetData();
-		auto const& base = p->GetPaths()[m_iPath];
-		auto& cache = m_r.GetCache();
+		auto const& base = vBase[t.m_Target];
 
 		// Standard case, interpolate between frames.
 		KeyFramePathMix const* pk0 = nullptr;
 		KeyFramePathMix const* pk1 = nullptr;
-		Float const fT = GetFrames(m_v, fTime, pk0, pk1);
+		Float const fT = GetFrames(vCurves, t, fTime, pk0, pk1);
 
 		// Accumulate.
-		cache.AccumPathMix(m_iPath, Vector2D(
+		cache.AccumPathMix(t.m_Target, Vector2D(
 			(Lerp(pk0->m_fPositionMix, pk1->m_fPositionMix, fT) - base.m_fPositionMix) * fAlpha,
 			(Lerp(pk0->m_fRotationMix, pk1->m_fRotationMix, fT) - base.m_fRotationMix) * fAlpha));
 	}
+}
 
-private:
-	DataInstance& m_r;
-	const KeyFramesPathMix& m_v;
-	Int16 const m_iPath;
-
-	SEOUL_DISABLE_COPY(PathMixEvaluator);
-}; // class PathMixEvaluator
-
-class PathPositionEvaluator SEOUL_SEALED : public KeyFrameEvaluator
+static void EvaluatePathPosition(
+	DataInstance& r,
+	const CurveTables& vCurves,
+	ClipBinding::PathPositionTracks& v,
+	Float fTime,
+	Float fAlpha)
 {
-public:
-	PathPositionEvaluator(
-		DataInstance& r,
-		const KeyFramesPathPosition& v,
-		const BezierCurves& vCurves,
-		Int16 iPath)
-		: KeyFrameEvaluator(vCurves)
-		, m_r(r)
-		, m_v(v)
-		, m_iPath(iPath)
-	{
-	}
-
-	virtual void Evaluate(Float fTime, Float fAlpha, Bool bBlendDiscreteState) SEOUL_OVERRIDE
+	auto const& vBase = r.GetData()->GetPaths();
+	auto& cache = r.GetCache();
+	for (auto& t : v)
 	{
 		// If prior to the start of the curve, don't apply.
-		if (fTime < m_v.Front().m_fTime) { return; }
+		if (fTime < t.m_pKeyFrames->Front().m_fTime) { continue; }
 
-		// Cache common values.
-		auto const& p = m_r.GetData();
-		auto const& base = p->GetPaths()[m_iPath];
-		auto& cache = m_r.GetCache();
+		auto const& base = vBase[t.m_Target];
 
 		// Standard case, interpolate between frames.
 		KeyFramePathPosition const* pk0 = nullptr;
 		KeyFramePathPosition const* pk1 = nullptr;
-		Float const fT = GetFrames(m_v, fTime, pk0, pk1);
+		Float const fT = GetFrames(vCurves, t, fTime, pk0, pk1);
 
 		// Accumulate.
-		cache.AccumPathPosition(m_iPath,
+		cache.AccumPathPosition(t.m_Target,
 			(Lerp(pk0->m_fPosition, pk1->m_fPosition, fT) - base.m_fPosition) * fAlpha);
 	}
+}
 
-private:
-	DataInstance& m_r;
-	const KeyFramesPathPosition& m_v;
-	Int16 const m_iPath;
-
-	SEOUL_DISABLE_COPY(PathPositionEvaluator);
-}; // class PathPositionEvaluator
-
-class PathSpacingEvaluator SEOUL_SEALED : public KeyFrameEvaluator
+static void EvaluatePathSpacing(
+	DataInstance& r,
+	const CurveTables& vCurves,
+	ClipBinding::PathSpacingTracks& v,
+	Float fTime,
+	Float fAlpha)
 {
-public:
-	PathSpacingEvaluator(
-		DataInstance& r,
-		const KeyFramesPathSpacing& v,
-		const BezierCurves& vCurves,
-		Int16 iPath)
-		: KeyFrameEvaluator(vCurves)
-		, m_r(r)
-		, m_v(v)
-		, m_iPath(iPath)
-	{
-	}
-
-	virtual void Evaluate(Float fTime, Float fAlpha, Bool bBlendDiscreteState) SEOUL_OVERRIDE
+	auto const& vBase = r.GetData()->GetPaths();
+	auto& cache = r.GetCache();
+	for (auto& t : v)
 	{
 		// If prior to the start of the curve, don't apply.
-		if (fTime < m_v.Front().m_fTime) { return; }
+		if (fTime < t.m_pKeyFrames->Front().m_fTime) { continue; }
 
-		// Cache common values.
-		auto const& p = m_r.GetData();
-		auto const& base = p->GetPaths()[m_iPath];
-		auto& cache = m_r.GetCache();
+		auto const& base = vBase[t.m_Target];
 
 		// Standard case, interpolate between frames.
 		KeyFramePathSpacing const* pk0 = nullptr;
 		KeyFramePathSpacing const* pk1 = nullptr;
-		Float const fT = GetFrames(m_v, fTime, pk0, pk1);
+		Float const fT = GetFrames(vCurves, t, fTime, pk0, pk1);
 
 		// Accumulate.
-		cache.AccumPathSpacing(m_iPath,
+		cache.AccumPathSpacing(t.m_Target,
 			(Lerp(pk0->m_fSpacing, pk1->m_fSpacing, fT) - base.m_fSpacing) * fAlpha);
 	}
+}
 
-private:
-	DataInstance& m_r;
-	const KeyFramesPathSpacing& m_v;
-	Int16 const m_iPath;
-
-	SEOUL_DISABLE_COPY(PathSpacingEvaluator);
-}; // class PathSpacingEvaluator
-
-class RotationEvaluator SEOUL_SEALED : public KeyFrameEvaluator
+static void EvaluateRotation(
+	DataInstance& r,
+	const CurveTables& vCurves,
+	ClipBinding::RotationTracks& v,
+	Float fTime,
+	Float fAlpha)
 {
-public:
-	RotationEvaluator(
-		DataInstance& r,
-		const KeyFramesRotation& v,
-		const BezierCurves& vCurves,
-		Int16 iBone)
-		: KeyFrameEvaluator(vCurves)
-		, m_r(r)
-		, m_v(v)
-		, m_iBone(iBone)
-	{
-	}
-
-	virtual void Evaluate(Float fTime, Float fAlpha, Bool bBlendDiscreteState) SEOUL_OVERRIDE
+	auto& cache = r.GetCache();
+	for (auto& t : v)
 	{
 		// If prior to the start of the curve, don't apply.
-		if (fTime < m_v.Front().m_fTime) { return; }
-
-		// Cache common values.
-		auto& cache = m_r.GetCache();
+		if (fTime < t.m_pKeyFrames->Front().m_fTime) { continue; }
 
 		// Standard case, interpolate between frames.
 		KeyFrameRotation const* pk0 = nullptr;
 		KeyFrameRotation const* pk1 = nullptr;
-		Float const fT = GetFrames(m_v, fTime, pk0, pk1);
+		Float const fT = GetFrames(vCurves, t, fTime, pk0, pk1);
 
 		// Accumulate.
-		cache.AccumRotation(m_iBone,
+		cache.AccumRotation(t.m_Target,
 			fAlpha * LerpDegrees(pk0->m_fAngleInDegrees, pk1->m_fAngleInDegrees, fT));
 	}
+}
 
-private:
-	DataInstance& m_r;
-	const KeyFramesRotation& m_v;
-	Int16 const m_iBone;
-
-	SEOUL_DISABLE_COPY(RotationEvaluator);
-}; // class RotationEvaluator
-
-class ScaleEvaluator SEOUL_SEALED : public KeyFrameEvaluator
+static void EvaluateScale(
+	DataInstance& r,
+	const CurveTables& vCurves,
+	ClipBinding::ScaleTracks& v,
+	Float fTime,
+	Float fAlpha)
 {
-public:
-	ScaleEvaluator(
-		DataInstance& r,
-		const KeyFramesScale& v,
-		const BezierCurves& vCurves,
-		Int16 iBone)
-		: KeyFrameEvaluator(vCurves)
-		, m_r(r)
-		, m_v(v)
-		, m_iBone(iBone)
-	{
-	}
-
-	virtual void Evaluate(Float fTime, Float fAlpha, Bool bBlendDiscreteState) SEOUL_OVERRIDE
+	auto& cache = r.GetCache();
+	for (auto& t : v)
 	{
 		// If prior to the start of the curve, don't apply.
-		if (fTime < m_v.Front().m_fTime) { return; }
-
-		// Cache common values.
-		auto& cache = m_r.GetCache();
+		if (fTime < t.m_pKeyFrames->Front().m_fTime) { continue; }
 
 		// Standard case, interpolate between frames.
 		KeyFrameScale const* pk0 = nullptr;
 		KeyFrameScale const* pk1 = nullptr;
-		Float const fT = GetFrames(m_v, fTime, pk0, pk1);
+		Float const fT = GetFrames(vCurves, t, fTime, pk0, pk1);
 
 		// Accumulate.
-		cache.AccumScale(m_iBone,
+		cache.AccumScale(t.m_Target,
 			fAlpha * Vector2D(Lerp(pk0->m_fX, pk1->m_fX, fT), Lerp(pk0->m_fY, pk1->m_fY, fT)), fAlpha);
 	}
+}
 
-private:
-	DataInstance& m_r;
-	const KeyFramesScale& m_v;
-	Int16 const m_iBone;
-
-	SEOUL_DISABLE_COPY(ScaleEvaluator);
-}; // class ScaleEvaluator
-
-class ShearEvaluator SEOUL_SEALED : public KeyFrameEvaluator
+static void EvaluateShear(
+	DataInstance& r,
+	const CurveTables& vCurves,
+	ClipBinding::ShearTracks& v,
+	Float fTime,
+	Float fAlpha)
 {
-public:
-	ShearEvaluator(
-		DataInstance& r,
-		const KeyFrames2D& v,
-		const BezierCurves& vCurves,
-		Int16 iBone)
-		: KeyFrameEvaluator(vCurves)
-		, m_r(r)
-		, m_v(v)
-		, m_iBone(iBone)
-	{
-	}
-
-	virtual void Evaluate(Float fTime, Float fAlpha, Bool bBlendDiscreteState) SEOUL_OVERRIDE
+	auto& cache = r.GetCache();
+	for (auto& t : v)
 	{
 		// If prior to the start of the curve, don't apply.
-		if (fTime < m_v.Front().m_fTime) { return; }
-
-		// Cache common values.
-		auto& cache = m_r.GetCache();
+		if (fTime < t.m_pKeyFrames->Front().m_fTime) { continue; }
 
 		// Standard case, interpolate between frames.
 		KeyFrame2D const* pk0 = nullptr;
 		KeyFrame2D const* pk1 = nullptr;
-		Float const fT = GetFrames(m_v, fTime, pk0, pk1);
+		Float const fT = GetFrames(vCurves, t, fTime, pk0, pk1);
 
 		// Accumulate.
-		cache.AccumShear(m_iBone,
+		cache.AccumShear(t.m_Target,
 			fAlpha * Vector2D(Lerp(pk0->m_fX, pk1->m_fX, fT), Lerp(pk0->m_fY, pk1->m_fY, fT)));
 	}
+}
 
-private:
-	DataInstance& m_r;
-	const KeyFrames2D& m_v;
-	Int16 const m_iBone;
-
-	SEOUL_DISABLE_COPY(ShearEvaluator);
-}; // class ShearEvaluator
-
-class SlotAttachmentEvaluator SEOUL_SEALED : public IEvaluator
+static void EvaluateSlotAttachment(
+	DataInstance& r,
+	ClipBinding::AttachmentTracks& v,
+	Float fTime,
+	Float fAlpha,
+	Bool bBlendDiscreteState)
 {
-public:
-	SlotAttachmentEvaluator(
-		DataInstance& r,
-		const KeyFramesAttachment& v,
-		Int16 iSlot)
-		: m_r(r)
-		, m_v(v)
-		, m_iSlot(iSlot)
-	{
-	}
+	// Potentially don't apply based on blend mode (mis)match.
+	if (!bBlendDiscreteState && 1.0f != fAlpha) { return; }
 
-	virtual void Evaluate(Float fTime, Float fAlpha, Bool bBlendDiscreteState) SEOUL_OVERRIDE
+	auto& cache = r.GetCache();
+	for (auto& t : v)
 	{
 		// If prior to the start of the curve, don't apply.
-		if (fTime < m_v.Front().m_fTime) { return; }
-		// Potentially don't apply based on blend mode (mis)match.
-		if (!bBlendDiscreteState && 1.0f != fAlpha) { return; }
-
-		// TODO: Optimize as with standard KeyFrameEvalutors.
-		UInt32 u = 0u;
-		UInt32 const uEnd = m_v.GetSize();
-		while (u + 1u < uEnd && m_v[u + 1u].m_fTime <= fTime)
-		{
-			++u;
-		}
+		if (fTime < t.m_pKeyFrames->Front().m_fTime) { continue; }
+
+		UInt32 const u = FindKeyFrame(*t.m_pKeyFrames, fTime, t.m_uLastKeyFrame);
 
 		// Accumulate.
-		auto& cache = m_r.GetCache();
-		cache.AccumSlotAttachment(m_iSlot, m_v[u].m_Id, fAlpha);
+		cache.AccumSlotAttachment(t.m_Target, (*t.m_pKeyFrames)[u].m_Id, fAlpha);
 	}
+}
 
-private:
-	DataInstance& m_r;
-	const KeyFramesAttachment& m_v;
-	Int16 const m_iSlot;
-
-	SEOUL_DISABLE_COPY(SlotAttachmentEvaluator);
-}; // class SlotAttachmentEvaluator
-
-class SlotColorEvaluator SEOUL_SEALED : public KeyFrameEvaluator
+static void EvaluateSlotColor(
+	DataInstance& r,
+	const CurveTables& vCurves,
+	ClipBinding::ColorTracks& v,
+	Float fTime,
+	Float fAlpha)
 {
-public:
-	SlotColorEvaluator(
-		DataInstance& r,
-		const KeyFramesColor& v,
-		const BezierCurves& vCurves,
-		Int16 iSlot)
-		: KeyFrameEvaluator(vCurves)
-		, m_r(r)
-		, m_v(v)
-		, m_iSlot(iSlot)
-	{
-	}
-
-	virtual void Evaluate(Float fTime, Float fAlpha, Bool bBlendDiscreteState) SEOUL_OVERRIDE
+	auto const& vBase = r.GetData()->GetSlots();
+	auto& cache = r.GetCache();
+	for (auto& t : v)
 	{
 		// If prior to the start of the curve, don't apply.
-		if (fTime < m_v.Front().m_fTime) { return; }
+		if (fTime < t.m_pKeyFrames->Front().m_fTime) { continue; }
 
-		// Cache common values.
-		auto const& p = m_r.GetData();
-		auto const& base = p->GetSlots()[m_iSlot];
-		auto& cache = m_r.GetCache();
+		auto const& base = vBase[t.m_Target];
 
 		// Standard case, interpolate between frames.
 		KeyFrameColor const* pk0 = nullptr;
 		KeyFrameColor const* pk1 = nullptr;
-		Float const fT = GetFrames(m_v, fTime, pk0, pk1);
+		Float const fT = GetFrames(vCurves, t, fTime, pk0, pk1);
 
 		// Accumulate.
-		cache.AccumSlotColor(m_iSlot, Vector4D(
+		cache.AccumSlotColor(t.m_Target, Vector4D(
 			(Lerp((Float)pk0->m_Color.m_R, (Float)pk1->m_Color.m_R, fT) - (Float)base.m_Color.m_R) * fAlpha,
 			(Lerp((Float)pk0->m_Color.m_G, (Float)pk1->m_Color.m_G, fT) - (Float)base.m_Color.m_G) * fAlpha,
 			(Lerp((Float)pk0->m_Color.m_B, (Float)pk1->m_Color.m_B, fT) - (Float)base.m_Color.m_B) * fAlpha,
 			(Lerp((Float)pk0->m_Color.m_A, (Float)pk1->m_Color.m_A, fT) - (Float)base.m_Color.m_A) * fAlpha));
 	}
+}
 
-private:
-	DataInstance& m_r;
-	const KeyFramesColor& m_v;
-	Int16 const m_iSlot;
-
-	SEOUL_DISABLE_COPY(SlotColorEvaluator);
-}; // class SlotColorEvaluator
-
-class SlotTwoColorEvaluator SEOUL_SEALED : public KeyFrameEvaluator
+static void EvaluateSlotTwoColor(
+	DataInstance& r,
+	const CurveTables& vCurves,
+	ClipBinding::TwoColorTracks& v,
+	Float fTime,
+	Float fAlpha)
 {
-public:
-	SlotTwoColorEvaluator(
-		DataInstance& r,
-		const KeyFramesTwoColor& v,
-		const BezierCurves& vCurves,
-		Int16 iSlot)
-		: KeyFrameEvaluator(vCurves)
-		, m_r(r)
-		, m_v(v)
-		, m_iSlot(iSlot)
-	{
-	}
-
-	virtual void Evaluate(Float fTime, Float fAlpha, Bool bBlendDiscreteState) SEOUL_OVERRIDE
+	auto const& vBase = r.GetData()->GetSlots();
+	auto& cache = r.GetCache();
+	for (auto& t : v)
 	{
 		// If prior to the start of the curve, don't apply.
-		if (fTime < m_v.Front().m_fTime) { return; }
+		if (fTime < t.m_pKeyFrames->Front().m_fTime) { continue; }
 
-		// Cache common values.
-		auto const& p = m_r.GetData();
-		auto const& base = p->GetSlots()[m_iSlot];
-		auto& cache = m_r.GetCache();
+		auto const& base = vBase[t.m_Target];
 
 		// Standard case, interpolate between frames.
 		KeyFrameTwoColor const* pk0 = nullptr;
 		KeyFrameTwoColor const* pk1 = nullptr;
-		Float const fT = GetFrames(m_v, fTime, pk0, pk1);
+		Float const fT = GetFrames(vCurves, t, fTime, pk0, pk1);
 
 		// Accumulate.
-		cache.AccumSlotTwoColor(m_iSlot, Cache::TwoColorEntry(
+		cache.AccumSlotTwoColor(t.m_Target, Cache::TwoColorEntry(
 			(Lerp((Float)pk0->m_Color.m_R, (Float)pk1->m_Color.m_R, fT) - (Float)base.m_Color.m_R) * fAlpha,
 			(Lerp((Float)pk0->m_Color.m_G, (Float)pk1->m_Color.m_G, fT) - (Float)base.m_Color.m_G) * fAlpha,
 			(Lerp((Float)pk0->m_Color.m_B, (Float)pk1->m_Color.m_B, fT) - (Float)base.m_Color.m_B) * fAlpha,
@@ -927,129 +660,272 @@ public:
 			(Lerp((Float)pk0->m_SecondaryColor.m_G, (Float)pk1->m_SecondaryColor.m_G, fT) - (Float)base.m_SecondaryColor.m_G) * fAlpha,
 			(Lerp((Float)pk0->m_SecondaryColor.m_B, (Float)pk1->m_SecondaryColor.m_B, fT) - (Float)base.m_SecondaryColor.m_B) * fAlpha));
 	}
+}
 
-private:
-	DataInstance& m_r;
-	const KeyFramesTwoColor& m_v;
-	Int16 const m_iSlot;
-
-	SEOUL_DISABLE_COPY(SlotTwoColorEvaluator);
-}; // class SlotTwoColorEvaluator
-
-class TransformEvaluator SEOUL_SEALED : public KeyFrameEvaluator
+static void EvaluateTransform(
+	DataInstance& r,
+	const CurveTables& vCurves,
+	ClipBinding::TransformTracks& v,
+	Float fTime,
+	Float fAlpha)
 {
-public:
-	TransformEvaluator(
-		DataInstance& r,
-		const KeyFramesTransform& v,
-		const BezierCurves& vCurves,
-		Int16 iTransform)
-		: KeyFrameEvaluator(vCurves)
-		, m_r(r)
-		, m_v(v)
-		, m_iTransform(iTransform)
-	{
-	}
-
-	virtual void Evaluate(Float fTime, Float fAlpha, Bool bBlendDiscreteState) SEOUL_OVERRIDE
+	auto const& vBase = r.GetData()->GetTransforms();
+	auto& cache = r.GetCache();
+	for (auto& t : v)
 	{
 		// If prior to the start of the curve, don't apply.
-		if (fTime < m_v.Front().m_fTime) { return; }
+		if (fTime < t.m_pKeyFrames->Front().m_fTime) { continue; }
 
-		// Cache common values.
-		auto const& p = m_r.GetData();
-		auto const& base = p->GetTransforms()[m_iTransform];
-		auto& cache = m_r.GetCache();
+		auto const& base = vBase[t.m_Target];
 
 		// Standard case, interpolate between frames.
 		KeyFrameTransform const* pk0 = nullptr;
 		KeyFrameTransform const* pk1 = nullptr;
-		Float const fT = GetFrames(m_v, fTime, pk0, pk1);
+		Float const fT = GetFrames(vCurves, t, fTime, pk0, pk1);
 
 		// Accumulate.
-		cache.AccumTransform(m_iTransform, Vector4D(
+		cache.AccumTransform(t.m_Target, Vector4D(
 			(Lerp(pk0->m_fPositionMix, pk1->m_fPositionMix, fT) - base.m_fPositionMix) * fAlpha,
 			(Lerp(pk0->m_fRotationMix, pk1->m_fRotationMix, fT) - base.m_fRotationMix) * fAlpha,
 			(Lerp(pk0->m_fScaleMix, pk1->m_fScaleMix, fT) - base.m_fScaleMix) * fAlpha,
 			(Lerp(pk0->m_fShearMix, pk1->m_fShearMix, fT) - base.m_fShearMix) * fAlpha));
 	}
+}
 
-private:
-	DataInstance& m_r;
-	const KeyFramesTransform& m_v;
-	Int16 const m_iTransform;
-
-	SEOUL_DISABLE_COPY(TransformEvaluator);
-}; // class TransformEvaluator
-
-class TranslationEvaluator SEOUL_SEALED : public KeyFrameEvaluator
+static void EvaluateTranslation(
+	DataInstance& r,
+	const CurveTables& vCurves,
+	ClipBinding::TranslationTracks& v,
+	Float fTime,
+	Float fAlpha)
 {
-public:
-	TranslationEvaluator(
-		DataInstance& r,
-		const KeyFrames2D& v,
-		const BezierCurves& vCurves,
-		Int16 iBone)
-		: KeyFrameEvaluator(vCurves)
-		, m_r(r)
-		, m_v(v)
-		, m_iBone(iBone)
-	{
-	}
-
-	virtual void Evaluate(Float fTime, Float fAlpha, Bool bBlendDiscreteState) SEOUL_OVERRIDE
+	auto& cache = r.GetCache();
+	for (auto& t : v)
 	{
 		// If prior to the start of the curve, don't apply.
-		if (fTime < m_v.Front().m_fTime) { return; }
-
-		// Cache common values.
-		auto& cache = m_r.GetCache();
+		if (fTime < t.m_pKeyFrames->Front().m_fTime) { continue; }
 
 		// Standard case, interpolate between frames.
 		KeyFrame2D const* pk0 = nullptr;
 		KeyFrame2D const* pk1 = nullptr;
-		Float const fT = GetFrames(m_v, fTime, pk0, pk1);
+		Float const fT = GetFrames(vCurves, t, fTime, pk0, pk1);
 
 		// Accumulate.
-		cache.AccumPosition(m_iBone,
+		cache.AccumPosition(t.m_Target,
 			fAlpha * Vector2D(Lerp(pk0->m_fX, pk1->m_fX, fT), Lerp(pk0->m_fY, pk1->m_fY, fT)));
 	}
+}
+
+/** Key frames of discrete timelines (attachments, draw order) are always stepped. */
+static inline Bool IsSteppedKeyFrame(const BaseKeyFrame& k) { return (CurveType::kStepped == k.GetCurveType()); }
+static inline Bool IsSteppedKeyFrame(const KeyFrameAttachment&) { return true; }
+static inline Bool IsSteppedKeyFrame(const KeyFrameDrawOrder&) { return true; }
+
+/**
+ * Narrow [rfBegin, rfEnd) to the range around fTime over which
+ * the output of t is constant. Returns false if the output of t
+ * changes at fTime (it is interpolating between key frames).
+ */
+template <typename T, typename TARGET>
+static Bool GetTrackHoldRange(const ClipTrack<T, TARGET>& t, Float fTime, Float& rfBegin, Float& rfEnd)
+{
+	auto const& v = *t.m_pKeyFrames;
+
+	// Prior to the start of the curve, nothing is applied until the first frame.
+	if (fTime < v.Front().m_fTime)
+	{
+		rfEnd = Min(rfEnd, v.Front().m_fTime);
+		return true;
+	}
+
+	// Query only, the cursor of the track is not advanced.
+	UInt32 uCursor = t.m_uLastKeyFrame;
+	UInt32 const u = FindKeyFrame(v, fTime, uCursor);
+	rfBegin = Max(rfBegin, v[u].m_fTime);
 
-private:
-	DataInstance& m_r;
-	const KeyFrames2D& m_v;
-	Int16 const m_iBone;
+	// At or after the last frame, constant from here on.
+	if (u + 1u >= v.GetSize())
+	{
+		return true;
+	}
+
+	// Otherwise, constant until the next frame if stepped.
+	if (!IsSteppedKeyFrame(v[u]))
+	{
+		return false;
+	}
+
+	rfEnd = Min(rfEnd, v[u + 1u].m_fTime);
+	return true;
+}
+
+template <typename T>
+static Bool GetTracksHoldRange(const T& v, Float fTime, Float& rfBegin, Float& rfEnd)
+{
+	for (auto const& t : v)
+	{
+		if (!GetTrackHoldRange(t, fTime, rfBegin, rfEnd))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+ClipBinding::ClipBinding()
+	: m_pData(nullptr)
+	, m_fMaxTime(0.0f)
+	, m_vRotation()
+	, m_vScale()
+	, m_vShear()
+	, m_vTranslation()
+	, m_vDeform()
+	, m_DrawOrder()
+	, m_Events()
+	, m_vIk()
+	, m_vPathMix()
+	, m_vPathPosition()
+	, m_vPathSpacing()
+	, m_vAttachment()
+	, m_vColor()
+	, m_vTwoColor()
+	, m_vTransform()
+	, m_vDrawOrderOffsets()
+	, m_viDrawOrderSlots()
+{
+}
+
+/** Reset to an empty binding. Vector capacity is retained. */
+void ClipBinding::Clear()
+{
+	m_pData = nullptr;
+	m_fMaxTime = 0.0f;
+	m_vRotation.Clear();
+	m_vScale.Clear();
+	m_vShear.Clear();
+	m_vTranslation.Clear();
+	m_vDeform.Clear();
+	m_DrawOrder = DrawOrderTrack();
+	m_Events = EventTrack();
+	m_vIk.Clear();
+	m_vPathMix.Clear();
+	m_vPathPosition.Clear();
+	m_vPathSpacing.Clear();
+	m_vAttachment.Clear();
+	m_vColor.Clear();
+	m_vTwoColor.Clear();
+	m_vTransform.Clear();
+	m_vDrawOrderOffsets.Clear();
+	m_viDrawOrderSlots.Clear();
+}
+
+/** @return The number of timelines in this binding. */
+UInt32 ClipBinding::GetTrackCount() const
+{
+	return
+		m_vRotation.GetSize() +
+		m_vScale.GetSize() +
+		m_vShear.GetSize() +
+		m_vTranslation.GetSize() +
+		m_vDeform.GetSize() +
+		(m_DrawOrder.IsValid() ? 1u : 0u) +
+		(m_Events.IsValid() ? 1u : 0u) +
+		m_vIk.GetSize() +
+		m_vPathMix.GetSize() +
+		m_vPathPosition.GetSize() +
+		m_vPathSpacing.GetSize() +
+		m_vAttachment.GetSize() +
+		m_vColor.GetSize() +
+		m_vTwoColor.GetSize() +
+		m_vTransform.GetSize();
+}
 
-	SEOUL_DISABLE_COPY(TranslationEvaluator);
-}; // class TranslationEvaluator
+UInt32 ClipBinding::GetHeapSize() const
+{
+	return
+		Animation2D::GetHeapSize(m_vRotation) +
+		Animation2D::GetHeapSize(m_vScale) +
+		Animation2D::GetHeapSize(m_vShear) +
+		Animation2D::GetHeapSize(m_vTranslation) +
+		Animation2D::GetHeapSize(m_vDeform) +
+		Animation2D::GetHeapSize(m_vIk) +
+		Animation2D::GetHeapSize(m_vPathMix) +
+		Animation2D::GetHeapSize(m_vPathPosition) +
+		Animation2D::GetHeapSize(m_vPathSpacing) +
+		Animation2D::GetHeapSize(m_vAttachment) +
+		Animation2D::GetHeapSize(m_vColor) +
+		Animation2D::GetHeapSize(m_vTwoColor) +
+		Animation2D::GetHeapSize(m_vTransform) +
+		Animation2D::GetHeapSize(m_vDrawOrderOffsets) +
+		Animation2D::GetHeapSize(m_viDrawOrderSlots);
+}
 
 ClipInstance::ClipInstance(DataInstance& r, const SharedPtr<Clip>& pClip, const Animation::ClipSettings& settings)
 	: m_Settings(settings)
 	, m_r(r)
 	, m_pClip(pClip)
-	, m_fMaxTime(0.0f)
-	, m_vEvaluators()
-	, m_pEventEvaluator()
+	, m_Tracks()
 {
-	InternalConstructEvaluators();
+	InternalConstructTracks();
 }
 
 ClipInstance::~ClipInstance()
 {
-	m_pEventEvaluator.Reset();
-	SafeDeleteVector(m_vEvaluators);
+	Clear();
+}
+
+/**
+ * Release the clip of this instance and the deform references
+ * held by its timelines. Vector capacity is retained, so that
+ * a subsequent Reset() does not allocate in the common case.
+ */
+void ClipInstance::Clear()
+{
+	for (auto const& t : m_Tracks.m_vDeform)
+	{
+		ReleaseDeform(m_r, t.m_Target);
+	}
+
+	m_Tracks.Clear();
+	m_pClip.Reset();
+}
+
+/** Equivalent to destroying and reconstructing this instance, but reuses track storage. */
+void ClipInstance::Reset(const SharedPtr<Clip>& pClip, const Animation::ClipSettings& settings)
+{
+	Clear();
+
+	m_Settings = settings;
+	m_pClip = pClip;
+	InternalConstructTracks();
 }
 
 Bool ClipInstance::GetNextEventTime(HString sEventName, Float fStartTime, Float& fEventTime) const
 {
+	if (!m_Tracks.m_Events.IsValid())
+	{
+		return false;
+	}
+
 	// Sanitize.
 	fStartTime = ToEditorTime(fStartTime);
 
-	if (m_pEventEvaluator.IsValid())
+	// Find the starting index.
+	auto const& v = *m_Tracks.m_Events.m_pKeyFrames;
+	UInt32 const uEnd = v.GetSize();
+
+	// Iterate until we find a matching event name
+	for (UInt32 u = KeyFrameUpperBound(v, fStartTime); u < uEnd; ++u)
 	{
-		return m_pEventEvaluator->GetNextEventTime(sEventName, fStartTime, fEventTime);
+		if (v[u].m_Id == sEventName)
+		{
+			fEventTime = v[u].m_fTime;
+			return true;
+		}
 	}
 
+	// no match
 	return false;
 }
 
@@ -1060,45 +936,229 @@ Bool ClipInstance::GetNextEventTime(HString sEventName, Float fStartTime, Float&
  */
 void ClipInstance::EvaluateRange(Float fStartTime, Float fEndTime, Float fAlpha)
 {
+	// Early out if no events.
+	if (!m_Tracks.m_Events.IsValid())
+	{
+		return;
+	}
+
+	// Early out if we're below the mix threshold.
+	if (fAlpha < m_Settings.m_fEventMixThreshold)
+	{
+		return;
+	}
+
+	// Early out if we don't have an evaluator.
+	auto pEventInterface = m_r.GetEventInterface();
+	if (!pEventInterface.IsValid())
+	{
+		return;
+	}
+
 	// Sanitize.
 	fStartTime = ToEditorTime(fStartTime);
 	fEndTime = ToEditorTime(fEndTime);
 
-	if (m_pEventEvaluator.IsValid())
+	// Find the starting index.
+	auto const& v = *m_Tracks.m_Events.m_pKeyFrames;
+	UInt32 u = 0u;
+	UInt32 const uEnd = v.GetSize();
+
+	// fStartTime == 0.0 and v.Front().m_fTime == 0.0f
+	// is a special case. Normally, the evaluation range is (start, end], so that
+	// we don't play the event at end twice (when, on the next evaluation,
+	// end becomes start of the next range). However, since no time before 0.0 exists,
+	// we must treat 0.0 as a special case and include it in the range.
+	if (fStartTime != 0.0f || v.Front().m_fTime != 0.0f)
+	{
+		// Search for the normal start. Open range,
+		// so v[u].m_fTime must be > fStartTime to begin evaluation
+		// at it.
+		u = FindKeyFrameAfter(v, fStartTime, m_Tracks.m_Events.m_uLastKeyFrame);
+	}
+
+	// Iterate until we hit the end, dispatch an event
+	// at each frame.
+	for (; u < uEnd; ++u)
 	{
-		m_pEventEvaluator->EvaluateRange(m_r, fStartTime, fEndTime, fAlpha);
+		// Closed range - we include an index u if its time is <= fEndTime.
+		if (v[u].m_fTime > fEndTime)
+		{
+			break;
+		}
+
+		auto const& e = v[u];
+		if (m_r.AreEventsDeferred())
+		{
+			m_r.QueueEvent(m_pClip, e);
+			continue;
+		}
+
+		SEOUL_ANIMATION2D_PROFILE("Animation2D.EventDispatch", &m_r.GetData()->GetProfile(), ProfileCounter::kEventDispatch);
+		pEventInterface->DispatchEvent(e.m_Id, e.m_i, e.m_f, e.m_s);
 	}
 }
 
+/** Rate (in samples per second) to which clip time is quantized with shared posing. */
+static const Float kfSharedPoseSampleRate = 30.0f;
+
+/** Number of discrete (non-zero) blend weights with shared posing. */
+static const Float kfSharedPoseAlphaSteps = 32.0f;
+
 void ClipInstance::Evaluate(Float fTime, Float fAlpha, Bool bBlendDiscreteState)
 {
+	SEOUL_ANIMATION2D_ASSERT_NOT_IN_POSE_BATCH(m_r);
+	SEOUL_ANIMATION2D_PROFILE("Animation2D.Evaluate", &m_r.GetData()->GetProfile(), ProfileCounter::kEvaluate);
+
+	// Deferred posing - drop a previous frame that was never applied.
+	m_r.DiscardUnappliedCache();
+
+	// Reduced rate sampling at lower levels of detail.
+	if (!m_r.IsLodEvaluationFrame())
+	{
+		return;
+	}
+
+	// Shared posing - quantize time and weight, so that instances
+	// in (near) lockstep produce identical samples, and record
+	// the sample so the pose can be identified by the Manager.
+	if (m_r.IsPoseShared())
+	{
+		auto const uFrame = (UInt32)(Max(fTime, 0.0f) * kfSharedPoseSampleRate + 0.5f);
+		auto const uAlpha = (UInt32)(Clamp(fAlpha, 0.0f, 1.0f) * kfSharedPoseAlphaSteps + 0.5f);
+		fTime = (Float)uFrame / kfSharedPoseSampleRate;
+		fAlpha = (Float)uAlpha / kfSharedPoseAlphaSteps;
+
+		auto& signature = m_r.GetCache().m_Signature;
+		signature.Add(m_pClip.GetPtr(), uFrame, (uAlpha << 1u) | (bBlendDiscreteState ? 1u : 0u));
+
+		// Deform buffers are per instance state and not part of a shared pose.
+		if (m_r.IsLodDeformEnabled() && !m_Tracks.m_vDeform.IsEmpty())
+		{
+			signature.Invalidate();
+		}
+	}
+
 	// Sanitize.
 	fTime = ToEditorTime(fTime);
 
-	for (auto i = m_vEvaluators.Begin(); m_vEvaluators.End() != i; ++i)
+	auto const& vCurves = GetCurveTables(*m_r.GetData());
+
+	// Bones first.
+	EvaluateRotation(m_r, vCurves, m_Tracks.m_vRotation, fTime, fAlpha);
+	EvaluateScale(m_r, vCurves, m_Tracks.m_vScale, fTime, fAlpha);
+	EvaluateShear(m_r, vCurves, m_Tracks.m_vShear, fTime, fAlpha);
+	EvaluateTranslation(m_r, vCurves, m_Tracks.m_vTranslation, fTime, fAlpha);
+
+	// Deforms are held at lower levels of detail.
+	if (m_r.IsLodDeformEnabled())
+	{
+		EvaluateDeforms(m_r, vCurves, m_Tracks.m_vDeform, fTime, fAlpha);
+	}
+
+	if (m_Tracks.m_DrawOrder.IsValid())
 	{
-		(*i)->Evaluate(fTime, fAlpha, bBlendDiscreteState);
+		EvaluateDrawOrder(m_r, m_Tracks, m_Tracks.m_DrawOrder, fTime);
+	}
+
+	EvaluateIk(m_r, vCurves, m_Tracks.m_vIk, fTime, fAlpha);
+	EvaluatePathMix(m_r, vCurves, m_Tracks.m_vPathMix, fTime, fAlpha);
+	EvaluatePathPosition(m_r, vCurves, m_Tracks.m_vPathPosition, fTime, fAlpha);
+	EvaluatePathSpacing(m_r, vCurves, m_Tracks.m_vPathSpacing, fTime, fAlpha);
+	EvaluateSlotAttachment(m_r, m_Tracks.m_vAttachment, fTime, fAlpha, bBlendDiscreteState);
+	EvaluateSlotColor(m_r, vCurves, m_Tracks.m_vColor, fTime, fAlpha);
+	EvaluateSlotTwoColor(m_r, vCurves, m_Tracks.m_vTwoColor, fTime, fAlpha);
+	EvaluateTransform(m_r, vCurves, m_Tracks.m_vTransform, fTime, fAlpha);
+
+	// Sleep detection - record the range over which the output of this
+	// clip is constant, so that DataInstance::ApplyCache() can skip
+	// applying and posing a state identical to that of the previous frame.
+	auto& hold = m_r.GetCache().m_Hold;
+	if (m_r.IsSleepEnabled() && hold.m_bValid)
+	{
+		// Partially weighted deforms blend against their previous
+		// value, so they converge over several frames.
+		Bool const bDeforms = m_r.IsLodDeformEnabled();
+		Float fBegin = 0.0f;
+		Float fEnd = FloatMax;
+		if ((!bDeforms || m_Tracks.m_vDeform.IsEmpty() || fAlpha >= 1.0f) &&
+			InternalGetHoldRange(fTime, bDeforms, fBegin, fEnd))
+		{
+			hold.Add(m_pClip.GetPtr(), fBegin, fAlpha, bBlendDiscreteState);
+		}
+		else
+		{
+			hold.Invalidate();
+		}
 	}
 }
 
-void ClipInstance::InternalConstructEvaluators()
+/**
+ * @return True if the output of this clip at any time >= fTime
+ * is identical to its output at fTime (e.g. fTime is at or
+ * after the last key frame of all timelines).
+ */
+Bool ClipInstance::IsTimeInvariant(Float fTime) const
 {
-	SafeDeleteVector(m_vEvaluators);
+	Float fBegin = 0.0f;
+	Float fEnd = FloatMax;
+	return
+		InternalGetHoldRange(ToEditorTime(fTime), m_r.IsLodDeformEnabled(), fBegin, fEnd) &&
+		FloatMax == fEnd;
+}
 
-	auto const& pData = m_r.GetData();
+/**
+ * Compute the range [rfBegin, rfEnd) around fTime over which the
+ * output of all timelines of this clip is constant. Returns false if
+ * any timeline is interpolating at fTime. Events do not contribute,
+ * since they are dispatched by EvaluateRange().
+ */
+Bool ClipInstance::InternalGetHoldRange(Float fTime, Bool bDeforms, Float& rfBegin, Float& rfEnd) const
+{
+	rfBegin = 0.0f;
+	rfEnd = FloatMax;
+
+	return
+		GetTracksHoldRange(m_Tracks.m_vRotation, fTime, rfBegin, rfEnd) &&
+		GetTracksHoldRange(m_Tracks.m_vScale, fTime, rfBegin, rfEnd) &&
+		GetTracksHoldRange(m_Tracks.m_vShear, fTime, rfBegin, rfEnd) &&
+		GetTracksHoldRange(m_Tracks.m_vTranslation, fTime, rfBegin, rfEnd) &&
+		(!bDeforms || GetTracksHoldRange(m_Tracks.m_vDeform, fTime, rfBegin, rfEnd)) &&
+		(!m_Tracks.m_DrawOrder.IsValid() || GetTrackHoldRange(m_Tracks.m_DrawOrder, fTime, rfBegin, rfEnd)) &&
+		GetTracksHoldRange(m_Tracks.m_vIk, fTime, rfBegin, rfEnd) &&
+		GetTracksHoldRange(m_Tracks.m_vPathMix, fTime, rfBegin, rfEnd) &&
+		GetTracksHoldRange(m_Tracks.m_vPathPosition, fTime, rfBegin, rfEnd) &&
+		GetTracksHoldRange(m_Tracks.m_vPathSpacing, fTime, rfBegin, rfEnd) &&
+		GetTracksHoldRange(m_Tracks.m_vAttachment, fTime, rfBegin, rfEnd) &&
+		GetTracksHoldRange(m_Tracks.m_vColor, fTime, rfBegin, rfEnd) &&
+		GetTracksHoldRange(m_Tracks.m_vTwoColor, fTime, rfBegin, rfEnd) &&
+		GetTracksHoldRange(m_Tracks.m_vTransform, fTime, rfBegin, rfEnd);
+}
+
+/**
+ * Resolve the timelines of clip against the targets of data. Timelines
+ * that target a bone that does not exist in data are skipped, which
+ * supports retargeting.
+ */
+void ClipBinding::Bind(const DataDefinition& data, const Clip& clip)
+{
+	Clear();
+	m_pData = &data;
 
 	// Bones first.
 	{
-		auto const& vCurves = m_r.GetData()->GetCurves();
-		auto const& t = m_pClip->GetBones();
-		m_vEvaluators.Reserve(m_vEvaluators.GetSize() + (t.GetSize() * 4u));
+		auto const& t = clip.GetBones();
+		m_vRotation.Reserve(t.GetSize());
+		m_vScale.Reserve(t.GetSize());
+		m_vShear.Reserve(t.GetSize());
+		m_vTranslation.Reserve(t.GetSize());
 
 		auto const iBegin = t.Begin();
 		auto const iEnd = t.End();
 		for (auto i = iBegin; iEnd != i; ++i)
 		{
 			auto const& entry = i->Second;
-			auto const iBone = pData->GetBoneIndex(i->First);
+			auto const iBone = data.GetBoneIndex(i->First);
 
 			// Skip entries if no bone is available. This supports retargeting.
 			if (iBone < 0)
@@ -1109,30 +1169,29 @@ void ClipInstance::InternalConstructEvaluators()
 			if (!entry.m_vRotation.IsEmpty())
 			{
 				m_fMaxTime = Max(m_fMaxTime, entry.m_vRotation.Back().m_fTime);
-				m_vEvaluators.PushBack(SEOUL_NEW(MemoryBudgets::Animation2D) RotationEvaluator(m_r, entry.m_vRotation, vCurves, iBone));
+				m_vRotation.PushBack(RotationTracks::ValueType(&entry.m_vRotation, iBone));
 			}
 			if (!entry.m_vScale.IsEmpty())
 			{
 				m_fMaxTime = Max(m_fMaxTime, entry.m_vScale.Back().m_fTime);
-				m_vEvaluators.PushBack(SEOUL_NEW(MemoryBudgets::Animation2D) ScaleEvaluator(m_r, entry.m_vScale, vCurves, iBone));
+				m_vScale.PushBack(ScaleTracks::ValueType(&entry.m_vScale, iBone));
 			}
 			if (!entry.m_vShear.IsEmpty())
 			{
 				m_fMaxTime = Max(m_fMaxTime, entry.m_vShear.Back().m_fTime);
-				m_vEvaluators.PushBack(SEOUL_NEW(MemoryBudgets::Animation2D) ShearEvaluator(m_r, entry.m_vShear, vCurves, iBone));
+				m_vShear.PushBack(ShearTracks::ValueType(&entry.m_vShear, iBone));
 			}
 			if (!entry.m_vTranslation.IsEmpty())
 			{
 				m_fMaxTime = Max(m_fMaxTime, entry.m_vTranslation.Back().m_fTime);
-				m_vEvaluators.PushBack(SEOUL_NEW(MemoryBudgets::Animation2D) TranslationEvaluator(m_r, entry.m_vTranslation, vCurves, iBone));
+				m_vTranslation.PushBack(TranslationTracks::ValueType(&entry.m_vTranslation, iBone));
 			}
 		}
 	}
 
 	// Now deforms.
 	{
-		auto const& vCurves = m_r.GetData()->GetCurves();
-		auto const& t0 = m_pClip->GetDeforms();
+		auto const& t0 = clip.GetDeforms();
 
 		auto const iBegin0 = t0.Begin();
 		auto const iEnd0 = t0.End();
@@ -1152,7 +1211,7 @@ void ClipInstance::InternalConstructEvaluators()
 					m_fMaxTime = Max(m_fMaxTime, v.Back().m_fTime);
 
 					auto const key = DeformKey(i0->First, i1->First, i2->First);
-					m_vEvaluators.PushBack(SEOUL_NEW(MemoryBudgets::Animation2D) DeformEvaluator(m_r, v, vCurves, key));
+					m_vDeform.PushBack(DeformTracks::ValueType(&v, key));
 				}
 			}
 		}
@@ -1160,126 +1219,157 @@ void ClipInstance::InternalConstructEvaluators()
 
 	// Draw order next.
 	{
-		auto const& v = m_pClip->GetDrawOrder();
+		auto const& v = clip.GetDrawOrder();
 		if (!v.IsEmpty())
 		{
 			m_fMaxTime = Max(m_fMaxTime, v.Back().m_fTime);
-			m_vEvaluators.PushBack(SEOUL_NEW(MemoryBudgets::Animation2D) DrawOrderEvaluator(m_r, v));
+			m_DrawOrder = DrawOrderTrack(&v);
+
+			// Resolve the slot of each offset, so draw order evaluation
+			// does not perform any name lookups.
+			m_vDrawOrderOffsets.Reserve(v.GetSize());
+			for (auto const& key : v)
+			{
+				m_vDrawOrderOffsets.PushBack(m_viDrawOrderSlots.GetSize());
+				for (auto const& offset : key.m_vOffsets)
+				{
+					m_viDrawOrderSlots.PushBack(data.GetSlotIndex(offset.m_Slot));
+				}
+			}
 		}
 	}
 
 	// Events next.
 	{
-		auto const& v = m_pClip->GetEvents();
+		auto const& v = clip.GetEvents();
 		if (!v.IsEmpty())
 		{
 			m_fMaxTime = Max(m_fMaxTime, v.Back().m_fTime);
-
-			auto pEventEvaluator(SEOUL_NEW(MemoryBudgets::Animation2D) EventEvaluator(v, m_Settings.m_fEventMixThreshold));
-			m_vEvaluators.PushBack(pEventEvaluator);
-			m_pEventEvaluator = pEventEvaluator;
+			m_Events = EventTrack(&v);
 		}
 	}
 
 	// Now ik.
 	{
-		auto const& vCurves = m_r.GetData()->GetCurves();
-		auto const& t = m_pClip->GetIk();
-		m_vEvaluators.Reserve(m_vEvaluators.GetSize() + t.GetSize());
+		auto const& t = clip.GetIk();
+		m_vIk.Reserve(t.GetSize());
 
 		auto const iBegin = t.Begin();
 		auto const iEnd = t.End();
 		for (auto i = iBegin; iEnd != i; ++i)
 		{
 			auto const& entry = i->Second;
-			auto const iIk = pData->GetIkIndex(i->First);
+			auto const iIk = data.GetIkIndex(i->First);
 
 			m_fMaxTime = Max(m_fMaxTime, entry.Back().m_fTime);
-			m_vEvaluators.PushBack(SEOUL_NEW(MemoryBudgets::Animation2D) IkEvaluator(m_r, entry, vCurves, iIk));
+			m_vIk.PushBack(IkTracks::ValueType(&entry, iIk));
 		}
 	}
 
 	// Now paths.
 	{
-		auto const& vCurves = m_r.GetData()->GetCurves();
-		auto const& t = m_pClip->GetPaths();
-		m_vEvaluators.Reserve(m_vEvaluators.GetSize() + (t.GetSize() * 4u));
+		auto const& t = clip.GetPaths();
+		m_vPathMix.Reserve(t.GetSize());
+		m_vPathPosition.Reserve(t.GetSize());
+		m_vPathSpacing.Reserve(t.GetSize());
 
 		auto const iBegin = t.Begin();
 		auto const iEnd = t.End();
 		for (auto i = iBegin; iEnd != i; ++i)
 		{
 			auto const& entry = i->Second;
-			auto const iPath = pData->GetPathIndex(i->First);
+			auto const iPath = data.GetPathIndex(i->First);
 
 			if (!entry.m_vMix.IsEmpty())
 			{
 				m_fMaxTime = Max(m_fMaxTime, entry.m_vMix.Back().m_fTime);
-				m_vEvaluators.PushBack(SEOUL_NEW(MemoryBudgets::Animation2D) PathMixEvaluator(m_r, entry.m_vMix, vCurves, iPath));
+				m_vPathMix.PushBack(PathMixTracks::ValueType(&entry.m_vMix, iPath));
 			}
 			if (!entry.m_vPosition.IsEmpty())
 			{
 				m_fMaxTime = Max(m_fMaxTime, entry.m_vPosition.Back().m_fTime);
-				m_vEvaluators.PushBack(SEOUL_NEW(MemoryBudgets::Animation2D) PathPositionEvaluator(m_r, entry.m_vPosition, vCurves, iPath));
+				m_vPathPosition.PushBack(PathPositionTracks::ValueType(&entry.m_vPosition, iPath));
 			}
 			if (!entry.m_vSpacing.IsEmpty())
 			{
 				m_fMaxTime = Max(m_fMaxTime, entry.m_vSpacing.Back().m_fTime);
-				m_vEvaluators.PushBack(SEOUL_NEW(MemoryBudgets::Animation2D) PathSpacingEvaluator(m_r, entry.m_vSpacing, vCurves, iPath));
+				m_vPathSpacing.PushBack(PathSpacingTracks::ValueType(&entry.m_vSpacing, iPath));
 			}
 		}
 	}
 
 	// Now slots.
 	{
-		auto const& vCurves = m_r.GetData()->GetCurves();
-		auto const& t = m_pClip->GetSlots();
-		m_vEvaluators.Reserve(m_vEvaluators.GetSize() + (t.GetSize() * 4u));
+		auto const& t = clip.GetSlots();
+		m_vAttachment.Reserve(t.GetSize());
+		m_vColor.Reserve(t.GetSize());
+		m_vTwoColor.Reserve(t.GetSize());
 
 		auto const iBegin = t.Begin();
 		auto const iEnd = t.End();
 		for (auto i = iBegin; iEnd != i; ++i)
 		{
 			auto const& entry = i->Second;
-			auto const iSlot = pData->GetSlotIndex(i->First);
+			auto const iSlot = data.GetSlotIndex(i->First);
 
 			if (!entry.m_vAttachment.IsEmpty())
 			{
 				m_fMaxTime = Max(m_fMaxTime, entry.m_vAttachment.Back().m_fTime);
-				m_vEvaluators.PushBack(SEOUL_NEW(MemoryBudgets::Animation2D) SlotAttachmentEvaluator(m_r, entry.m_vAttachment, iSlot));
+				m_vAttachment.PushBack(AttachmentTracks::ValueType(&entry.m_vAttachment, iSlot));
 			}
 			if (!entry.m_vColor.IsEmpty())
 			{
 				m_fMaxTime = Max(m_fMaxTime, entry.m_vColor.Back().m_fTime);
-				m_vEvaluators.PushBack(SEOUL_NEW(MemoryBudgets::Animation2D) SlotColorEvaluator(m_r, entry.m_vColor, vCurves, iSlot));
+				m_vColor.PushBack(ColorTracks::ValueType(&entry.m_vColor, iSlot));
 			}
 			if (!entry.m_vTwoColor.IsEmpty())
 			{
 				m_fMaxTime = Max(m_fMaxTime, entry.m_vTwoColor.Back().m_fTime);
-				m_vEvaluators.PushBack(SEOUL_NEW(MemoryBudgets::Animation2D) SlotTwoColorEvaluator(m_r, entry.m_vTwoColor, vCurves, iSlot));
+				m_vTwoColor.PushBack(TwoColorTracks::ValueType(&entry.m_vTwoColor, iSlot));
 			}
 		}
 	}
 
 	// Finally, transforms.
 	{
-		auto const& vCurves = m_r.GetData()->GetCurves();
-		auto const& t = m_pClip->GetTransforms();
-		m_vEvaluators.Reserve(m_vEvaluators.GetSize() + t.GetSize());
+		auto const& t = clip.GetTransforms();
+		m_vTransform.Reserve(t.GetSize());
 
 		auto const iBegin = t.Begin();
 		auto const iEnd = t.End();
 		for (auto i = iBegin; iEnd != i; ++i)
 		{
 			auto const& v = i->Second;
-			auto const iTransform = pData->GetTransformIndex(i->First);
+			auto const iTransform = data.GetTransformIndex(i->First);
 
 			m_fMaxTime = Max(m_fMaxTime, v.Back().m_fTime);
-			m_vEvaluators.PushBack(SEOUL_NEW(MemoryBudgets::Animation2D) TransformEvaluator(m_r, v, vCurves, iTransform));
+			m_vTransform.PushBack(TransformTracks::ValueType(&v, iTransform));
 		}
 	}
 }
 
+void ClipInstance::InternalConstructTracks()
+{
+	// Common case, copy the binding that was resolved when the clip
+	// was loaded. Otherwise (the clip belongs to a different
+	// DataDefinition), resolve it now.
+	auto const& pData = m_r.GetData();
+	auto const& binding = m_pClip->GetBinding();
+	if (binding.m_pData == pData.GetPtr())
+	{
+		m_Tracks = binding;
+	}
+	else
+	{
+		m_Tracks.Bind(*pData, *m_pClip);
+	}
+
+	for (auto const& t : m_Tracks.m_vDeform)
+	{
+		AcquireDeform(m_r, t.m_Target);
+	}
+}
+
 } // namespace Seoul::Animation2D
 
 #endif // /#if SEOUL_WITH_ANIMATION_2D
@@ -11,28 +11,125 @@
 #define ANIMATION2D_CLIP_INSTANCE_H
 
 #include "AnimationClipSettings.h"
-#include "CheckedPtr.h"
+#include "Animation2DClipDefinition.h"
+#include "Animation2DDataInstance.h"
 #include "Prereqs.h"
 #include "SharedPtr.h"
 #include "Vector.h"
-namespace Seoul { namespace Animation2D { class Clip; } }
-namespace Seoul { namespace Animation2D { class IEvaluator; } }
-namespace Seoul { namespace Animation2D { class DataInstance; } }
-namespace Seoul { namespace Animation2D { class EventEvaluator; } }
+namespace Seoul { namespace Animation2D { class DataDefinition; } }
 
 #if SEOUL_WITH_ANIMATION_2D
 
 namespace Seoul::Animation2D
 {
 
+/**
+ * A single timeline of a ClipInstance - its keyframes, the
+ * target it animates (bone, slot, constraint, etc.) and
+ * the keyframe search cursor of the timeline.
+ */
+template <typename T, typename TARGET = Int16>
+struct ClipTrack SEOUL_SEALED
+{
+	ClipTrack(T const* pKeyFrames = nullptr, const TARGET& target = TARGET())
+		: m_pKeyFrames(pKeyFrames)
+		, m_uLastKeyFrame(0u)
+		, m_Target(target)
+	{
+	}
+
+	Bool IsValid() const { return (nullptr != m_pKeyFrames); }
+
+	T const* m_pKeyFrames;
+	UInt32 m_uLastKeyFrame;
+	TARGET m_Target;
+}; // struct ClipTrack
+
+/**
+ * The timelines of a Clip, resolved against the targets (bones,
+ * slots, constraints) of a DataDefinition and grouped by type. Built
+ * once per Clip when its DataDefinition is loaded (see Clip::Bind()),
+ * so that instantiating a ClipInstance is a copy of prebuilt
+ * tables, with no name lookups.
+ */
+struct ClipBinding SEOUL_SEALED
+{
+	typedef Vector<ClipTrack<KeyFramesAttachment>, MemoryBudgets::Animation2D> AttachmentTracks;
+	typedef Vector<ClipTrack<KeyFramesColor>, MemoryBudgets::Animation2D> ColorTracks;
+	typedef Vector<ClipTrack<KeyFramesDeform, DeformKey>, MemoryBudgets::Animation2D> DeformTracks;
+	typedef Vector<UInt32, MemoryBudgets::Animation2D> DrawOrderOffsets;
+	typedef Vector<Int16, MemoryBudgets::Animation2D> DrawOrderSlots;
+	typedef ClipTrack<KeyFramesDrawOrder> DrawOrderTrack;
+	typedef ClipTrack<KeyFramesEvent> EventTrack;
+	typedef Vector<ClipTrack<KeyFramesIk>, MemoryBudgets::Animation2D> IkTracks;
+	typedef Vector<ClipTrack<KeyFramesPathMix>, MemoryBudgets::Animation2D> PathMixTracks;
+	typedef Vector<ClipTrack<KeyFramesPathPosition>, MemoryBudgets::Animation2D> PathPositionTracks;
+	typedef Vector<ClipTrack<KeyFramesPathSpacing>, MemoryBudgets::Animation2D> PathSpacingTracks;
+	typedef Vector<ClipTrack<KeyFramesRotation>, MemoryBudgets::Animation2D> RotationTracks;
+	typedef Vector<ClipTrack<KeyFramesScale>, MemoryBudgets::Animation2D> ScaleTracks;
+	typedef Vector<ClipTrack<KeyFrames2D>, MemoryBudgets::Animation2D> ShearTracks;
+	typedef Vector<ClipTrack<KeyFramesTransform>, MemoryBudgets::Animation2D> TransformTracks;
+	typedef Vector<ClipTrack<KeyFrames2D>, MemoryBudgets::Animation2D> TranslationTracks;
+	typedef Vector<ClipTrack<KeyFramesTwoColor>, MemoryBudgets::Animation2D> TwoColorTracks;
+
+	ClipBinding();
+
+	void Bind(const DataDefinition& data, const Clip& clip);
+	void Clear();
+	UInt32 GetTrackCount() const;
+
+	// Heap memory owned by this binding, in bytes.
+	UInt32 GetHeapSize() const;
+
+	// The definition the binding was resolved against.
+	DataDefinition const* m_pData;
+	Float m_fMaxTime;
+
+	// Timelines, grouped by type so that each type is
+	// evaluated by a single loop over contiguous memory.
+	RotationTracks m_vRotation;
+	ScaleTracks m_vScale;
+	ShearTracks m_vShear;
+	TranslationTracks m_vTranslation;
+	DeformTracks m_vDeform;
+	DrawOrderTrack m_DrawOrder;
+	EventTrack m_Events;
+	IkTracks m_vIk;
+	PathMixTracks m_vPathMix;
+	PathPositionTracks m_vPathPosition;
+	PathSpacingTracks m_vPathSpacing;
+	AttachmentTracks m_vAttachment;
+	ColorTracks m_vColor;
+	TwoColorTracks m_vTwoColor;
+	TransformTracks m_vTransform;
+
+	// Resolved slot index of each offset of each draw order keyframe,
+	// flattened. m_vDrawOrderOffsets[u] is the index of the first slot
+	// of keyframe u in m_viDrawOrderSlots.
+	DrawOrderOffsets m_vDrawOrderOffsets;
+	DrawOrderSlots m_viDrawOrderSlots;
+}; // struct ClipBinding
+
 class ClipInstance SEOUL_SEALED
 {
 public:
 	ClipInstance(DataInstance& r, const SharedPtr<Clip>& pClip, const Animation::ClipSettings& settings);
 	~ClipInstance();
 
-	// The number of active animation evaluators in this clip.
-	UInt32 GetActiveEvaluatorCount() const { return m_vEvaluators.GetSize(); }
+	// Release the clip and all timelines of this instance. Track storage is retained.
+	void Clear();
+
+	// Rebind this instance to pClip, reusing existing track storage.
+	void Reset(const SharedPtr<Clip>& pClip, const Animation::ClipSettings& settings);
+
+	// The DataInstance to which this ClipInstance applies.
+	DataInstance& GetInstance() const { return m_r; }
+
+	// Total memory footprint of this instance, in bytes.
+	UInt32 GetMemoryUsage() const { return (UInt32)sizeof(*this) + m_Tracks.GetHeapSize(); }
+
+	// The number of active animation timelines in this clip.
+	UInt32 GetActiveEvaluatorCount() const { return m_Tracks.GetTrackCount(); }
 
 	// Used for event dispatch, pass a time range. Looping should be implemented
 	// by passing all time ranges (where fPrevTime >= 0.0f and fTime <= GetMaxTime())
@@ -42,24 +139,24 @@ public:
 	// Apply the clip to the state of DataInstance.
 	void Evaluate(Float fTime, Float fAlpha, Bool bBlendDiscreteState);
 
+	// True if the output of this clip is the same at all times >= fTime.
+	Bool IsTimeInvariant(Float fTime) const;
+
 	/** @return The max time (in seconds) of all timelines in this animation clip. */
-	Float GetMaxTime() const { return m_fMaxTime; }
+	Float GetMaxTime() const { return m_Tracks.m_fMaxTime; }
 
 	// returns true if the animation event was found after the current animation time, and sets the event time
 	// returns false if the animation event was not found
 	Bool GetNextEventTime(HString sEventName, Float fStartTime, Float& fEventTime) const;
 
 private:
-	const Animation::ClipSettings m_Settings;
+	Animation::ClipSettings m_Settings;
 	DataInstance& m_r;
 	SharedPtr<Clip> m_pClip;
-	Float m_fMaxTime;
-
-	typedef Vector<CheckedPtr<IEvaluator>, MemoryBudgets::Animation2D> Evaluators;
-	Evaluators m_vEvaluators;
-	CheckedPtr<EventEvaluator> m_pEventEvaluator;
+	ClipBinding m_Tracks;
 
-	void InternalConstructEvaluators();
+	void InternalConstructTracks();
+	Bool InternalGetHoldRange(Float fTime, Bool bDeforms, Float& rfBegin, Float& rfEnd) const;
 
 	SEOUL_DISABLE_COPY(ClipInstance);
 }; // class ClipInstance
@@ -7,6 +7,7 @@
  */
 
 #include "Animation2DContentLoader.h"
+#include "Animation2DProfile.h"
 #include "Animation2DReadWriteUtil.h"
 #include "Compress.h"
 #include "CookManager.h"
@@ -84,14 +85,21 @@ Content::LoadState DataContentLoader::InternalExecuteContentLoadOp()
 
 		UInt32 const zMaxReadSize = kDefaultMaxReadSize;
 
+		Bool bRead = false;
+		{
+			// No definition exists yet, so read time is only tracked globally.
+			SEOUL_ANIMATION2D_PROFILE("Animation2D.LoadRead", nullptr, ProfileCounter::kLoadRead);
+			bRead = FileManager::Get()->ReadAll(
+				GetFilePath(),
+				m_pRawData,
+				m_uDataSizeInBytes,
+				kLZ4MinimumAlignment,
+				MemoryBudgets::Content,
+				zMaxReadSize);
+		}
+
 		// If reading succeeds, continue on a worker thread.
-		if (FileManager::Get()->ReadAll(
-			GetFilePath(),
-			m_pRawData,
-			m_uDataSizeInBytes,
-			kLZ4MinimumAlignment,
-			MemoryBudgets::Content,
-			zMaxReadSize))
+		if (bRead)
 		{
 			// Finish the load on a worker thread.
 			return Content::LoadState::kLoadingOnWorkerThread;
@@ -103,15 +111,22 @@ Content::LoadState DataContentLoader::InternalExecuteContentLoadOp()
 		void* pUncompressedFileData = nullptr;
 		UInt32 uUncompressedFileDataInBytes = 0u;
 
-		// Deobfuscate.
-		Animation2D::Obfuscate((Byte*)m_pRawData, m_uDataSizeInBytes, GetFilePath());
+		Bool bDecompressed = false;
+		{
+			SEOUL_ANIMATION2D_PROFILE("Animation2D.LoadDecompress", nullptr, ProfileCounter::kLoadDecompress);
+
+			// Deobfuscate.
+			Animation2D::Obfuscate((Byte*)m_pRawData, m_uDataSizeInBytes, GetFilePath());
 
-		if (ZSTDDecompress(
-			m_pRawData,
-			m_uDataSizeInBytes,
-			pUncompressedFileData,
-			uUncompressedFileDataInBytes,
-			MemoryBudgets::Content))
+			bDecompressed = ZSTDDecompress(
+				m_pRawData,
+				m_uDataSizeInBytes,
+				pUncompressedFileData,
+				uUncompressedFileDataInBytes,
+				MemoryBudgets::Content);
+		}
+
+		if (bDecompressed)
 		{
 			InternalFreeData();
 
@@ -120,10 +135,18 @@ Content::LoadState DataContentLoader::InternalExecuteContentLoadOp()
 			StreamBuffer buffer;
 			buffer.TakeOwnership((Byte*)pUncompressedFileData, uUncompressedFileDataInBytes);
 			Animation2D::ReadWriteUtil util(buffer, keCurrentPlatform);
-			auto const bSuccess = util.BeginRead() && pData->Load(util);
+			Bool bSuccess = false;
+			{
+				SEOUL_ANIMATION2D_PROFILE("Animation2D.LoadDeserialize", &pData->GetProfile(), ProfileCounter::kLoadDeserialize);
+				bSuccess = util.BeginRead() && pData->Load(util);
+			}
 
 			if (bSuccess)
 			{
+				{
+					SEOUL_ANIMATION2D_PROFILE("Animation2D.LoadSetupPose", &pData->GetProfile(), ProfileCounter::kLoadSetupPose);
+					DataDefinition::ComputeSetupPose(pData);
+				}
 				m_hEntry.GetContentEntry()->AtomicReplace(pData);
 				InternalReleaseEntry();
 
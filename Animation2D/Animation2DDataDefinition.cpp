@@ -8,10 +8,19 @@
  * Copyright (c) 2016-2022 Demiurge Studios Inc. All rights reserved.
  */
 
+#include "AnimationClipSettings.h"
+#include "AnimationEventInterface.h"
+#include "Animation2DBakedClip.h"
+#include "Animation2DClipInstance.h"
 #include "Animation2DContentLoader.h"
 #include "Animation2DDataDefinition.h"
+#include "Animation2DDataInstance.h"
+#include "Animation2DMemoryUsage.h"
 #include "Animation2DReadWriteUtil.h"
+#include "Animation2DSkinning.h"
+#include "Compress.h"
 #include "ContentLoadManager.h"
+#include "JobsJob.h"
 #include "Logger.h"
 #include "Path.h"
 #include "ReflectionCoreTemplateTypes.h"
@@ -105,6 +114,9 @@ SEOUL_BEGIN_TYPE(Animation2D::MetaData)
 	SEOUL_PROPERTY_N("fps", m_fFPS)
 	SEOUL_PROPERTY_N("height", m_fHeight)
 	SEOUL_PROPERTY_N("width", m_fWidth)
+	SEOUL_PROPERTY_N("seoulBakeFps", m_fBakeSampleRate)
+	SEOUL_PROPERTY_N("seoulBakeClips", m_vBakeClips)
+	SEOUL_PROPERTY_N("seoulQuantizeTolerance", m_fQuantizeTolerance)
 SEOUL_END_TYPE()
 
 SEOUL_BEGIN_ENUM(Animation2D::PathPositionMode)
@@ -176,7 +188,11 @@ DataDefinition::DataDefinition(FilePath filePath)
 	: m_FilePath(filePath)
 	, m_vBones()
 	, m_tBones()
+	, m_tBakedClips()
+	, m_tClipBounds()
 	, m_tClips()
+	, m_tClipChunks()
+	, m_ClipMutex()
 	, m_vCurves()
 	, m_tEvents()
 	, m_vIk()
@@ -190,6 +206,18 @@ DataDefinition::DataDefinition(FilePath filePath)
 	, m_tSlots()
 	, m_vTransforms()
 	, m_tTransforms()
+	, m_tCurveLookup()
+	, m_aLodPoseTasks()
+	, m_vPoseBoneRuns()
+	, m_viPoseBoneRunBones()
+	, m_pSetupPose()
+	, m_Bounds()
+#if SEOUL_ANIMATION2D_UNIFORM_CURVES
+	, m_vUniformCurves()
+#endif // /#if SEOUL_ANIMATION2D_UNIFORM_CURVES
+#if SEOUL_ANIMATION2D_PROFILING
+	, m_Profile()
+#endif // /#if SEOUL_ANIMATION2D_PROFILING
 {
 }
 
@@ -197,6 +225,42 @@ DataDefinition::~DataDefinition()
 {
 }
 
+static inline UInt32 GetCurveHash(const BezierCurve& curve)
+{
+	UInt32 uReturn = 0u;
+	for (UInt32 i = 0u; i < curve.GetSize(); ++i)
+	{
+		UInt32 u = 0u;
+		memcpy(&u, curve.Data() + i, sizeof(u));
+		IncrementalHash(uReturn, u);
+	}
+	return uReturn;
+}
+
+/**
+ * @return The offset of curve in the curve table. Keys that share
+ * easing (common, e.g. all keys of a timeline authored with the same
+ * ease preset) share a single curve entry.
+ */
+UInt32 DataDefinition::AddCurve(const BezierCurve& curve)
+{
+	auto const uHash = GetCurveHash(curve);
+
+	UInt32 uOffset = 0u;
+	if (m_tCurveLookup.GetValue(uHash, uOffset) &&
+		0 == memcmp(m_vCurves[uOffset].Data(), curve.Data(), curve.GetSizeInBytes()))
+	{
+		return uOffset;
+	}
+
+	// On a hash collision, the curve is just added without an entry
+	// in the lookup.
+	uOffset = m_vCurves.GetSize();
+	m_vCurves.PushBack(curve);
+	(void)m_tCurveLookup.Insert(uHash, uOffset);
+	return uOffset;
+}
+
 Bool DataDefinition::DeserializeSkin(Reflection::SerializeContext* pContext, DataStore const* pDataStore, const DataNode& value)
 {
 	// Newer format - skin is an array instead of a table, due to additional constraints per skin.
@@ -626,6 +690,219 @@ Bool DataDefinition::FinalizePoseTasks()
 	return true;
 }
 
+/**
+ * Resolve the timelines of all clips against this definition,
+ * see Clip::Bind().
+ */
+void DataDefinition::BindClips()
+{
+	auto const iBegin = m_tClips.Begin();
+	auto const iEnd = m_tClips.End();
+	for (auto i = iBegin; iEnd != i; ++i)
+	{
+		if (i->Second.IsValid())
+		{
+			i->Second->Bind(*this);
+		}
+	}
+}
+
+/** Runtime only - union of the cooked bounds of all clips. */
+void DataDefinition::ComputeBounds()
+{
+	m_Bounds = ClipBounds();
+	for (auto const& e : m_tClipBounds)
+	{
+		m_Bounds.Absorb(e.Second);
+	}
+}
+
+/**
+ * Capture the setup pose of p (the state of a newly constructed
+ * and posed DataInstance), so that later DataInstances of p are
+ * constructed by copying it.
+ */
+void DataDefinition::ComputeSetupPose(const SharedPtr<DataDefinition>& p)
+{
+	ScopedPtr<DataInstanceSetupPose> pSetupPose(SEOUL_NEW(MemoryBudgets::Animation2D) DataInstanceSetupPose);
+	{
+		// No setup pose yet, so this instance is constructed
+		// and posed from the definition directly.
+		p->m_pSetupPose.Reset();
+		DataInstance instance(SharedPtr<DataDefinition const>(p.GetPtr()), SharedPtr<Animation::EventInterface>());
+		instance.Pose();
+
+		instance.CapturePose(*pSetupPose);
+	}
+
+	p->m_pSetupPose.Swap(pSetupPose);
+}
+
+/**
+ * In builds with SEOUL_ANIMATION2D_UNIFORM_CURVES, resample each
+ * curve into a uniform lookup table for evaluation. Nop otherwise.
+ */
+void DataDefinition::ComputeUniformCurves()
+{
+#if SEOUL_ANIMATION2D_UNIFORM_CURVES
+	UInt32 const uCurves = m_vCurves.GetSize();
+	m_vUniformCurves.Resize(uCurves);
+	for (UInt32 i = 0u; i < uCurves; ++i)
+	{
+		ResampleCurve(m_vCurves[i], m_vUniformCurves[i]);
+	}
+#endif // /#if SEOUL_ANIMATION2D_UNIFORM_CURVES
+}
+
+/**
+ * Cook time only - derive a variant of the pose task list for each
+ * level of detail from the full pose task list. See LodLevel. The
+ * variants are serialized, so they are not recomputed on load.
+ */
+void DataDefinition::ComputeLodPoseTasks()
+{
+	m_vPoseBoneRuns.Clear();
+	m_viPoseBoneRunBones.Clear();
+
+	for (UInt32 uLod = 0u; uLod < kuLodLevels; ++uLod)
+	{
+		auto const eLod = (LodLevel)uLod;
+		auto& rv = m_aLodPoseTasks[uLod];
+		rv.Clear();
+		rv.Reserve(m_vPoseTasks.GetSize());
+
+		for (auto const& task : m_vPoseTasks)
+		{
+			switch ((PoseTaskType)task.m_iType)
+			{
+			case PoseTaskType::kIk:
+				if (eLod >= LodLevel::kMinimal)
+				{
+					// Bones controlled by the Ik take their FK pose instead. The
+					// first bone is always posed prior to the Ik (see FinalizePoseTasks()),
+					// the child bone must be posed explicitly in place of the Ik.
+					auto const& vi = m_vIk[task.m_iIndex].m_viBones;
+					for (UInt32 i = 1u; i < vi.GetSize(); ++i)
+					{
+						rv.PushBack(PoseTask(PoseTaskType::kBone, vi[i]));
+					}
+					continue;
+				}
+				break;
+
+			case PoseTaskType::kPath: // fall-through
+			case PoseTaskType::kTransform:
+				// Constrained bones are posed prior to the constraint, so the
+				// constraint can just be skipped.
+				if (eLod >= LodLevel::kReduced)
+				{
+					continue;
+				}
+				break;
+
+			default:
+				break;
+			};
+
+			rv.PushBack(task);
+		}
+
+		// Merge plain bone tasks into runs.
+		ComputePoseBoneRuns(rv);
+	}
+}
+
+/** Runs smaller than this are left as individual kBone tasks. */
+static const UInt32 kuMinPoseBoneRun = 4u;
+
+/**
+ * Replace segments of consecutive kBone tasks (of bones with
+ * TransformMode::kNormal) in rv with kBoneRun tasks. Each segment
+ * is split by hierarchy depth (relative to the segment) - a bone's
+ * parent is either posed before the segment or at a shallower depth,
+ * so all bones of a run are independent of each other.
+ */
+void DataDefinition::ComputePoseBoneRuns(PoseTasks& rv)
+{
+	PoseTasks vOut;
+	vOut.Reserve(rv.GetSize());
+
+	// Depth of each bone in the current segment, or -1 if not in the segment.
+	Vector<Int32, MemoryBudgets::Animation2D> viDepth;
+	viDepth.Resize(m_vBones.GetSize(), -1);
+	Vector<Int16, MemoryBudgets::Animation2D> viSegment;
+
+	auto const flush = [&]()
+	{
+		Int32 iMaxDepth = -1;
+		for (auto const i : viSegment)
+		{
+			iMaxDepth = Max(iMaxDepth, viDepth[i]);
+		}
+
+		// Emit one run per depth level, shallowest first.
+		for (Int32 iDepth = 0; iDepth <= iMaxDepth; ++iDepth)
+		{
+			UInt32 const uOffset = m_viPoseBoneRunBones.GetSize();
+			for (auto const i : viSegment)
+			{
+				if (viDepth[i] == iDepth)
+				{
+					m_viPoseBoneRunBones.PushBack(i);
+				}
+			}
+
+			UInt32 const uCount = (m_viPoseBoneRunBones.GetSize() - uOffset);
+			if (uCount < kuMinPoseBoneRun)
+			{
+				for (UInt32 u = uOffset; u < uOffset + uCount; ++u)
+				{
+					vOut.PushBack(PoseTask(PoseTaskType::kBone, m_viPoseBoneRunBones[u]));
+				}
+				m_viPoseBoneRunBones.Resize(uOffset);
+			}
+			else
+			{
+				vOut.PushBack(PoseTask(PoseTaskType::kBoneRun, (Int32)m_vPoseBoneRuns.GetSize()));
+				m_vPoseBoneRuns.PushBack(PoseBoneRun(uOffset, uCount));
+			}
+		}
+
+		for (auto const i : viSegment)
+		{
+			viDepth[i] = -1;
+		}
+		viSegment.Clear();
+	};
+
+	for (auto const& task : rv)
+	{
+		Bool const bCandidate = (
+			PoseTaskType::kBone == (PoseTaskType)task.m_iType &&
+			TransformMode::kNormal == m_vBones[task.m_iIndex].m_eTransformMode);
+
+		if (bCandidate)
+		{
+			// A bone that is evaluated twice starts a new segment.
+			if (viDepth[task.m_iIndex] >= 0)
+			{
+				flush();
+			}
+
+			auto const iParent = m_vBones[task.m_iIndex].m_iParent;
+			viDepth[task.m_iIndex] = (iParent >= 0 && viDepth[iParent] >= 0 ? viDepth[iParent] + 1 : 0);
+			viSegment.PushBack(task.m_iIndex);
+			continue;
+		}
+
+		flush();
+		vOut.PushBack(task);
+	}
+	flush();
+
+	rv.Swap(vOut);
+}
+
 Bool DataDefinition::FinalizeSkins()
 {
 	// Enumerate all skins, all slots, all attachments
@@ -706,9 +983,21 @@ Bool DataDefinition::FinalizeSkins()
 					break;
 				case AttachmentType::kMesh:
 					{
-						// Generate the edge list for the mesh.
+						// Generate the edge list and skinning layout for the mesh.
 						SharedPtr<MeshAttachment> pMesh((MeshAttachment*)p.GetPtr());
 						pMesh->ComputeEdges();
+						pMesh->ComputeSkinningLayout();
+
+						// Malformed weights, the mesh could never be skinned.
+						if (!pMesh->GetBoneCounts().IsEmpty() && pMesh->GetSkinningLayout().IsEmpty())
+						{
+							SEOUL_WARN("Mesh '%s' in skin '%s' and slot '%s' has bone weights "
+								"that do not match its vertices.",
+								iAttachment->First.CStr(),
+								iSkin->First.CStr(),
+								iSlot->First.CStr());
+							return false;
+						}
 					}
 					break;
 				case AttachmentType::kPath:
@@ -779,11 +1068,310 @@ Bool DataDefinition::FinalizeTransforms()
 	return true;
 }
 
+/**
+ * Compress the fully written (see ReadWriteUtil::EndWrite()) contents
+ * of buffer into a self-contained chunk. Each chunk carries its own
+ * string tables, so that it can be loaded independently of the rest
+ * of the definition.
+ */
+static Bool CompressChunk(const StreamBuffer& buffer, DataDefinition::Chunk& rv)
+{
+	void* pCompressed = nullptr;
+	UInt32 uCompressed = 0u;
+	if (!ZSTDCompress(
+		buffer.GetBuffer(),
+		buffer.GetTotalDataSizeInBytes(),
+		pCompressed,
+		uCompressed))
+	{
+		return false;
+	}
+
+	rv.Resize(uCompressed);
+	if (uCompressed > 0u)
+	{
+		memcpy(rv.Data(), pCompressed, uCompressed);
+	}
+	MemoryManager::Deallocate(pCompressed);
+	return true;
+}
+
+/** Inverse of CompressChunk(). rBuffer is ready for ReadWriteUtil::BeginRead(). */
+static Bool DecompressChunk(const DataDefinition::Chunk& v, StreamBuffer& rBuffer)
+{
+	void* pData = nullptr;
+	UInt32 uData = 0u;
+	if (v.IsEmpty() || !ZSTDDecompress(
+		v.Data(),
+		v.GetSize(),
+		pData,
+		uData,
+		MemoryBudgets::Animation2D))
+	{
+		return false;
+	}
+
+	rBuffer.TakeOwnership((Byte*)pData, uData);
+	return true;
+}
+
+static Bool CompressClip(Platform ePlatform, Float32 fQuantizeTolerance, const Clip& clip, DataDefinition::Chunk& rv)
+{
+	StreamBuffer buffer;
+	ReadWriteUtil util(buffer, ePlatform);
+	util.SetQuantizeTolerance(fQuantizeTolerance);
+	return clip.Save(util) && util.EndWrite() && CompressChunk(buffer, rv);
+}
+
+static Bool DecompressClip(const DataDefinition::Chunk& v, SharedPtr<Clip>& rp)
+{
+	StreamBuffer buffer;
+	if (!DecompressChunk(v, buffer))
+	{
+		return false;
+	}
+
+	ReadWriteUtil util(buffer, keCurrentPlatform);
+	SharedPtr<Clip> p(SEOUL_NEW(MemoryBudgets::Animation2D) Clip);
+	if (!util.BeginRead() || !p->Load(util))
+	{
+		return false;
+	}
+
+	rp.Swap(p);
+	return true;
+}
+
+static Bool CompressSkin(Platform ePlatform, const DataDefinition::Attachments& t, DataDefinition::Chunk& rv)
+{
+	StreamBuffer buffer;
+	ReadWriteUtil util(buffer, ePlatform);
+	return util.Write(t) && util.EndWrite() && CompressChunk(buffer, rv);
+}
+
+static Bool DecompressSkin(const DataDefinition::Chunk& v, DataDefinition::Attachments& rt)
+{
+	StreamBuffer buffer;
+	if (!DecompressChunk(v, buffer))
+	{
+		return false;
+	}
+
+	ReadWriteUtil util(buffer, keCurrentPlatform);
+	return util.BeginRead() && util.Read(rt);
+}
+
+namespace
+{
+
+/** Job used to decompress and deserialize a single skin on a worker thread. */
+class SkinLoadJob SEOUL_SEALED : public Jobs::Job
+{
+public:
+	SkinLoadJob(HString id, const DataDefinition::Chunk& v)
+		: m_Id(id)
+		, m_v(v)
+		, m_tAttachments()
+		, m_bSuccess(false)
+	{
+	}
+
+	~SkinLoadJob()
+	{
+		WaitUntilJobIsNotRunning();
+	}
+
+	HString GetId() const { return m_Id; }
+	DataDefinition::Attachments& GetAttachments() { return m_tAttachments; }
+	Bool GetSuccess() const { return m_bSuccess; }
+
+private:
+	SEOUL_DISABLE_COPY(SkinLoadJob);
+	SEOUL_REFERENCE_COUNTED_SUBCLASS(SkinLoadJob);
+
+	HString const m_Id;
+	const DataDefinition::Chunk& m_v;
+	DataDefinition::Attachments m_tAttachments;
+	Bool m_bSuccess;
+
+	virtual void InternalExecuteJob(Jobs::State& reNextState, ThreadId& rNextThreadId) SEOUL_OVERRIDE
+	{
+		m_bSuccess = DecompressSkin(m_v, m_tAttachments);
+		reNextState = Jobs::State::kComplete;
+	}
+}; // class SkinLoadJob
+
+} // namespace anonymous
+
+/**
+ * Decompress and deserialize each skin chunk of tChunks into rtSkins.
+ * Skins are independent of each other until linked mesh parents
+ * are resolved, so each skin is decoded on its own job.
+ */
+static Bool LoadSkins(const DataDefinition::Chunks& tChunks, DataDefinition::Skins& rtSkins)
+{
+	rtSkins.Clear();
+
+	// A single skin is decoded inline.
+	if (tChunks.GetSize() <= 1u)
+	{
+		for (auto const& e : tChunks)
+		{
+			DataDefinition::Attachments t;
+			if (!DecompressSkin(e.Second, t)) { return false; }
+			if (!rtSkins.Insert(e.First, t).Second) { return false; }
+		}
+
+		return true;
+	}
+
+	Vector<SharedPtr<SkinLoadJob>, MemoryBudgets::Animation2D> vJobs;
+	vJobs.Reserve(tChunks.GetSize());
+	for (auto const& e : tChunks)
+	{
+		SharedPtr<SkinLoadJob> pJob(SEOUL_NEW(MemoryBudgets::Animation2D) SkinLoadJob(e.First, e.Second));
+		pJob->StartJob();
+		vJobs.PushBack(pJob);
+	}
+
+	// Wait for all jobs prior to handling failure, since
+	// jobs reference tChunks.
+	for (auto const& pJob : vJobs)
+	{
+		pJob->WaitUntilJobIsNotRunning();
+	}
+
+	rtSkins.Reserve(vJobs.GetSize());
+	for (auto const& pJob : vJobs)
+	{
+		if (!pJob->GetSuccess()) { return false; }
+
+		DataDefinition::Attachments t;
+		t.Swap(pJob->GetAttachments());
+		if (!rtSkins.Insert(pJob->GetId(), t).Second) { return false; }
+	}
+
+	return true;
+}
+
+/**
+ * @return The clip id, or an invalid pointer if no such clip exists.
+ *
+ * Clips of a definition loaded from its cooked binary are kept
+ * compressed until first requested. The first call for a given
+ * clip decompresses and binds it, subsequent calls return the
+ * resident clip until it is released by EvictUnusedClips().
+ */
+SharedPtr<Clip> DataDefinition::GetClip(HString id) const
+{
+	// Chunks are immutable after Load(), so decompression happens
+	// outside the lock and does not block other clip lookups.
+	{
+		Lock lock(m_ClipMutex);
+
+		SharedPtr<Clip> p;
+		if (m_tClips.GetValue(id, p))
+		{
+			return p;
+		}
+	}
+
+	auto pChunk = m_tClipChunks.Find(id);
+	if (nullptr == pChunk)
+	{
+		return SharedPtr<Clip>();
+	}
+
+	SharedPtr<Clip> p;
+	if (!DecompressClip(*pChunk, p))
+	{
+		SEOUL_WARN("%s: failed loading animation clip \"%s\"", m_FilePath.CStr(), id.CStr());
+		return SharedPtr<Clip>();
+	}
+	p->Bind(*this);
+
+	// Another thread may have decompressed the same clip in
+	// the meantime - if so, keep (and return) the first.
+	Lock lock(m_ClipMutex);
+
+	SharedPtr<Clip> pExisting;
+	if (m_tClips.GetValue(id, pExisting))
+	{
+		return pExisting;
+	}
+
+	SEOUL_VERIFY(m_tClips.Insert(id, p).Second);
+	return p;
+}
+
+/** Populate rv with the id of every clip, resident or not. */
+void DataDefinition::GetClipIds(ClipIds& rv) const
+{
+	Lock lock(m_ClipMutex);
+
+	rv.Clear();
+	rv.Reserve(m_tClipChunks.GetSize() + m_tClips.GetSize());
+	for (auto const& e : m_tClipChunks)
+	{
+		rv.PushBack(e.First);
+	}
+	for (auto const& e : m_tClips)
+	{
+		if (nullptr == m_tClipChunks.Find(e.First))
+		{
+			rv.PushBack(e.First);
+		}
+	}
+}
+
+/**
+ * Release any resident clips that are no longer referenced outside
+ * of this definition (e.g. by a ClipInstance). Released clips are
+ * decompressed again on their next GetClip(). Clips that have no
+ * compressed chunk (e.g. at cook time) are never released.
+ *
+ * Not called automatically - the owner of the instances of this
+ * definition decides when to trade memory for decompression, typically
+ * via Manager::EvictUnusedClips() once per frame or on low memory.
+ *
+ * @return The number of clips released.
+ */
+UInt32 DataDefinition::EvictUnusedClips() const
+{
+	Lock lock(m_ClipMutex);
+
+	ClipIds vUnused;
+	for (auto const& e : m_tClips)
+	{
+		if (e.Second.IsUnique() && nullptr != m_tClipChunks.Find(e.First))
+		{
+			vUnused.PushBack(e.First);
+		}
+	}
+
+	for (auto const& id : vUnused)
+	{
+		(void)m_tClips.Erase(id);
+	}
+
+	return vUnused.GetSize();
+}
+
+/** @return The baked form of clip id, or an invalid pointer if id was not baked. */
+SharedPtr<BakedClip> DataDefinition::GetBakedClip(HString id) const
+{
+	SharedPtr<BakedClip> p;
+	(void)m_tBakedClips.GetValue(id, p);
+	return p;
+}
+
 Bool DataDefinition::Load(ReadWriteUtil& r)
 {
 	Bones vBones;
 	Lookup tBones;
-	Clips tClips;
+	BakedClips tBakedClips;
+	ClipBoundsTable tClipBounds;
+	Chunks tClipChunks;
 	BezierCurves vCurves;
 	Events tEvents;
 	Ik vIk;
@@ -792,6 +1380,10 @@ Bool DataDefinition::Load(ReadWriteUtil& r)
 	Paths vPaths;
 	Lookup tPaths;
 	PoseTasks vPoseTasks;
+	LodPoseTasks aLodPoseTasks;
+	PoseBoneRuns vPoseBoneRuns;
+	PoseBoneRunBones viPoseBoneRunBones;
+	Chunks tSkinChunks;
 	Skins tSkins;
 	Slots vSlots;
 	Lookup tSlots;
@@ -801,7 +1393,9 @@ Bool DataDefinition::Load(ReadWriteUtil& r)
 	auto bReturn = true;
 	bReturn = bReturn  && r.Read(vBones);
 	bReturn = bReturn  && r.Read(tBones);
-	bReturn = bReturn  && r.Read(tClips);
+	bReturn = bReturn  && r.Read(tClipChunks);
+	bReturn = bReturn  && r.Read(tBakedClips);
+	bReturn = bReturn  && r.Read(tClipBounds);
 	bReturn = bReturn  && r.Read(vCurves);
 	bReturn = bReturn  && r.Read(tEvents);
 	bReturn = bReturn  && r.Read(vIk);
@@ -810,18 +1404,48 @@ Bool DataDefinition::Load(ReadWriteUtil& r)
 	bReturn = bReturn  && r.Read(vPaths);
 	bReturn = bReturn  && r.Read(tPaths);
 	bReturn = bReturn  && r.Read(vPoseTasks);
-	bReturn = bReturn  && r.Read(tSkins);
+	for (UInt32 i = 0u; i < kuLodLevels; ++i)
+	{
+		bReturn = bReturn  && r.Read(aLodPoseTasks[i]);
+	}
+	bReturn = bReturn  && r.Read(vPoseBoneRuns);
+	bReturn = bReturn  && r.Read(viPoseBoneRunBones);
+	bReturn = bReturn  && r.Read(tSkinChunks);
 	bReturn = bReturn  && r.Read(vSlots);
 	bReturn = bReturn  && r.Read(tSlots);
 	bReturn = bReturn  && r.Read(vTransforms);
 	bReturn = bReturn  && r.Read(tTransforms);
 
+	// Skins are decoded in parallel.
+	bReturn = bReturn && LoadSkins(tSkinChunks, tSkins);
+
 	// Done on failure.
 	if (!bReturn)
 	{
 		return bReturn;
 	}
 
+	// Baked clips are sampled directly into the skinning palette and
+	// slots of instances, so they must match this definition exactly.
+	for (auto const& pair : tBakedClips)
+	{
+		auto const& pBaked = pair.Second;
+		if (!pBaked.IsValid()) { return false; }
+		if (pBaked->GetBoneCount() != vBones.GetSize()) { return false; }
+		if (pBaked->GetSlotCount() != vSlots.GetSize()) { return false; }
+		if (nullptr == tClipChunks.Find(pair.First)) { return false; }
+	}
+
+	// Not fatal, but GetClipBounds() fails for such a clip and it is
+	// not part of the union of clip bounds (see ComputeBounds()).
+	for (auto const& pair : tClipChunks)
+	{
+		if (nullptr == tClipBounds.Find(pair.First))
+		{
+			SEOUL_WARN("%s: animation clip \"%s\" has no bounds, it needs to be recooked", m_FilePath.CStr(), pair.First.CStr());
+		}
+	}
+
 	// Now resolve linked mesh parents - needs to be done
 	// after most other structures have been loaded due to
 	// dependency between skins.
@@ -864,7 +1488,10 @@ Bool DataDefinition::Load(ReadWriteUtil& r)
 	// Swap in results and return success.
 	m_vBones.Swap(vBones);
 	m_tBones.Swap(tBones);
-	m_tClips.Swap(tClips);
+	m_tBakedClips.Swap(tBakedClips);
+	m_tClipBounds.Swap(tClipBounds);
+	m_tClips.Clear();
+	m_tClipChunks.Swap(tClipChunks);
 	m_vCurves.Swap(vCurves);
 	m_tEvents.Swap(tEvents);
 	m_vIk.Swap(vIk);
@@ -873,20 +1500,373 @@ Bool DataDefinition::Load(ReadWriteUtil& r)
 	m_vPaths.Swap(vPaths);
 	m_tPaths.Swap(tPaths);
 	m_vPoseTasks.Swap(vPoseTasks);
+	for (UInt32 i = 0u; i < kuLodLevels; ++i)
+	{
+		m_aLodPoseTasks[i].Swap(aLodPoseTasks[i]);
+	}
+	m_vPoseBoneRuns.Swap(vPoseBoneRuns);
+	m_viPoseBoneRunBones.Swap(viPoseBoneRunBones);
 	m_tSkins.Swap(tSkins);
 	m_vSlots.Swap(vSlots);
 	m_tSlots.Swap(tSlots);
 	m_vTransforms.Swap(vTransforms);
 	m_tTransforms.Swap(tTransforms);
+
+	// Runtime only data.
+	ComputeBounds();
+	ComputeUniformCurves();
+	BindClips();
+	return true;
+}
+
+/**
+ * Cook time only - compute the derived data of p that is written by
+ * Save() (baked clips and clip bounds). Must be called after p has been deserialized
+ * and before it is saved. Instantiates p, which is why this is
+ * separate from (and not called by) Save().
+ */
+Bool DataDefinition::Cook(const SharedPtr<DataDefinition>& p)
+{
+	SharedPtr<DataDefinition const> const pData(p.GetPtr());
+
+	BakedClips tBakedClips(p->m_tBakedClips);
+	if (!BakeClips(pData, tBakedClips))
+	{
+		return false;
+	}
+
+	// Conservative bounds are computed for all clips.
+	ClipBoundsTable tClipBounds(p->m_tClipBounds);
+	if (!ComputeClipBounds(pData, tClipBounds))
+	{
+		return false;
+	}
+
+	p->m_tBakedClips.Swap(tBakedClips);
+	p->m_tClipBounds.Swap(tClipBounds);
+	return true;
+}
+
+/**
+ * Cook time only - add a BakedClip to rt for each clip requested by
+ * the metadata of pData that is not already in rt. Clips that cannot
+ * be baked (e.g. clips with deform timelines) are skipped with a
+ * warning and are played back normally.
+ */
+Bool DataDefinition::BakeClips(const SharedPtr<DataDefinition const>& pData, BakedClips& rt)
+{
+	auto const fSampleRate = pData->m_MetaData.m_fBakeSampleRate;
+	if (!(fSampleRate > 0.0f))
+	{
+		return true;
+	}
+
+	ClipIds vIds(pData->m_MetaData.m_vBakeClips);
+	if (vIds.IsEmpty())
+	{
+		pData->GetClipIds(vIds);
+	}
+
+	for (auto const& id : vIds)
+	{
+		if (nullptr != rt.Find(id))
+		{
+			continue;
+		}
+
+		auto const pClip(pData->GetClip(id));
+		if (!pClip.IsValid())
+		{
+			SEOUL_WARN("%s: cannot bake non-existent animation clip \"%s\"", pData->m_FilePath.CStr(), id.CStr());
+			return false;
+		}
+
+		SharedPtr<BakedClip> pBaked(SEOUL_NEW(MemoryBudgets::Animation2D) BakedClip);
+		if (!BakedClip::Bake(pData, pClip, fSampleRate, *pBaked))
+		{
+			SEOUL_WARN("%s: animation clip \"%s\" cannot be baked, it will not use baked playback", pData->m_FilePath.CStr(), id.CStr());
+			continue;
+		}
+
+		SEOUL_VERIFY(rt.Insert(id, pBaked).Second);
+	}
+
+	return true;
+}
+
+/** Sample rate used for clip bounds when the metadata does not specify a bake rate. */
+static const Float kfClipBoundsSampleRate = 30.0f;
+
+/** Scratch buffer of skinned positions used by ComputeClipBounds(). */
+typedef Vector<Vector2D, MemoryBudgets::Animation2D> BoundsScratch;
+
+static inline void AppendPositions(const BoundsScratch& v, UInt32 uVertices, BoundsScratch& rv)
+{
+	for (UInt32 i = 0u; i < uVertices; ++i)
+	{
+		rv.PushBack(v[i]);
+	}
+}
+
+/**
+ * Append the posed positions of attachment on slot iSlot of instance to rv.
+ * The currently attached mesh of the slot is skinned with its deform
+ * (if any) applied, all other attachments in their bind shape. Attachments
+ * that are never rendered (bounding boxes, paths, points) are ignored.
+ */
+static void AbsorbAttachment(
+	const DataInstance& instance,
+	Int16 iSlot,
+	const Attachment& attachment,
+	BoundsScratch& rvScratch,
+	BoundsScratch& rv)
+{
+	auto const& palette = instance.GetSkinningPalette();
+	auto const iBone = instance.GetData()->GetSlots()[iSlot].m_iBone;
+
+	MeshAttachment const* pMesh = nullptr;
+	switch (attachment.GetType())
+	{
+	case AttachmentType::kBitmap:
+	{
+		if (iBone < 0 || (UInt32)iBone >= palette.GetSize())
+		{
+			return;
+		}
+
+		auto const& bitmap = (const BitmapAttachment&)attachment;
+		auto const& m = palette[iBone];
+		auto const fRadians = DegreesToRadians(bitmap.GetRotationInDegrees());
+		auto const fCos = Cos(fRadians);
+		auto const fSin = Sin(fRadians);
+		auto const fW = 0.5f * bitmap.GetWidth() * bitmap.GetScaleX();
+		auto const fH = 0.5f * bitmap.GetHeight() * bitmap.GetScaleY();
+		for (UInt32 i = 0u; i < 4u; ++i)
+		{
+			auto const fCornerX = (0u == (i & 1u) ? -fW : fW);
+			auto const fCornerY = (0u == (i & 2u) ? -fH : fH);
+			auto const fX = bitmap.GetPositionX() + fCos * fCornerX - fSin * fCornerY;
+			auto const fY = bitmap.GetPositionY() + fSin * fCornerX + fCos * fCornerY;
+			rv.PushBack(Vector2D(
+				m.M00 * fX + m.M01 * fY + m.M02,
+				m.M10 * fX + m.M11 * fY + m.M12));
+		}
+		return;
+	}
+	case AttachmentType::kLinkedMesh:
+		pMesh = ((const LinkedMeshAttachment&)attachment).GetParent().GetPtr();
+		break;
+	case AttachmentType::kMesh:
+		pMesh = (MeshAttachment const*)&attachment;
+		break;
+	default:
+		return;
+	};
+
+	if (nullptr == pMesh)
+	{
+		return;
+	}
+
+	rvScratch.Resize(pMesh->GetTexCoords().GetSize());
+	if (rvScratch.IsEmpty())
+	{
+		return;
+	}
+
+	SkinningTarget const target(rvScratch.Data(), (UInt32)sizeof(Vector2D), 0u);
+
+	// Attached, skin with the instance, which includes deforms.
+	if (instance.GetSlotAttachment(iSlot) == &attachment)
+	{
+		AppendPositions(rvScratch, Min(instance.SkinSlot(iSlot, target), rvScratch.GetSize()), rv);
+		return;
+	}
+
+	auto const& vVertices = pMesh->GetVertices();
+	if (pMesh->GetBoneCounts().IsEmpty())
+	{
+		if (iBone < 0 || (UInt32)iBone >= palette.GetSize() || vVertices.GetSize() != rvScratch.GetSize())
+		{
+			return;
+		}
+
+		SkinningLayout::Transform(palette[iBone], (Float32 const*)vVertices.Data(), vVertices.GetSize(), target);
+		AppendPositions(rvScratch, rvScratch.GetSize(), rv);
+		return;
+	}
+
+	auto const& layout = pMesh->GetSkinningLayout();
+	if (layout.IsEmpty() || layout.GetRequiredBones() > palette.GetSize() || layout.GetVertexCount() != rvScratch.GetSize())
+	{
+		return;
+	}
+
+	layout.Skin(palette.Data(), (Float32 const*)vVertices.Data(), target);
+	AppendPositions(rvScratch, rvScratch.GetSize(), rv);
+}
+
+/**
+ * Cook time only - add bounds to rt for each clip of pData that is
+ * not already in rt. Bounds cover every attachment, in every skin, of
+ * each slot, so they remain valid under skin and attachment changes.
+ *
+ * The clip is sampled (at the bake rate, if any), so motion between
+ * samples is not observed directly. To keep the bounds conservative,
+ * they are inflated by the largest displacement of any position
+ * between two consecutive samples.
+ */
+Bool DataDefinition::ComputeClipBounds(const SharedPtr<DataDefinition const>& pData, ClipBoundsTable& rt)
+{
+	auto const fSampleRate = (pData->m_MetaData.m_fBakeSampleRate > 0.0f ? pData->m_MetaData.m_fBakeSampleRate : kfClipBoundsSampleRate);
+	auto const& vSlots = pData->m_vSlots;
+	auto const& tSkins = pData->m_tSkins;
+
+	ClipIds vIds;
+	pData->GetClipIds(vIds);
+
+	BoundsScratch vScratch;
+	BoundsScratch vPositions;
+	BoundsScratch vPrevious;
+	for (auto const& id : vIds)
+	{
+		if (nullptr != rt.Find(id))
+		{
+			continue;
+		}
+
+		auto const pClip(pData->GetClip(id));
+		if (!pClip.IsValid())
+		{
+			SEOUL_WARN("%s: cannot compute bounds of non-existent animation clip \"%s\"", pData->m_FilePath.CStr(), id.CStr());
+			return false;
+		}
+
+		DataInstance instance(pData, SharedPtr<Animation::EventInterface>());
+		ClipInstance clip(instance, pClip, Animation::ClipSettings());
+
+		// Always include a sample at (or past) the end of the clip.
+		auto const fMaxTime = clip.GetMaxTime();
+		UInt32 const uFrames = (UInt32)Ceil(fMaxTime * fSampleRate) + 1u;
+
+		ClipBounds bounds;
+		Float fMaxDisplacement = 0.0f;
+		vPrevious.Clear();
+		for (UInt32 uFrame = 0u; uFrame < uFrames; ++uFrame)
+		{
+			auto const fTime = Min((Float)uFrame / fSampleRate, fMaxTime);
+			clip.Evaluate(fTime, 1.0f, false);
+			instance.ApplyCache();
+			instance.Pose();
+
+			// Gathered in a consistent order, so positions of consecutive
+			// samples correspond.
+			vPositions.Clear();
+			for (UInt32 i = 0u; i < vSlots.GetSize(); ++i)
+			{
+				for (auto const& skinPair : tSkins)
+				{
+					auto pSet = skinPair.Second.Find(vSlots[i].m_Id);
+					if (nullptr == pSet)
+					{
+						continue;
+					}
+
+					for (auto const& attachmentPair : *pSet)
+					{
+						if (attachmentPair.Second.IsValid())
+						{
+							AbsorbAttachment(instance, (Int16)i, *attachmentPair.Second, vScratch, vPositions);
+						}
+					}
+				}
+			}
+
+			for (auto const& v : vPositions)
+			{
+				bounds.Absorb(v.X, v.Y);
+			}
+
+			if (vPrevious.GetSize() == vPositions.GetSize())
+			{
+				for (UInt32 i = 0u; i < vPositions.GetSize(); ++i)
+				{
+					fMaxDisplacement = Max(fMaxDisplacement, Abs(vPositions[i].X - vPrevious[i].X));
+					fMaxDisplacement = Max(fMaxDisplacement, Abs(vPositions[i].Y - vPrevious[i].Y));
+				}
+			}
+			vPrevious.Swap(vPositions);
+		}
+
+		bounds.Inflate(fMaxDisplacement);
+		SEOUL_VERIFY(rt.Insert(id, bounds).Second);
+	}
+
 	return true;
 }
 
 Bool DataDefinition::Save(ReadWriteUtil& r) const
 {
+	// Clips are written as compressed chunks - reuse
+	// existing chunks and compress any others.
+	Chunks tClipChunks(m_tClipChunks);
+	{
+		Lock lock(m_ClipMutex);
+		for (auto const& e : m_tClips)
+		{
+			if (nullptr != tClipChunks.Find(e.First))
+			{
+				continue;
+			}
+
+			Chunk v;
+			if (!e.Second.IsValid() || !CompressClip(r.GetPlatform(), m_MetaData.m_fQuantizeTolerance, *e.Second, v))
+			{
+				return false;
+			}
+
+			SEOUL_VERIFY(tClipChunks.Insert(e.First, v).Second);
+		}
+	}
+
+	// Baked clips are produced by Cook(), not here. Baking can skip
+	// individual clips (with a warning), so this is not an error.
+	if (m_MetaData.m_fBakeSampleRate > 0.0f && m_tBakedClips.IsEmpty() && !tClipChunks.IsEmpty())
+	{
+		SEOUL_WARN("%s: bake sample rate is %f but there are no baked clips, was Cook() called before Save()?", m_FilePath.CStr(), m_MetaData.m_fBakeSampleRate);
+	}
+
+	// Clip bounds are also produced by Cook(), for every clip.
+	for (auto const& e : tClipChunks)
+	{
+		if (nullptr == m_tClipBounds.Find(e.First))
+		{
+			SEOUL_WARN("%s: animation clip \"%s\" has no bounds, Cook() must be called before Save()", m_FilePath.CStr(), e.First.CStr());
+			return false;
+		}
+	}
+
+	// Skins are written as compressed chunks, so that
+	// they can be decoded in parallel.
+	Chunks tSkinChunks;
+	tSkinChunks.Reserve(m_tSkins.GetSize());
+	for (auto const& e : m_tSkins)
+	{
+		Chunk v;
+		if (!CompressSkin(r.GetPlatform(), e.Second, v))
+		{
+			return false;
+		}
+
+		SEOUL_VERIFY(tSkinChunks.Insert(e.First, v).Second);
+	}
+
 	auto bReturn = true;
 	bReturn = bReturn  && r.Write(m_vBones);
 	bReturn = bReturn  && r.Write(m_tBones);
-	bReturn = bReturn  && r.Write(m_tClips);
+	bReturn = bReturn  && r.Write(tClipChunks);
+	bReturn = bReturn  && r.Write(m_tBakedClips);
+	bReturn = bReturn  && r.Write(m_tClipBounds);
 	bReturn = bReturn  && r.Write(m_vCurves);
 	bReturn = bReturn  && r.Write(m_tEvents);
 	bReturn = bReturn  && r.Write(m_vIk);
@@ -895,7 +1875,13 @@ Bool DataDefinition::Save(ReadWriteUtil& r) const
 	bReturn = bReturn  && r.Write(m_vPaths);
 	bReturn = bReturn  && r.Write(m_tPaths);
 	bReturn = bReturn  && r.Write(m_vPoseTasks);
-	bReturn = bReturn  && r.Write(m_tSkins);
+	for (UInt32 i = 0u; i < kuLodLevels; ++i)
+	{
+		bReturn = bReturn  && r.Write(m_aLodPoseTasks[i]);
+	}
+	bReturn = bReturn  && r.Write(m_vPoseBoneRuns);
+	bReturn = bReturn  && r.Write(m_viPoseBoneRunBones);
+	bReturn = bReturn  && r.Write(tSkinChunks);
 	bReturn = bReturn  && r.Write(m_vSlots);
 	bReturn = bReturn  && r.Write(m_tSlots);
 	bReturn = bReturn  && r.Write(m_vTransforms);
@@ -993,13 +1979,97 @@ Bool DataDefinition::CopyBaseVertices(
 	};
 }
 
+/**
+ * @return The total memory footprint of this definition, in bytes.
+ * Includes runtime derived data and currently resident clips. Clips
+ * that have not yet been requested contribute the size of their
+ * compressed chunk.
+ */
+UInt32 DataDefinition::GetMemoryUsage() const
+{
+	auto const boneIds = [](const auto& e) { return GetHeapSize(e.m_vBoneIds) + GetHeapSize(e.m_viBones); };
+
+	UInt32 uReturn = (UInt32)sizeof(*this);
+	uReturn += GetHeapSize(m_vBones);
+	uReturn += GetHeapSize(m_tBones);
+	uReturn += GetHeapSize(m_tBakedClips, [](const SharedPtr<BakedClip>& p) { return (p.IsValid() ? p->GetMemoryUsage() : 0u); });
+	uReturn += GetHeapSize(m_tClipBounds);
+	{
+		Lock lock(m_ClipMutex);
+		uReturn += GetHeapSize(m_tClips, [](const SharedPtr<Clip>& p) { return (p.IsValid() ? p->GetMemoryUsage() : 0u); });
+		uReturn += GetHeapSize(m_tClipChunks, [](const Chunk& v) { return GetHeapSize(v); });
+	}
+	uReturn += GetHeapSize(m_vCurves);
+	uReturn += GetHeapSize(m_tEvents, [](const EventDefinition& e) { return GetHeapSize(e.m_s); });
+	uReturn += GetHeapSize(m_vIk, boneIds);
+	uReturn += GetHeapSize(m_tIk);
+	uReturn += GetHeapSize(m_vPaths, boneIds);
+	uReturn += GetHeapSize(m_tPaths);
+	uReturn += GetHeapSize(m_vPoseTasks);
+	uReturn += GetHeapSize(m_tSkins, [](const Attachments& tSlots)
+	{
+		return GetHeapSize(tSlots, [](const AttachmentSets& tSet)
+		{
+			return GetHeapSize(tSet, [](const SharedPtr<Attachment>& p) { return (p.IsValid() ? p->GetMemoryUsage() : 0u); });
+		});
+	});
+	uReturn += GetHeapSize(m_vSlots);
+	uReturn += GetHeapSize(m_tSlots);
+	uReturn += GetHeapSize(m_vTransforms, boneIds);
+	uReturn += GetHeapSize(m_tTransforms);
+	uReturn += GetHeapSize(m_tCurveLookup);
+	for (UInt32 i = 0u; i < m_aLodPoseTasks.GetSize(); ++i)
+	{
+		uReturn += GetHeapSize(m_aLodPoseTasks[i]);
+	}
+	uReturn += GetHeapSize(m_vPoseBoneRuns);
+	uReturn += GetHeapSize(m_viPoseBoneRunBones);
+	if (m_pSetupPose.IsValid())
+	{
+		auto const& r = *m_pSetupPose;
+		uReturn += (UInt32)sizeof(r);
+		uReturn += r.GetHeapSize();
+	}
+#if SEOUL_ANIMATION2D_UNIFORM_CURVES
+	uReturn += GetHeapSize(m_vUniformCurves);
+#endif // /#if SEOUL_ANIMATION2D_UNIFORM_CURVES
+	return uReturn;
+}
+
 Bool DataDefinition::operator==(const DataDefinition& b) const
 {
 	auto br = true;
 	br = br && (m_FilePath == b.m_FilePath);
 	br = br && (m_vBones == b.m_vBones);
 	br = br && (m_tBones == b.m_tBones);
-	br = br && (m_tClips == b.m_tClips);
+	if (br)
+	{
+		// Clips are compared by content, independent of residency - by
+		// their chunks, or by decompressing (or using the resident clip)
+		// only when one side has no chunk (e.g. cook time definitions).
+		ClipIds vA;
+		ClipIds vB;
+		GetClipIds(vA);
+		b.GetClipIds(vB);
+		br = br && (vA.GetSize() == vB.GetSize());
+		for (UInt32 i = 0u; br && i < vA.GetSize(); ++i)
+		{
+			auto const id = vA[i];
+			auto const pChunkA = m_tClipChunks.Find(id);
+			auto const pChunkB = b.m_tClipChunks.Find(id);
+			if (nullptr != pChunkA && nullptr != pChunkB)
+			{
+				br = br && (*pChunkA == *pChunkB);
+			}
+			else
+			{
+				auto const pClipA(GetClip(id));
+				auto const pClipB(b.GetClip(id));
+				br = br && pClipA.IsValid() && pClipB.IsValid() && (*pClipA == *pClipB);
+			}
+		}
+	}
+	// Baked clips and clip bounds are derived data (see Cook()) and are not compared.
 	br = br && (m_vCurves == b.m_vCurves);
 	br = br && (m_tEvents == b.m_tEvents);
 	br = br && (m_vIk == b.m_vIk);
@@ -1040,6 +2110,9 @@ Bool DataDefinition::CustomDeserializeType(
 		true);
 	rContext.SetUserData(old);
 
+	// Curve deduplication is only necessary during deserialization.
+	p->m_tCurveLookup.Clear();
+
 	// On failure, fail immediately.
 	if (!bSuccess)
 	{
@@ -1054,6 +2127,11 @@ Bool DataDefinition::CustomDeserializeType(
 	if (!p->FinalizePaths()) { return false; } // Must come after FinalizeSlots().
 	if (!p->FinalizeTransforms()) { return false; }
 	if (!p->FinalizePoseTasks()) { return false; } // Must be last.
+	p->ComputeLodPoseTasks();
+
+	// Runtime only data.
+	p->ComputeUniformCurves();
+	p->BindClips();
 
 	return true;
 }
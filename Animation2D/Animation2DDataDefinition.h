@@ -14,15 +14,24 @@
 
 #include "Animation2DAttachment.h"
 #include "Animation2DClipDefinition.h"
+#include "Animation2DProfile.h"
 #include "ContentHandle.h"
 #include "ContentTraits.h"
+#include "FixedArray.h"
 #include "HashTable.h"
+#include "Mutex.h"
 #include "Prereqs.h"
 #include "ReflectionDeclare.h"
+#include "ScopedPtr.h"
 #include "SeoulHString.h"
+#include "SeoulMath.h"
 #include "SharedPtr.h"
 #include "StandardVertex2D.h"
 #include "Vector.h"
+#include "Vector2D.h"
+
+namespace Seoul { namespace Animation2D { class BakedClip; } }
+namespace Seoul { namespace Animation2D { struct DataInstanceSetupPose; } }
 
 #if SEOUL_WITH_ANIMATION_2D
 
@@ -203,15 +212,33 @@ struct MetaData SEOUL_SEALED
 		, m_fFPS(30.0f)
 		, m_fHeight(0.0f)
 		, m_fWidth(0.0f)
+		, m_fBakeSampleRate(0.0f)
+		, m_vBakeClips()
+		, m_fQuantizeTolerance(0.0f)
 	{
 	}
 
+	typedef Vector<HString, MemoryBudgets::Animation2D> BakeClips;
+
 	Float32 m_fPositionX;
 	Float32 m_fPositionY;
 	Float32 m_fFPS;
 	Float32 m_fHeight;
 	Float32 m_fWidth;
 
+	// Cook time only - when > 0, the clips in m_vBakeClips (or all clips,
+	// if m_vBakeClips is empty) are baked at this rate (in samples per
+	// second) for playback, see BakedClip.
+	Float32 m_fBakeSampleRate;
+	BakeClips m_vBakeClips;
+
+	// Cook time only - when > 0, bone, ik, path and transform key frames
+	// of clips are stored with 16-bit quantized times and values, per
+	// track, when the error of each value is within this tolerance (in
+	// the units of the value). Compressed at rest only, quantized tracks
+	// are decoded to full precision when a clip is loaded.
+	Float32 m_fQuantizeTolerance;
+
 	Bool operator==(const MetaData& b) const
 	{
 		return
@@ -219,7 +246,10 @@ struct MetaData SEOUL_SEALED
 			(m_fPositionY == b.m_fPositionY) &&
 			(m_fFPS == b.m_fFPS) &&
 			(m_fHeight == b.m_fHeight) &&
-			(m_fWidth == b.m_fWidth);
+			(m_fWidth == b.m_fWidth) &&
+			(m_fBakeSampleRate == b.m_fBakeSampleRate) &&
+			(m_vBakeClips == b.m_vBakeClips) &&
+			(m_fQuantizeTolerance == b.m_fQuantizeTolerance);
 	}
 
 	Bool operator!=(const MetaData& b) const
@@ -319,6 +349,10 @@ enum class PoseTaskType : Int16
 	kIk,
 	kPath,
 	kTransform,
+
+	// Runtime only, never serialized. Index is into
+	// DataDefinition::GetPoseBoneRuns().
+	kBoneRun,
 };
 
 struct PoseTask SEOUL_SEALED
@@ -347,6 +381,40 @@ struct PoseTask SEOUL_SEALED
 	Int16 m_iIndex;
 }; // struct PoseTask
 
+/**
+ * A run of bones with TransformMode::kNormal that do not depend on
+ * each other and can be posed together. Offset and count refer to
+ * DataDefinition::GetPoseBoneRunBones().
+ */
+struct PoseBoneRun SEOUL_SEALED
+{
+	PoseBoneRun(UInt32 uOffset = 0u, UInt32 uCount = 0u)
+		: m_uOffset(uOffset)
+		, m_uCount(uCount)
+	{
+	}
+
+	UInt32 m_uOffset;
+	UInt32 m_uCount;
+}; // struct PoseBoneRun
+
+/**
+ * Level of detail of a DataInstance. Lower levels of detail trade
+ * fidelity for performance:
+ * - kReduced: clips are sampled at a reduced rate, path and transform
+ *   constraints are skipped.
+ * - kMinimal: clips are sampled at a further reduced rate, all constraints
+ *   are skipped (bones controlled by IK take their FK pose) and deform
+ *   timelines are not applied.
+ */
+enum class LodLevel : Int32
+{
+	kFull,
+	kReduced,
+	kMinimal,
+};
+static const UInt32 kuLodLevels = 3u;
+
 struct SlotDataDefinition SEOUL_SEALED
 {
 	SlotDataDefinition()
@@ -473,19 +541,85 @@ struct TransformConstraintDefinition SEOUL_SEALED
 	Bool m_bRelative;
 }; // struct TransformConstraintDefinition
 
+/**
+ * Axis-aligned bounds in the space of a DataInstance (prior to any
+ * render transform). Default constructed bounds are empty.
+ */
+struct ClipBounds SEOUL_SEALED
+{
+	ClipBounds()
+		: m_vMin(FloatMax, FloatMax)
+		, m_vMax(-FloatMax, -FloatMax)
+	{
+	}
+
+	void Absorb(Float fX, Float fY)
+	{
+		m_vMin.X = Min(m_vMin.X, fX);
+		m_vMin.Y = Min(m_vMin.Y, fY);
+		m_vMax.X = Max(m_vMax.X, fX);
+		m_vMax.Y = Max(m_vMax.Y, fY);
+	}
+
+	void Absorb(const ClipBounds& b)
+	{
+		if (b.IsValid())
+		{
+			Absorb(b.m_vMin.X, b.m_vMin.Y);
+			Absorb(b.m_vMax.X, b.m_vMax.Y);
+		}
+	}
+
+	// Grow by f on all sides, nop if not valid.
+	void Inflate(Float f)
+	{
+		if (IsValid())
+		{
+			m_vMin.X -= f;
+			m_vMin.Y -= f;
+			m_vMax.X += f;
+			m_vMax.Y += f;
+		}
+	}
+
+	Bool IsValid() const { return (m_vMin.X <= m_vMax.X && m_vMin.Y <= m_vMax.Y); }
+
+	Bool operator==(const ClipBounds& b) const
+	{
+		return (m_vMin == b.m_vMin && m_vMax == b.m_vMax);
+	}
+
+	Bool operator!=(const ClipBounds& b) const
+	{
+		return !(*this == b);
+	}
+
+	Vector2D m_vMin;
+	Vector2D m_vMax;
+}; // struct ClipBounds
+
 class DataDefinition SEOUL_SEALED
 {
 public:
 	typedef HashTable<HString, SharedPtr<Attachment>, MemoryBudgets::Animation2D> AttachmentSets;
 	typedef HashTable<HString, AttachmentSets, MemoryBudgets::Animation2D> Attachments;
+	typedef HashTable<HString, SharedPtr<BakedClip>, MemoryBudgets::Animation2D> BakedClips;
 	typedef Vector<BoneDefinition, MemoryBudgets::Animation2D> Bones;
+	typedef Vector<UInt8, MemoryBudgets::Animation2D> Chunk;
+	typedef HashTable<HString, Chunk, MemoryBudgets::Animation2D> Chunks;
 	typedef HashTable<HString, SharedPtr<Clip>, MemoryBudgets::Animation2D> Clips;
+	typedef HashTable<HString, ClipBounds, MemoryBudgets::Animation2D> ClipBoundsTable;
+	typedef Vector<HString, MemoryBudgets::Animation2D> ClipIds;
+	typedef HashTable<UInt32, UInt32, MemoryBudgets::Animation2D> CurveLookup;
 	typedef HashTable<HString, EventDefinition, MemoryBudgets::Animation2D> Events;
 	typedef Vector<Float, MemoryBudgets::Animation2D> Floats;
 	typedef Vector<IkDefinition, MemoryBudgets::Animation2D> Ik;
 	typedef HashTable<HString, Int16, MemoryBudgets::Animation2D> Lookup;
 	typedef Vector<PathDefinition, MemoryBudgets::Animation2D> Paths;
 	typedef Vector<PoseTask, MemoryBudgets::Animation2D> PoseTasks;
+	typedef Vector<PoseBoneRun, MemoryBudgets::Animation2D> PoseBoneRuns;
+	typedef Vector<Int16, MemoryBudgets::Animation2D> PoseBoneRunBones;
+	typedef FixedArray<PoseTasks, kuLodLevels> LodPoseTasks;
 	typedef HashTable<HString, Attachments, MemoryBudgets::Animation2D> Skins;
 	typedef Vector<SlotDataDefinition, MemoryBudgets::Animation2D> Slots;
 	typedef Vector<TransformConstraintDefinition, MemoryBudgets::Animation2D> Transforms;
@@ -497,14 +631,44 @@ public:
 	Bool Load(ReadWriteUtil& r);
 	Bool Save(ReadWriteUtil& r) const;
 
+	// Cook time only - compute derived data (baked clips, clip bounds) of p
+	// prior to Save(). Save() itself only writes.
+	static Bool Cook(const SharedPtr<DataDefinition>& p);
+
 	const Bones& GetBones() const { return m_vBones; }
 	Int16 GetBoneIndex(HString id) const { Int16 i = -1; (void)m_tBones.GetValue(id, i); return i; }
 
-	SharedPtr<Clip> GetClip(HString id) const { SharedPtr<Clip> p; (void)m_tClips.GetValue(id, p); return p; }
+	// Thread-safe. Clips are decompressed on first access.
+	SharedPtr<Clip> GetClip(HString id) const;
+	void GetClipIds(ClipIds& rv) const;
+
+	// Cook time only - at runtime, contains only the currently resident clips.
 	const Clips& GetClips() const { return m_tClips; }
 
+	// Release resident clips that are not referenced outside this definition.
+	// Never called implicitly, see Manager::EvictUnusedClips().
+	UInt32 EvictUnusedClips() const;
+
+	// Baked form of clip id, or an invalid pointer if id was not baked
+	// at cook time (see MetaData::m_fBakeSampleRate).
+	SharedPtr<BakedClip> GetBakedClip(HString id) const;
+
+	// Conservative bounds of clip id, over all sampled times and all
+	// attachments of each slot, computed at cook time. Available without
+	// decompressing the clip. False if id has no bounds.
+	Bool GetClipBounds(HString id, ClipBounds& r) const { return m_tClipBounds.GetValue(id, r); }
+	const ClipBoundsTable& GetClipBounds() const { return m_tClipBounds; }
+
+	// Union of the bounds of all clips.
+	const ClipBounds& GetBounds() const { return m_Bounds; }
+
 	const BezierCurves& GetCurves() const { return m_vCurves; }
-	BezierCurves& GetCurves() { return m_vCurves; }
+#if SEOUL_ANIMATION2D_UNIFORM_CURVES
+	const UniformCurves& GetUniformCurves() const { return m_vUniformCurves; }
+#endif // /#if SEOUL_ANIMATION2D_UNIFORM_CURVES
+
+	// Cook time only - add curve to the curve table, deduplicated.
+	UInt32 AddCurve(const BezierCurve& curve);
 
 	const Events& GetEvents() const { return m_tEvents; }
 
@@ -517,6 +681,17 @@ public:
 	Int16 GetPathIndex(HString id) const { Int16 i = -1; (void)m_tPaths.GetValue(id, i); return i; }
 
 	const PoseTasks& GetPoseTasks() const { return m_vPoseTasks; }
+	const PoseTasks& GetPoseTasks(LodLevel eLod) const { return m_aLodPoseTasks[(UInt32)eLod]; }
+	const PoseBoneRuns& GetPoseBoneRuns() const { return m_vPoseBoneRuns; }
+	const PoseBoneRunBones& GetPoseBoneRunBones() const { return m_viPoseBoneRunBones; }
+
+	// Runtime only - the initial state of all instances of this
+	// definition, or nullptr if it has not been computed.
+	DataInstanceSetupPose const* GetSetupPose() const { return m_pSetupPose.Get(); }
+
+	// Runtime only - compute the setup pose of p. Called once by the
+	// loader, prior to the definition becoming available.
+	static void ComputeSetupPose(const SharedPtr<DataDefinition>& p);
 
 	Bool GetAttachment(
 		HString skinId,
@@ -538,6 +713,17 @@ public:
 		HString attachmentId,
 		Floats& rv) const;
 
+	// Total memory footprint of this definition, including
+	// resident clips and attachments, in bytes. Thread-safe.
+	UInt32 GetMemoryUsage() const;
+
+	FilePath GetFilePath() const { return m_FilePath; }
+
+#if SEOUL_ANIMATION2D_PROFILING
+	// Instrumentation counters of this definition and its instances. Thread-safe.
+	ProfileStats& GetProfile() const { return m_Profile; }
+#endif // /#if SEOUL_ANIMATION2D_PROFILING
+
 	Bool operator==(const DataDefinition& b) const;
 
 private:
@@ -547,7 +733,11 @@ private:
 	FilePath const m_FilePath;
 	Bones m_vBones;
 	Lookup m_tBones;
-	Clips m_tClips;
+	BakedClips m_tBakedClips;
+	ClipBoundsTable m_tClipBounds;
+	mutable Clips m_tClips;
+	Chunks m_tClipChunks;
+	Mutex m_ClipMutex;
 	BezierCurves m_vCurves;
 	Events m_tEvents;
 	Ik m_vIk;
@@ -562,6 +752,31 @@ private:
 	Transforms m_vTransforms;
 	Lookup m_tTransforms;
 
+	// Cook time only, offset of curves in m_vCurves by hash.
+	CurveLookup m_tCurveLookup;
+
+	// Derived from m_vPoseTasks at cook time.
+	LodPoseTasks m_aLodPoseTasks;
+	PoseBoneRuns m_vPoseBoneRuns;
+	PoseBoneRunBones m_viPoseBoneRunBones;
+	ScopedPtr<DataInstanceSetupPose> m_pSetupPose;
+	// Runtime only, derived from m_tClipBounds.
+	ClipBounds m_Bounds;
+#if SEOUL_ANIMATION2D_UNIFORM_CURVES
+	// Runtime only, derived from m_vCurves.
+	UniformCurves m_vUniformCurves;
+#endif // /#if SEOUL_ANIMATION2D_UNIFORM_CURVES
+#if SEOUL_ANIMATION2D_PROFILING
+	mutable ProfileStats m_Profile;
+#endif // /#if SEOUL_ANIMATION2D_PROFILING
+
+	static Bool BakeClips(const SharedPtr<DataDefinition const>& pData, BakedClips& rt);
+	void BindClips();
+	void ComputeBounds();
+	static Bool ComputeClipBounds(const SharedPtr<DataDefinition const>& pData, ClipBoundsTable& rt);
+	void ComputeLodPoseTasks();
+	void ComputeUniformCurves();
+	void ComputePoseBoneRuns(PoseTasks& rv);
 	Bool DeserializeSkin(Reflection::SerializeContext* pContext, DataStore const* pDataStore, const DataNode& value);
 
 	Bool FinalizeBones();
@@ -604,7 +819,7 @@ struct Traits<Animation2D::DataDefinition>
 	static void Load(FilePath filePath, const Animation2DDataContentHandle& hEntry);
 	static Bool PrepareDelete(FilePath filePath, Entry<Animation2D::DataDefinition, KeyType>& entry);
 	static void SyncLoad(FilePath filePath, const Handle<Animation2D::DataDefinition>& pEntry) {}
-	static UInt32 GetMemoryUsage(const SharedPtr<Animation2D::DataDefinition>& p) { return 0u; }
+	static UInt32 GetMemoryUsage(const SharedPtr<Animation2D::DataDefinition>& p) { return (p.IsValid() ? p->GetMemoryUsage() : 0u); }
 }; // Content::Traits<Animation2D::DataDefinition>
 
 } // namespace Content
@@ -7,15 +7,29 @@
  */
 
 #include "AnimationEventInterface.h"
+#include "Animation2DBakedClip.h"
 #include "Animation2DCache.h"
+#include "Animation2DClipInstance.h"
 #include "Animation2DDataDefinition.h"
 #include "Animation2DDataInstance.h"
+#include "Animation2DMemoryUsage.h"
+#include "Animation2DPoseSnapshot.h"
+#include "Animation2DProfile.h"
 #include "Matrix2D.h"
 #include "ReflectionCoreTemplateTypes.h"
 #include "ReflectionDefine.h"
 
 #if SEOUL_WITH_ANIMATION_2D
 
+// SSE2 is baseline on all x64 targets, otherwise InternalPoseBoneRun()
+// falls back to scalar loops, which the compiler is free to vectorize.
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#	define SEOUL_ANIMATION2D_SSE_POSE 1
+#	include <emmintrin.h>
+#else
+#	define SEOUL_ANIMATION2D_SSE_POSE 0
+#endif
+
 namespace Seoul
 {
 
@@ -32,6 +46,9 @@ namespace Animation2D
 static const Float32 kfPathEpsilon = 0.00001f;
 static const Float32 kfPathEpsilonLoose = 0.001f;
 
+/** Upper bound on the number of released ClipInstances retained by a DataInstance. */
+static const UInt32 kuMaxPooledClipInstances = 16u;
+
 static inline Bool FloatToBool(Bool bBase, Float f)
 {
 	return (((bBase ? 1.0f : 0.0f) + f) >= 0.5f);
@@ -91,25 +108,195 @@ TransformConstraintInstance& TransformConstraintInstance::Assign(const Transform
 }
 
 DataInstance::DataInstance(const SharedPtr<DataDefinition const>& pData, const SharedPtr<Animation::EventInterface>& pEventInterface)
-	: m_pCache(SEOUL_NEW(MemoryBudgets::Animation2D) Cache)
+	: m_pCache(SEOUL_NEW(MemoryBudgets::Animation2D) Cache(
+		pData->GetBones().GetSize(),
+		pData->GetIk().GetSize(),
+		pData->GetPaths().GetSize(),
+		pData->GetSlots().GetSize(),
+		pData->GetTransforms().GetSize()))
 	, m_pData(pData)
 	, m_pEventInterface(pEventInterface)
 	, m_vBones()
 	, m_tDeforms()
+	, m_vDeformPool()
 	, m_tDeformReferences()
 	, m_vDrawOrder()
 	, m_vIk()
 	, m_vPaths()
 	, m_vSkinningPalette()
 	, m_vSlots()
+	, m_vSlotAttachmentIds()
+	, m_vSlotAttachments()
+	, m_vChangedSlots()
 	, m_vTransformConstraintStates()
+	, m_vClipInstancePool()
+	, m_uActiveClipInstances(0u)
+	, m_vEvents()
+	, m_vEventClips()
+	, m_pSnapshots()
+	, m_pBakedPose()
+	, m_fBakedPoseTime(0.0f)
+	, m_eLod(LodLevel::kFull)
+	, m_uLodFrame(0u)
+	, m_bPoseDeferred(false)
+	, m_bPoseLazy(false)
+	, m_bPoseDirty(true)
+	, m_bPoseShared(false)
+	, m_bEventsDeferred(false)
+	, m_bSleepEnabled(false)
+	, m_bInPoseBatch(false)
+	, m_bCacheEvaluated(false)
 {
 	InternalConstruct();
 }
 
 DataInstance::~DataInstance()
 {
+	SafeDeleteVector(m_vClipInstancePool);
 	SafeDeleteTable(m_tDeforms);
+	SafeDeleteVector(m_vDeformPool);
+}
+
+/**
+ * @return The deform buffer of key, activating it if necessary. Once
+ * the pool is warm (e.g. after the first loop of a clip), activation
+ * allocates nothing in the common case.
+ */
+DataInstance::DeformData& DataInstance::ActivateDeform(const DeformKey& key, UInt32 uSize, Bool& rbActivated)
+{
+	CheckedPtr<DeformData> p;
+	if (m_tDeforms.GetValue(key, p))
+	{
+		rbActivated = false;
+		return *p;
+	}
+
+	// Prefer a pooled buffer that is already large enough.
+	if (!m_vDeformPool.IsEmpty())
+	{
+		UInt32 uIndex = m_vDeformPool.GetSize() - 1u;
+		for (UInt32 i = 0u; i < m_vDeformPool.GetSize(); ++i)
+		{
+			if (m_vDeformPool[i]->GetCapacity() >= uSize)
+			{
+				uIndex = i;
+				break;
+			}
+		}
+
+		p = m_vDeformPool[uIndex];
+		m_vDeformPool[uIndex] = m_vDeformPool.Back();
+		m_vDeformPool.PopBack();
+	}
+	else
+	{
+		p = SEOUL_NEW(MemoryBudgets::Animation2D) DeformData;
+	}
+
+	p->Resize(uSize);
+	SEOUL_VERIFY(m_tDeforms.Insert(key, p).Second);
+	rbActivated = true;
+	return *p;
+}
+
+void DataInstance::DeactivateDeform(const DeformKey& key)
+{
+	CheckedPtr<DeformData> p;
+	if (!m_tDeforms.GetValue(key, p))
+	{
+		return;
+	}
+
+	(void)m_tDeforms.Erase(key);
+	m_vDeformPool.PushBack(p);
+}
+
+/**
+ * @return A ClipInstance of pClip bound to this DataInstance. The instance
+ * is taken from the pool of previously released instances when possible,
+ * in which case its track storage is reused.
+ */
+CheckedPtr<ClipInstance> DataInstance::AcquireClipInstance(
+	const SharedPtr<Clip>& pClip,
+	const Animation::ClipSettings& settings)
+{
+	++m_uActiveClipInstances;
+	if (m_vClipInstancePool.IsEmpty())
+	{
+		return SEOUL_NEW(MemoryBudgets::Animation2D) ClipInstance(*this, pClip, settings);
+	}
+
+	auto p = m_vClipInstancePool.Back();
+	m_vClipInstancePool.PopBack();
+	p->Reset(pClip, settings);
+	return p;
+}
+
+/**
+ * @return The skin of this instance. Only the default skin is currently
+ * supported - all skin dependent lookups go through here, so that active
+ * skin support is limited to this function and its state.
+ */
+HString DataInstance::GetActiveSkin() const
+{
+	// TODO: Need to use the active skin.
+	return kDefaultSkin;
+}
+
+/**
+ * Return a ClipInstance acquired with AcquireClipInstance() to the pool.
+ * rp is reset to nullptr. The instance releases its clip and deform
+ * references immediately.
+ */
+void DataInstance::ReleaseClipInstance(CheckedPtr<ClipInstance>& rp)
+{
+	if (!rp.IsValid())
+	{
+		return;
+	}
+
+	SEOUL_ASSERT(this == &rp->GetInstance());
+	SEOUL_ASSERT(m_uActiveClipInstances > 0u);
+	--m_uActiveClipInstances;
+
+	if (m_vClipInstancePool.GetSize() >= kuMaxPooledClipInstances)
+	{
+		SafeDelete(rp);
+		return;
+	}
+
+	rp->Clear();
+	m_vClipInstancePool.PushBack(rp);
+	rp.Reset();
+}
+
+/**
+ * Populate r with the memory footprint of this instance. ClipInstances
+ * that are currently active are owned by their PlayClipInstance and
+ * are not included, only those held in the pool of this instance.
+ */
+void DataInstance::GetMemoryUsage(DataInstanceMemoryUsage& r) const
+{
+	r = DataInstanceMemoryUsage();
+	r.m_uInstance = (UInt32)sizeof(*this);
+	r.m_uCache = m_pCache->GetMemoryUsage() + GetHeapSize(m_vEvents) + GetHeapSize(m_vEventClips);
+	r.m_uClipInstances = GetHeapSize(m_vClipInstancePool, [](const CheckedPtr<ClipInstance>& p) { return p->GetMemoryUsage(); });
+	r.m_uDeforms =
+		GetHeapSize(m_tDeforms, [](const CheckedPtr<DeformData>& p) { return (UInt32)sizeof(DeformData) + GetHeapSize(*p); }) +
+		GetHeapSize(m_vDeformPool, [](const CheckedPtr<DeformData>& p) { return (UInt32)sizeof(DeformData) + GetHeapSize(*p); }) +
+		GetHeapSize(m_tDeformReferences);
+	r.m_uPaths = GetHeapSize(m_vPaths);
+	r.m_uPose =
+		GetHeapSize(m_vBones) +
+		GetHeapSize(m_vDrawOrder) +
+		GetHeapSize(m_vIk) +
+		GetHeapSize(m_vSkinningPalette) +
+		GetHeapSize(m_vSlots) +
+		GetHeapSize(m_vSlotAttachmentIds) +
+		GetHeapSize(m_vSlotAttachments) +
+		GetHeapSize(m_vChangedSlots) +
+		GetHeapSize(m_vTransformConstraintStates);
+	r.m_uSnapshots = (m_pSnapshots.IsValid() ? (UInt32)sizeof(*m_pSnapshots) + m_pSnapshots->GetHeapSize() : 0u);
 }
 
 DataInstance* DataInstance::Clone() const
@@ -117,11 +304,13 @@ DataInstance* DataInstance::Clone() const
 	auto p = SEOUL_NEW(MemoryBudgets::Animation2D) DataInstance(m_pData, m_pEventInterface);
 	p->m_vBones = m_vBones;
 	{
+		p->m_tDeforms.Reserve(m_tDeforms.GetSize());
 		auto const iBegin = m_tDeforms.Begin();
 		auto const iEnd = m_tDeforms.End();
 		for (auto i = iBegin; iEnd != i; ++i)
 		{
-			SEOUL_VERIFY(p->m_tDeforms.Insert(i->First, SEOUL_NEW(MemoryBudgets::Animation2D) DeformData(*(i->Second))).Second);
+			Bool bUnused = false;
+			p->ActivateDeform(i->First, i->Second->GetSize(), bUnused) = *(i->Second);
 		}
 	}
 	p->m_vDrawOrder = m_vDrawOrder;
@@ -129,13 +318,137 @@ DataInstance* DataInstance::Clone() const
 	p->m_vPaths = m_vPaths;
 	p->m_vSkinningPalette = m_vSkinningPalette;
 	p->m_vSlots = m_vSlots;
+	p->m_vSlotAttachmentIds = m_vSlotAttachmentIds;
+	p->m_vSlotAttachments = m_vSlotAttachments;
+	p->m_vChangedSlots = m_vChangedSlots;
 	p->m_vTransformConstraintStates = m_vTransformConstraintStates;
+	p->m_eLod = m_eLod;
+	p->m_uLodFrame = m_uLodFrame;
+	p->m_bPoseDeferred = m_bPoseDeferred;
+	p->m_bPoseLazy = m_bPoseLazy;
+	p->m_bPoseDirty = m_bPoseDirty;
+	p->m_bPoseShared = m_bPoseShared;
+	p->m_pBakedPose = m_pBakedPose;
+	p->m_fBakedPoseTime = m_fBakedPoseTime;
+	p->m_bEventsDeferred = m_bEventsDeferred;
+	p->m_bSleepEnabled = m_bSleepEnabled;
+	p->SetSnapshotsEnabled(AreSnapshotsEnabled());
 	return p;
 }
 
+/** @return The number of frames between samples of clip timelines at level of detail eLod. */
+UInt32 DataInstance::GetLodEvaluationInterval(LodLevel eLod)
+{
+	switch (eLod)
+	{
+	case LodLevel::kReduced: return 2u;
+	case LodLevel::kMinimal: return 4u;
+	default:
+		return 1u;
+	};
+}
+
+/**
+ * Dispatch all events queued since the last flush, in the order they
+ * were queued, and clear the queue. Queue capacity is retained, so
+ * steady state deferred dispatch does not allocate.
+ */
+void DataInstance::FlushEvents()
+{
+	if (m_vEvents.IsEmpty())
+	{
+		return;
+	}
+
+	if (m_pEventInterface.IsValid())
+	{
+		// Completion events have no payload.
+		static const String ksEmpty;
+
+		// By index, handlers are not expected to queue
+		// events, but doing so is not invalid.
+		for (UInt32 i = 0u; i < m_vEvents.GetSize(); ++i)
+		{
+			auto const e = m_vEvents[i];
+			SEOUL_ANIMATION2D_PROFILE("Animation2D.EventDispatch", &m_pData->GetProfile(), ProfileCounter::kEventDispatch);
+			if (nullptr != e.m_pKeyFrame)
+			{
+				auto const& k = *e.m_pKeyFrame;
+				m_pEventInterface->DispatchEvent(k.m_Id, k.m_i, k.m_f, k.m_s);
+			}
+			else
+			{
+				m_pEventInterface->DispatchEvent(e.m_Id, 0, 0.0f, ksEmpty);
+			}
+		}
+	}
+
+	m_vEvents.Clear();
+
+	// Clips are retained until all their events have been dispatched.
+	m_vEventClips.Clear();
+}
+
+/**
+ * Consecutive events are almost always from the same clip, so a clip
+ * is only retained again when it differs from the most recent one.
+ */
+void DataInstance::QueueEvent(const SharedPtr<Clip>& pClip, const KeyFrameEvent& keyFrame)
+{
+	if (m_vEventClips.IsEmpty() || m_vEventClips.Back() != pClip)
+	{
+		m_vEventClips.PushBack(pClip);
+	}
+	m_vEvents.PushBack(EventRecord(&keyFrame));
+}
+
+/**
+ * Deferred posing - if a frame was evaluated (see MarkCacheEvaluated())
+ * and its cache was not applied, the cache still holds that frame's
+ * accumulated (e.g. additive) channels. Discard them, so that the frame
+ * about to be evaluated does not accumulate on top of them.
+ */
+void DataInstance::DiscardUnappliedCache()
+{
+	if (m_bCacheEvaluated)
+	{
+		m_bCacheEvaluated = false;
+		m_pCache->Clear();
+	}
+}
+
+/**
+ * Discard sleep state, so that the next ApplyCache() applies the
+ * cache unconditionally. Must be called after any change to instance
+ * state that is not made via clip evaluation.
+ */
+void DataInstance::Wake()
+{
+	m_pCache->m_AppliedHold.Reset();
+}
+
+/** @return True if deform timelines should be applied at the current level of detail. */
+Bool DataInstance::IsLodDeformEnabled() const
+{
+	return (m_eLod < LodLevel::kMinimal);
+}
+
+static inline void ClearSlotMask(DataInstance::SlotMask& v)
+{
+	if (!v.IsEmpty())
+	{
+		memset(v.Data(), 0, v.GetSizeInBytes());
+	}
+}
+
 /** Apply the current state of the animation cache to the instance state. This also resets the cache. */
 void DataInstance::ApplyCache()
 {
+	SEOUL_ANIMATION2D_ASSERT_NOT_IN_POSE_BATCH(*this);
+	SEOUL_ANIMATION2D_PROFILE("Animation2D.ApplyCache", &m_pData->GetProfile(), ProfileCounter::kApplyCache);
+
+	m_bCacheEvaluated = false;
+
 	auto const& data = *m_pData;
 	auto const& vBones = data.GetBones();
 	auto const& vIk = data.GetIk();
@@ -143,34 +456,66 @@ void DataInstance::ApplyCache()
 	auto const& vSlotsData = data.GetSlots();
 	auto const& vTransforms = data.GetTransforms();
 
+	// All channels are dense and indexed by target. An entry
+	// was only set this frame if its stamp matches the current generation.
+	auto& cache = *m_pCache;
+	UInt32 const uGeneration = cache.GetGeneration();
+
+	// Reduced rate evaluation at lower levels of detail. Clips were not
+	// sampled this frame, so the current state is held.
+	Bool const bEvaluated = IsLodEvaluationFrame();
+	m_uLodFrame = (m_uLodFrame + 1u) % GetLodEvaluationInterval(m_eLod);
+
+	// A baked pose only replaces posing of an evaluated frame.
+	SharedPtr<BakedClip> pBakedPose;
+	pBakedPose.Swap(m_pBakedPose);
+
+	if (!bEvaluated)
+	{
+		ClearSlotMask(m_vChangedSlots);
+		cache.Clear();
+		return;
+	}
+
+	// Asleep - all clips sampled this frame are held in the same
+	// constant state as when the cache was last applied, so the
+	// state below and the pose would be unchanged.
+	if (m_bSleepEnabled && cache.m_Hold.IsValid() && cache.m_Hold == cache.m_AppliedHold)
+	{
+		ClearSlotMask(m_vChangedSlots);
+		cache.Clear();
+		return;
+	}
+	cache.m_AppliedHold = cache.m_Hold;
+
 	// Draw order.
 	{
-		if (m_pCache->m_vDrawOrder.IsEmpty())
+		if (cache.m_vDrawOrder.IsEmpty())
 		{
 			SetDefaultDrawOrder(vSlotsData.GetSize(), m_vDrawOrder);
 		}
 		else
 		{
-			m_vDrawOrder = m_pCache->m_vDrawOrder;
+			m_vDrawOrder = cache.m_vDrawOrder;
 		}
 	}
 
 	// Attachments.
 	{
-		if (!m_pCache->m_vAttachments.IsEmpty())
+		if (!cache.m_vAttachments.IsEmpty())
 		{
 			// Sort attachments - this should order them such that the highest alpha
 			// attachment changes are last.
-			QuickSort(m_pCache->m_vAttachments.Begin(), m_pCache->m_vAttachments.End());
+			QuickSort(cache.m_vAttachments.Begin(), cache.m_vAttachments.End());
 
-			UInt32 const uSize = m_pCache->m_vAttachments.GetSize();
+			UInt32 const uSize = cache.m_vAttachments.GetSize();
 
 			// Now find the first attachment to apply - we apply all attachments that
 			// have the highest alpha.
 			UInt32 u = uSize - 1u;
 			while (u > 0u)
 			{
-				if (m_pCache->m_vAttachments[u-1u].m_fAlpha < m_pCache->m_vAttachments[u].m_fAlpha)
+				if (cache.m_vAttachments[u-1u].m_fAlpha < cache.m_vAttachments[u].m_fAlpha)
 				{
 					break;
 				}
@@ -181,9 +526,9 @@ void DataInstance::ApplyCache()
 			// will "undo" all the other attachments that aren't part of this set.
 			for (UInt32 i = u; i < uSize; ++i)
 			{
-				auto const& e = m_pCache->m_vAttachments[i];
+				auto const& e = cache.m_vAttachments[i];
 				m_vSlots[e.m_iSlot].m_AttachmentId = e.m_AttachmentId;
-				(void)m_pCache->m_SlotScratch.Insert(e.m_iSlot);
+				cache.m_vSlotScratch[e.m_iSlot] = uGeneration;
 			}
 		}
 
@@ -193,13 +538,15 @@ void DataInstance::ApplyCache()
 		for (Int32 iSlot = 0; iSlot < iSlots; ++iSlot)
 		{
 			// Skip if this was part of the highest weighted set.
-			if (m_pCache->m_SlotScratch.HasKey(iSlot))
+			if (cache.m_vSlotScratch[iSlot] == uGeneration)
 			{
 				continue;
 			}
 
 			m_vSlots[iSlot].m_AttachmentId = vSlotsData[iSlot].m_AttachmentId;
 		}
+
+		InternalUpdateSlotAttachments();
 	}
 
 	// Color.
@@ -210,7 +557,7 @@ void DataInstance::ApplyCache()
 			auto const& base = vSlotsData[iSlot];
 			auto& r = m_vSlots[iSlot];
 
-			auto p = m_pCache->m_tColor.Find(iSlot);
+			auto p = cache.m_Color.Find(uGeneration, iSlot);
 			if (nullptr == p)
 			{
 				r.m_Color = base.m_Color;
@@ -235,7 +582,7 @@ void DataInstance::ApplyCache()
 			auto const& base = vIk[iIk];
 			auto& r = m_vIk[iIk];
 
-			auto p = m_pCache->m_tIk.Find(iIk);
+			auto p = cache.m_Ik.Find(uGeneration, iIk);
 			if (nullptr == p)
 			{
 				r.m_fMix = base.m_fMix;
@@ -266,7 +613,7 @@ void DataInstance::ApplyCache()
 
 			// Path mix.
 			{
-				auto p = m_pCache->m_tPathMix.Find(iPath);
+				auto p = cache.m_PathMix.Find(uGeneration, iPath);
 				if (nullptr == p)
 				{
 					r.m_fPositionMix = base.m_fPositionMix;
@@ -282,7 +629,7 @@ void DataInstance::ApplyCache()
 
 			// Path position.
 			{
-				auto p = m_pCache->m_tPathPosition.Find(iPath);
+				auto p = cache.m_PathPosition.Find(uGeneration, iPath);
 				if (nullptr == p)
 				{
 					r.m_fPosition = base.m_fPosition;
@@ -296,7 +643,7 @@ void DataInstance::ApplyCache()
 
 			// Path spacing.
 			{
-				auto p = m_pCache->m_tPathSpacing.Find(iPath);
+				auto p = cache.m_PathSpacing.Find(uGeneration, iPath);
 				if (nullptr == p)
 				{
 					r.m_fSpacing = base.m_fSpacing;
@@ -318,7 +665,7 @@ void DataInstance::ApplyCache()
 			auto const& base = vTransforms[iTransform];
 			auto& r = m_vTransformConstraintStates[iTransform];
 
-			auto p = m_pCache->m_tTransform.Find(iTransform);
+			auto p = cache.m_Transform.Find(uGeneration, iTransform);
 			if (nullptr == p)
 			{
 				r.m_fPositionMix = base.m_fPositionMix;
@@ -347,7 +694,7 @@ void DataInstance::ApplyCache()
 
 			// Position
 			{
-				auto p = m_pCache->m_tPosition.Find(iBone);
+				auto p = cache.m_Position.Find(uGeneration, iBone);
 				if (nullptr == p)
 				{
 					r.m_fPositionX = base.m_fPositionX;
@@ -363,7 +710,7 @@ void DataInstance::ApplyCache()
 
 			// Rotation.
 			{
-				auto p = m_pCache->m_tRotation.Find(iBone);
+				auto p = cache.m_Rotation.Find(uGeneration, iBone);
 				if (nullptr == p)
 				{
 					r.m_fRotationInDegrees = base.m_fRotationInDegrees;
@@ -376,7 +723,7 @@ void DataInstance::ApplyCache()
 
 			// Scale.
 			{
-				auto p = m_pCache->m_tScale.Find(iBone);
+				auto p = cache.m_Scale.Find(uGeneration, iBone);
 				if (nullptr == p)
 				{
 					r.m_fScaleX = base.m_fScaleX;
@@ -393,7 +740,7 @@ void DataInstance::ApplyCache()
 
 			// Shear.
 			{
-				auto p = m_pCache->m_tShear.Find(iBone);
+				auto p = cache.m_Shear.Find(uGeneration, iBone);
 				if (nullptr == p)
 				{
 					r.m_fShearX = base.m_fShearX;
@@ -409,7 +756,162 @@ void DataInstance::ApplyCache()
 		}
 	}
 
+	cache.Clear();
+
+	// Pose is now out of date, unless baked playback provides
+	// it (see SetBakedPose()).
+	if (pBakedPose.IsValid())
+	{
+		InternalApplyBakedPose(*pBakedPose, m_fBakedPoseTime);
+	}
+	else
+	{
+		m_bPoseDirty = true;
+	}
+}
+
+/**
+ * Baked clip playback - the next ApplyCache() takes the skinning
+ * palette, slots and draw order of the frame from pClip at fTime
+ * instead of posing. The clip must still be evaluated into the cache,
+ * so that bone, ik, path and transform constraint state stay current.
+ */
+void DataInstance::SetBakedPose(const SharedPtr<BakedClip>& pClip, Float fTime)
+{
+	SEOUL_ANIMATION2D_ASSERT_NOT_IN_POSE_BATCH(*this);
+
+	m_pBakedPose = pClip;
+	m_fBakedPoseTime = fTime;
+}
+
+/** Copy the pose state of this instance to r. The pose must be up to date (see Pose()). */
+void DataInstance::CapturePose(DataInstanceSetupPose& r) const
+{
+	r.m_vSkinningPalette = GetSkinningPalette();
+	r.m_vBones = m_vBones;
+	r.m_vDrawOrder = m_vDrawOrder;
+	r.m_vIk = m_vIk;
+	r.m_vPaths = m_vPaths;
+	r.m_vSlots = m_vSlots;
+	r.m_vSlotAttachments = m_vSlotAttachments;
+	r.m_vTransformConstraintStates = m_vTransformConstraintStates;
+}
+
+/**
+ * Set the state of this instance to pose, in place of ApplyCache()
+ * and posing for the current frame. pose must have been captured
+ * (see CapturePose()) from an instance of the same definition.
+ */
+void DataInstance::ApplyPose(const DataInstanceSetupPose& pose)
+{
+	SEOUL_ANIMATION2D_ASSERT_NOT_IN_POSE_BATCH(*this);
+
+	// Same bookkeeping as ApplyCache().
+	m_bCacheEvaluated = false;
+	m_uLodFrame = (m_uLodFrame + 1u) % GetLodEvaluationInterval(m_eLod);
+	m_pCache->m_AppliedHold.Reset();
 	m_pCache->Clear();
+
+	m_vBones = pose.m_vBones;
+	m_vDrawOrder = pose.m_vDrawOrder;
+	m_vIk = pose.m_vIk;
+	m_vPaths = pose.m_vPaths;
+	m_vSkinningPalette = pose.m_vSkinningPalette;
+	m_vSlots = pose.m_vSlots;
+	m_vTransformConstraintStates = pose.m_vTransformConstraintStates;
+
+	// Attachments are already resolved, only track changes.
+	ClearSlotMask(m_vChangedSlots);
+	UInt32 const uSlots = m_vSlots.GetSize();
+	for (UInt32 i = 0u; i < uSlots; ++i)
+	{
+		auto const attachmentId = m_vSlots[i].m_AttachmentId;
+		if (attachmentId != m_vSlotAttachmentIds[i])
+		{
+			m_vSlotAttachmentIds[i] = attachmentId;
+			m_vChangedSlots[i >> 5u] |= (1u << (i & 31u));
+		}
+	}
+	m_vSlotAttachments = pose.m_vSlotAttachments;
+
+	m_bPoseDirty = false;
+
+	if (m_pSnapshots.IsValid())
+	{
+		InternalPublishSnapshot();
+	}
+}
+
+/**
+ * Write the posed vertex positions of the mesh attached to iSlot into
+ * target, in a single pass over the mesh. The deform buffer of the
+ * mesh, if active, is used in place of the mesh's base vertices.
+ *
+ * @return The number of vertices written, or 0 if the slot has
+ * no mesh attached or the mesh data does not match its deform.
+ */
+UInt32 DataInstance::SkinSlot(Int16 iSlot, const SkinningTarget& target) const
+{
+	auto pAttachment = m_vSlotAttachments[iSlot];
+	if (nullptr == pAttachment)
+	{
+		return 0u;
+	}
+
+	MeshAttachment const* pMesh = nullptr;
+	switch (pAttachment->GetType())
+	{
+	case AttachmentType::kLinkedMesh:
+		pMesh = ((LinkedMeshAttachment const*)pAttachment)->GetParent().GetPtr();
+		break;
+	case AttachmentType::kMesh:
+		pMesh = (MeshAttachment const*)pAttachment;
+		break;
+	default:
+		break;
+	}
+
+	if (nullptr == pMesh)
+	{
+		return 0u;
+	}
+
+	auto const& palette = GetSkinningPalette();
+	auto const& slot = m_pData->GetSlots()[iSlot];
+	auto const& vVertices = pMesh->GetVertices();
+
+	CheckedPtr<DeformData> pDeform;
+	(void)m_tDeforms.GetValue(DeformKey(GetActiveSkin(), slot.m_Id, m_vSlots[iSlot].m_AttachmentId), pDeform);
+
+	Float32 const* pSource = (Float32 const*)vVertices.Data();
+	if (pDeform.IsValid())
+	{
+		if (pDeform->GetSize() != 2u * vVertices.GetSize())
+		{
+			return 0u;
+		}
+		pSource = pDeform->Data();
+	}
+
+	if (pMesh->GetBoneCounts().IsEmpty())
+	{
+		if (slot.m_iBone < 0 || (UInt32)slot.m_iBone >= palette.GetSize())
+		{
+			return 0u;
+		}
+
+		SkinningLayout::Transform(palette[slot.m_iBone], pSource, vVertices.GetSize(), target);
+		return vVertices.GetSize();
+	}
+
+	auto const& layout = pMesh->GetSkinningLayout();
+	if (layout.IsEmpty() || layout.GetRequiredBones() > palette.GetSize())
+	{
+		return 0u;
+	}
+
+	layout.Skin(palette.Data(), pSource, target);
+	return layout.GetVertexCount();
 }
 
 /**
@@ -419,6 +921,134 @@ void DataInstance::ApplyCache()
  */
 void DataInstance::PoseSkinningPalette()
 {
+	SEOUL_ANIMATION2D_ASSERT_NOT_IN_POSE_BATCH(*this);
+
+	InternalPoseSkinningPalette();
+
+	if (m_pSnapshots.IsValid())
+	{
+		InternalPublishSnapshot();
+	}
+}
+
+/**
+ * Pose a batch of instances in lockstep. Equivalent to calling
+ * PoseSkinningPalette() on each instance, except that the pose
+ * task list is walked once and each task is applied to every
+ * instance of the batch before moving on to the next. This keeps
+ * the (shared) definition data hot across the batch.
+ *
+ * \pre All instances in ppInstances must share the same DataDefinition
+ * and level of detail.
+ */
+void DataInstance::PoseSkinningPaletteBatch(DataInstance* const* ppInstances, UInt32 uInstances)
+{
+#if !SEOUL_ASSERTIONS_DISABLED
+	for (UInt32 i = 0u; i < uInstances; ++i)
+	{
+		SEOUL_ANIMATION2D_ASSERT_NOT_IN_POSE_BATCH(*ppInstances[i]);
+	}
+#endif // /#if !SEOUL_ASSERTIONS_DISABLED
+
+	InternalPoseSkinningPaletteBatch(ppInstances, uInstances);
+
+	for (UInt32 i = 0u; i < uInstances; ++i)
+	{
+		auto& r = *ppInstances[i];
+		if (r.m_pSnapshots.IsValid())
+		{
+			r.InternalPublishSnapshot();
+		}
+	}
+}
+
+/**
+ * Disabling discards all snapshots - the consumer must not
+ * hold a snapshot of this instance when snapshots are disabled.
+ */
+void DataInstance::SetSnapshotsEnabled(Bool bEnabled)
+{
+	if (bEnabled == m_pSnapshots.IsValid())
+	{
+		return;
+	}
+
+	if (bEnabled)
+	{
+		m_pSnapshots.Reset(SEOUL_NEW(MemoryBudgets::Animation2D) PoseSnapshotBuffer);
+	}
+	else
+	{
+		m_pSnapshots.Reset();
+	}
+}
+
+PoseSnapshot const* DataInstance::AcquireSnapshot() const
+{
+	return (m_pSnapshots.IsValid() ? m_pSnapshots->Acquire() : nullptr);
+}
+
+/** Sample clip at fTime directly into the pose state of this instance. */
+void DataInstance::InternalApplyBakedPose(const BakedClip& clip, Float fTime)
+{
+	clip.Sample(fTime, m_vSkinningPalette, m_vSlots, m_vDrawOrder);
+	InternalUpdateSlotAttachments();
+
+	m_bPoseDirty = false;
+
+	if (m_pSnapshots.IsValid())
+	{
+		InternalPublishSnapshot();
+	}
+}
+
+/**
+ * Copy the render state of this instance into the back buffer of
+ * the snapshots and publish it. Once the buffers are warm (after the
+ * first 3 publishes), this allocates nothing unless the number or
+ * size of active deforms grows.
+ */
+void DataInstance::InternalPublishSnapshot()
+{
+	auto& r = m_pSnapshots->GetBack();
+	r.m_vDrawOrder = m_vDrawOrder;
+	r.m_vSkinningPalette = m_vSkinningPalette;
+	r.m_vSlots = m_vSlots;
+	r.m_vSlotAttachments = m_vSlotAttachments;
+
+	r.m_vDeforms.Clear();
+	r.m_vDeformData.Clear();
+	{
+		auto const iBegin = m_tDeforms.Begin();
+		auto const iEnd = m_tDeforms.End();
+		for (auto i = iBegin; iEnd != i; ++i)
+		{
+			auto const& v = *(i->Second);
+			UInt32 const uOffset = r.m_vDeformData.GetSize();
+			r.m_vDeforms.PushBack(PoseSnapshotDeform(i->First, uOffset, v.GetSize()));
+			r.m_vDeformData.Resize(uOffset + v.GetSize());
+			if (!v.IsEmpty())
+			{
+				memcpy(r.m_vDeformData.Data() + uOffset, v.Data(), v.GetSizeInBytes());
+			}
+		}
+	}
+
+	++r.m_uFrame;
+	auto const uFrame = r.m_uFrame;
+	m_pSnapshots->Publish();
+
+	// Keep the frame counter monotonic across buffers.
+	m_pSnapshots->GetBack().m_uFrame = uFrame;
+}
+
+void DataInstance::InternalPoseSkinningPalette()
+{
+	SEOUL_ANIMATION2D_PROFILE("Animation2D.PoseSkinningPalette", &m_pData->GetProfile(), ProfileCounter::kPose);
+
+	// Pose will be up to date on return.
+	m_bPoseDirty = false;
+
 	// Nothing to do if no bones.
 	UInt32 const u = m_vSkinningPalette.GetSize();
 	if (0u == u)
@@ -432,23 +1062,32 @@ void DataInstance::PoseSkinningPalette()
 	m_vBones[0].ComputeWorldTransform(m_vSkinningPalette[0]);
 
 	// Cache data.
-	auto const& vTasks = m_pData->GetPoseTasks();
+	auto const& vTasks = m_pData->GetPoseTasks(m_eLod);
 
 	// Now process the pose task list.
+	SEOUL_ANIMATION2D_PROFILE_POSE_TASKS(&m_pData->GetProfile());
 	for (auto const& task : vTasks)
 	{
 		switch ((PoseTaskType)task.m_iType)
 		{
 		case PoseTaskType::kBone:
+			SEOUL_ANIMATION2D_PROFILE_POSE_TASK(ProfileCounter::kPoseBone);
 			InternalPoseBone(task.m_iIndex);
 			break;
+		case PoseTaskType::kBoneRun:
+			SEOUL_ANIMATION2D_PROFILE_POSE_TASK(ProfileCounter::kPoseBoneRun);
+			InternalPoseBoneRun(task.m_iIndex);
+			break;
 		case PoseTaskType::kIk:
+			SEOUL_ANIMATION2D_PROFILE_POSE_TASK(ProfileCounter::kPoseIk);
 			InternalPoseIk(task.m_iIndex);
 			break;
 		case PoseTaskType::kPath:
+			SEOUL_ANIMATION2D_PROFILE_POSE_TASK(ProfileCounter::kPosePath);
 			InternalPosePathConstraint(task.m_iIndex);
 			break;
 		case PoseTaskType::kTransform:
+			SEOUL_ANIMATION2D_PROFILE_POSE_TASK(ProfileCounter::kPoseTransform);
 			InternalPoseTransformConstraint(task.m_iIndex);
 			break;
 		default:
@@ -457,8 +1096,107 @@ void DataInstance::PoseSkinningPalette()
 	}
 }
 
+void DataInstance::InternalPoseSkinningPaletteBatch(DataInstance* const* ppInstances, UInt32 uInstances)
+{
+	// Nothing to do if no instances.
+	if (0u == uInstances)
+	{
+		return;
+	}
+
+	auto const& pData = ppInstances[0]->m_pData;
+	auto const eLod = ppInstances[0]->m_eLod;
+
+	SEOUL_ANIMATION2D_PROFILE("Animation2D.PoseSkinningPaletteBatch", &pData->GetProfile(), ProfileCounter::kPose);
+
+#if !SEOUL_ASSERTIONS_DISABLED
+	for (UInt32 i = 1u; i < uInstances; ++i)
+	{
+		SEOUL_ASSERT(ppInstances[i]->m_pData == pData);
+		SEOUL_ASSERT(ppInstances[i]->m_eLod == eLod);
+	}
+#endif // /#if !SEOUL_ASSERTIONS_DISABLED
+
+	// Poses will be up to date on return.
+	for (UInt32 i = 0u; i < uInstances; ++i)
+	{
+		ppInstances[i]->m_bPoseDirty = false;
+	}
+
+	// Nothing to do if no bones.
+	if (pData->GetBones().IsEmpty())
+	{
+		return;
+	}
+
+	// Root node updated first and specially, see PoseSkinningPalette().
+	for (UInt32 i = 0u; i < uInstances; ++i)
+	{
+		auto& r = *ppInstances[i];
+		r.m_vBones[0].ComputeWorldTransform(r.m_vSkinningPalette[0]);
+	}
+
+	// Cache data.
+	auto const& vTasks = pData->GetPoseTasks(eLod);
+
+	// Now process the pose task list, one task for all instances at a time.
+	SEOUL_ANIMATION2D_PROFILE_POSE_TASKS(&pData->GetProfile());
+	for (auto const& task : vTasks)
+	{
+		Int16 const iIndex = task.m_iIndex;
+		switch ((PoseTaskType)task.m_iType)
+		{
+		case PoseTaskType::kBone:
+			SEOUL_ANIMATION2D_PROFILE_POSE_TASK(ProfileCounter::kPoseBone);
+			for (UInt32 i = 0u; i < uInstances; ++i) { ppInstances[i]->InternalPoseBone(iIndex); }
+			break;
+		case PoseTaskType::kBoneRun:
+			SEOUL_ANIMATION2D_PROFILE_POSE_TASK(ProfileCounter::kPoseBoneRun);
+			for (UInt32 i = 0u; i < uInstances; ++i) { ppInstances[i]->InternalPoseBoneRun(iIndex); }
+			break;
+		case PoseTaskType::kIk:
+			SEOUL_ANIMATION2D_PROFILE_POSE_TASK(ProfileCounter::kPoseIk);
+			for (UInt32 i = 0u; i < uInstances; ++i) { ppInstances[i]->InternalPoseIk(iIndex); }
+			break;
+		case PoseTaskType::kPath:
+			SEOUL_ANIMATION2D_PROFILE_POSE_TASK(ProfileCounter::kPosePath);
+			for (UInt32 i = 0u; i < uInstances; ++i) { ppInstances[i]->InternalPosePathConstraint(iIndex); }
+			break;
+		case PoseTaskType::kTransform:
+			SEOUL_ANIMATION2D_PROFILE_POSE_TASK(ProfileCounter::kPoseTransform);
+			for (UInt32 i = 0u; i < uInstances; ++i) { ppInstances[i]->InternalPoseTransformConstraint(iIndex); }
+			break;
+		default:
+			break;
+		};
+	}
+}
+
 void DataInstance::InternalConstruct()
 {
+	// Common case, copy the precomputed setup pose.
+	auto const pSetupPose = m_pData->GetSetupPose();
+	if (nullptr != pSetupPose)
+	{
+		m_vBones = pSetupPose->m_vBones;
+		m_vDrawOrder = pSetupPose->m_vDrawOrder;
+		m_vIk = pSetupPose->m_vIk;
+		m_vPaths = pSetupPose->m_vPaths;
+		m_vSkinningPalette = pSetupPose->m_vSkinningPalette;
+		m_vSlots = pSetupPose->m_vSlots;
+		m_vSlotAttachments = pSetupPose->m_vSlotAttachments;
+		m_vTransformConstraintStates = pSetupPose->m_vTransformConstraintStates;
+
+		UInt32 const uSlots = m_vSlots.GetSize();
+		m_vSlotAttachmentIds.Resize(uSlots);
+		for (auto i = 0u; i < uSlots; ++i) { m_vSlotAttachmentIds[i] = m_vSlots[i].m_AttachmentId; }
+		m_vChangedSlots.Resize((uSlots + 31u) / 32u, UInt32(~0u));
+
+		// The setup pose is fully posed.
+		m_bPoseDirty = false;
+		return;
+	}
+
 	auto const& vBones = m_pData->GetBones();
 	auto const& vIk = m_pData->GetIk();
 	auto const& vPaths = m_pData->GetPaths();
@@ -486,43 +1224,128 @@ void DataInstance::InternalConstruct()
 	for (auto i = 0u; i < uSlots; ++i) { m_vSlots[i].Assign(vSlots[i]); }
 	for (auto i = 0u; i < uTransforms; ++i) { m_vTransformConstraintStates[i].Assign(vTransforms[i]); }
 
-	PoseSkinningPalette();
+	m_vSlotAttachmentIds.Resize(uSlots);
+	m_vSlotAttachments.Resize(uSlots, nullptr);
+	for (auto i = 0u; i < uSlots; ++i)
+	{
+		m_vSlotAttachmentIds[i] = m_vSlots[i].m_AttachmentId;
+		m_vSlotAttachments[i] = InternalResolveSlotAttachment((Int16)i, m_vSlotAttachmentIds[i]);
+	}
+	m_vChangedSlots.Resize((uSlots + 31u) / 32u, UInt32(~0u));
+
+	// Posing is deferred until the pose is first needed.
+	m_bPoseDirty = true;
 }
 
-SharedPtr<PathAttachment const> DataInstance::InternalGetPathAttachment(Int16 iTarget) const
+/**
+ * @return The attachment attachmentId of slot iSlot in the active skin,
+ * or nullptr if attachmentId is empty or not defined.
+ */
+Attachment const* DataInstance::InternalResolveSlotAttachment(Int16 iSlot, HString attachmentId) const
 {
-	auto const& slotData = m_pData->GetSlots()[iTarget];
+	if (attachmentId.IsEmpty())
+	{
+		return nullptr;
+	}
+
+	auto pSkin = m_pData->GetSkins().Find(GetActiveSkin());
+	if (nullptr == pSkin)
+	{
+		return nullptr;
+	}
+
+	auto pSets = pSkin->Find(m_pData->GetSlots()[iSlot].m_Id);
+	if (nullptr == pSets)
+	{
+		return nullptr;
+	}
+
+	auto ppAttachment = pSets->Find(attachmentId);
+	if (nullptr == ppAttachment)
+	{
+		return nullptr;
+	}
+
+	return ppAttachment->GetPtr();
+}
+
+/**
+ * Refresh the resolved attachment of any slot whose attachment id
+ * differs from the id it was last resolved against, and record
+ * those slots in the changed slots mask. Comparing ids (rather than
+ * tracking assignments) also catches changes made via GetSlots().
+ */
+void DataInstance::InternalUpdateSlotAttachments()
+{
+	ClearSlotMask(m_vChangedSlots);
+
+	UInt32 const uSlots = m_vSlots.GetSize();
+	for (UInt32 i = 0u; i < uSlots; ++i)
+	{
+		auto const attachmentId = m_vSlots[i].m_AttachmentId;
+		if (attachmentId == m_vSlotAttachmentIds[i])
+		{
+			continue;
+		}
+
+		m_vSlotAttachmentIds[i] = attachmentId;
+		m_vSlotAttachments[i] = InternalResolveSlotAttachment((Int16)i, attachmentId);
+		m_vChangedSlots[i >> 5u] |= (1u << (i & 31u));
+	}
+}
+
+/**
+ * @return The path attachment of the target slot of path constraint iPath,
+ * or nullptr if the slot has no path attachment. The result is cached
+ * on the PathInstance and only resolved again when the attachment
+ * of the slot changes.
+ */
+PathAttachment const* DataInstance::InternalGetPathAttachment(Int16 iPath)
+{
+	auto& state = m_vPaths[iPath];
+	auto const iTarget = m_pData->GetPaths()[iPath].m_iTarget;
 	auto const attachmentId = m_vSlots[iTarget].m_AttachmentId;
+	if (attachmentId != state.m_AttachmentId)
+	{
+		state.m_AttachmentId = attachmentId;
+		state.m_pAttachment = InternalResolvePathAttachment(iTarget, attachmentId);
+	}
+
+	return state.m_pAttachment;
+}
 
+PathAttachment const* DataInstance::InternalResolvePathAttachment(Int16 iTarget, HString attachmentId) const
+{
 	if (attachmentId.IsEmpty())
 	{
-		return SharedPtr<PathAttachment const>();
+		return nullptr;
 	}
 
 	auto pSkin = m_pData->GetSkins().Find(kDefaultSkin /* The path attachments appear to always be on the default skin */);
 	if (nullptr == pSkin)
 	{
-		return SharedPtr<PathAttachment const>();
+		return nullptr;
 	}
 
+	auto const& slotData = m_pData->GetSlots()[iTarget];
 	auto pSets = pSkin->Find(slotData.m_Id);
-	if (nullptr == pSkin)
+	if (nullptr == pSets)
 	{
-		return SharedPtr<PathAttachment const>();
+		return nullptr;
 	}
 
 	SharedPtr<Attachment> pAttachment;
 	if (!pSets->GetValue(attachmentId, pAttachment))
 	{
-		return SharedPtr<PathAttachment const>();
+		return nullptr;
 	}
 
 	if (pAttachment->GetType() != AttachmentType::kPath)
 	{
-		return SharedPtr<PathAttachment const>();
+		return nullptr;
 	}
 
-	return SharedPtr<PathAttachment const>((PathAttachment const*)pAttachment.GetPtr());
+	return (PathAttachment const*)pAttachment.GetPtr();
 }
 
 void DataInstance::InternalPoseBone(Int16 iBone)
@@ -539,6 +1362,180 @@ void DataInstance::InternalPoseBone(Int16 iBone)
 		state.m_fShearY);
 }
 
+/** Width of the structure-of-arrays blocks processed by InternalPoseBoneRun(). */
+static const UInt32 kuPoseBoneLanes = 8u;
+
+#if SEOUL_ANIMATION2D_SSE_POSE
+/**
+ * Sine and cosine of 4 angles (in radians). The angles are reduced
+ * by multiples of pi/2 (in 3 parts, Cody-Waite), then evaluated with the
+ * single precision minimax polynomials of Cephes on [-pi/4, pi/4]. Absolute
+ * error is within ~1e-7 of Sin()/Cos() for |angle| < ~8000 radians.
+ */
+static inline void SinCos4(__m128 vAngle, __m128& rvSin, __m128& rvCos)
+{
+	// Quadrant and remainder.
+	__m128i const vQ = _mm_cvtps_epi32(_mm_mul_ps(vAngle, _mm_set1_ps(0.63661977236758134f)));
+	__m128 const vQf = _mm_cvtepi32_ps(vQ);
+	__m128 vR = _mm_sub_ps(vAngle, _mm_mul_ps(vQf, _mm_set1_ps(1.5703125f)));
+	vR = _mm_sub_ps(vR, _mm_mul_ps(vQf, _mm_set1_ps(4.837512969970703125e-4f)));
+	vR = _mm_sub_ps(vR, _mm_mul_ps(vQf, _mm_set1_ps(7.54978995489188216e-8f)));
+	__m128 const vR2 = _mm_mul_ps(vR, vR);
+
+	// sin(r) and cos(r).
+	__m128 vS = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(-1.9515295891e-4f), vR2), _mm_set1_ps(8.3321608736e-3f));
+	vS = _mm_add_ps(_mm_mul_ps(vS, vR2), _mm_set1_ps(-1.6666654611e-1f));
+	vS = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(vS, vR2), vR), vR);
+	__m128 vC = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(2.443315711809948e-5f), vR2), _mm_set1_ps(-1.388731625493765e-3f));
+	vC = _mm_add_ps(_mm_mul_ps(vC, vR2), _mm_set1_ps(4.166664568298827e-2f));
+	vC = _mm_mul_ps(_mm_mul_ps(vC, vR2), vR2);
+	vC = _mm_add_ps(_mm_sub_ps(vC, _mm_mul_ps(vR2, _mm_set1_ps(0.5f))), _mm_set1_ps(1.0f));
+
+	// Odd quadrants swap sin and cos, sign of sin flips in quadrants
+	// 2 and 3, sign of cos flips in quadrants 1 and 2.
+	__m128i const vOne = _mm_set1_epi32(1);
+	__m128i const vTwo = _mm_set1_epi32(2);
+	__m128 const vSwap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(vQ, vOne), vOne));
+	__m128 const vSinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(vQ, vTwo), 30));
+	__m128 const vCosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(vQ, vOne), vTwo), 30));
+	rvSin = _mm_xor_ps(_mm_or_ps(_mm_and_ps(vSwap, vC), _mm_andnot_ps(vSwap, vS)), vSinSign);
+	rvCos = _mm_xor_ps(_mm_or_ps(_mm_and_ps(vSwap, vS), _mm_andnot_ps(vSwap, vC)), vCosSign);
+}
+#endif // /#if SEOUL_ANIMATION2D_SSE_POSE
+
+/**
+ * Pose a run of independent bones with TransformMode::kNormal
+ * (see DataDefinition::ComputePoseBoneRuns()). Equivalent to calling
+ * InternalPoseBone() on each bone of the run.
+ *
+ * Bone state is gathered into fixed width structure-of-arrays blocks.
+ * With SSE2, each group of 4 lanes is posed with intrinsics and SinCos4()
+ * (results differ from InternalPoseBone() by the ~1e-7 trig error),
+ * otherwise with scalar loops. Groups past the end of the run are skipped.
+ */
+void DataInstance::InternalPoseBoneRun(Int16 iRun)
+{
+	auto const& run = m_pData->GetPoseBoneRuns()[iRun];
+	auto const& vData = m_pData->GetBones();
+	Int16 const* const pi = m_pData->GetPoseBoneRunBones().Get(run.m_uOffset);
+	UInt32 const uCount = run.m_uCount;
+
+	alignas(16) Float32 aRX[kuPoseBoneLanes];
+	alignas(16) Float32 aRY[kuPoseBoneLanes];
+	alignas(16) Float32 aL00[kuPoseBoneLanes];
+	alignas(16) Float32 aL01[kuPoseBoneLanes];
+	alignas(16) Float32 aL10[kuPoseBoneLanes];
+	alignas(16) Float32 aL11[kuPoseBoneLanes];
+	alignas(16) Float32 aLTX[kuPoseBoneLanes];
+	alignas(16) Float32 aLTY[kuPoseBoneLanes];
+	alignas(16) Float32 aP00[kuPoseBoneLanes];
+	alignas(16) Float32 aP01[kuPoseBoneLanes];
+	alignas(16) Float32 aP10[kuPoseBoneLanes];
+	alignas(16) Float32 aP11[kuPoseBoneLanes];
+	alignas(16) Float32 aPTX[kuPoseBoneLanes];
+	alignas(16) Float32 aPTY[kuPoseBoneLanes];
+
+	for (UInt32 uBlock = 0u; uBlock < uCount; uBlock += kuPoseBoneLanes)
+	{
+		UInt32 const uLanes = Min(kuPoseBoneLanes, uCount - uBlock);
+		Int16 const* const piBlock = pi + uBlock;
+
+		// Gather - unused lanes of the last group of 4 are filled
+		// with the last bone of the block.
+		UInt32 const uGather = Min(kuPoseBoneLanes, (uLanes + 3u) & ~3u);
+		for (UInt32 u = 0u; u < uGather; ++u)
+		{
+			auto const iBone = piBlock[Min(u, uLanes - 1u)];
+			auto const& bone = m_vBones[iBone];
+			auto const& mParent = m_vSkinningPalette[vData[iBone].m_iParent];
+
+			aRX[u] = DegreesToRadians(bone.m_fRotationInDegrees + bone.m_fShearX);
+			aRY[u] = DegreesToRadians(bone.m_fRotationInDegrees + 90.0f + bone.m_fShearY);
+			aL00[u] = bone.m_fScaleX;
+			aL01[u] = bone.m_fScaleY;
+			aLTX[u] = bone.m_fPositionX;
+			aLTY[u] = bone.m_fPositionY;
+			aP00[u] = mParent.M00;
+			aP01[u] = mParent.M01;
+			aP10[u] = mParent.M10;
+			aP11[u] = mParent.M11;
+			aPTX[u] = mParent.TX;
+			aPTY[u] = mParent.TY;
+		}
+
+#if SEOUL_ANIMATION2D_SSE_POSE
+		for (UInt32 u = 0u; u < uGather; u += 4u)
+		{
+			// Local upper 2x2 - see BoneInstance::ComputeWorldTransform().
+			__m128 vSinX, vCosX, vSinY, vCosY;
+			SinCos4(_mm_load_ps(aRX + u), vSinX, vCosX);
+			SinCos4(_mm_load_ps(aRY + u), vSinY, vCosY);
+			__m128 const vScaleX = _mm_load_ps(aL00 + u);
+			__m128 const vScaleY = _mm_load_ps(aL01 + u);
+			__m128 const vL00 = _mm_mul_ps(vCosX, vScaleX);
+			__m128 const vL01 = _mm_mul_ps(vCosY, vScaleY);
+			__m128 const vL10 = _mm_mul_ps(vSinX, vScaleX);
+			__m128 const vL11 = _mm_mul_ps(vSinY, vScaleY);
+			__m128 const vLTX = _mm_load_ps(aLTX + u);
+			__m128 const vLTY = _mm_load_ps(aLTY + u);
+
+			// World transform, mParent * mLocal. Results are written back
+			// into the local arrays.
+			__m128 const vP00 = _mm_load_ps(aP00 + u);
+			__m128 const vP01 = _mm_load_ps(aP01 + u);
+			__m128 const vP10 = _mm_load_ps(aP10 + u);
+			__m128 const vP11 = _mm_load_ps(aP11 + u);
+			_mm_store_ps(aL00 + u, _mm_add_ps(_mm_mul_ps(vP00, vL00), _mm_mul_ps(vP01, vL10)));
+			_mm_store_ps(aL01 + u, _mm_add_ps(_mm_mul_ps(vP00, vL01), _mm_mul_ps(vP01, vL11)));
+			_mm_store_ps(aL10 + u, _mm_add_ps(_mm_mul_ps(vP10, vL00), _mm_mul_ps(vP11, vL10)));
+			_mm_store_ps(aL11 + u, _mm_add_ps(_mm_mul_ps(vP10, vL01), _mm_mul_ps(vP11, vL11)));
+			_mm_store_ps(aLTX + u, _mm_add_ps(_mm_add_ps(_mm_mul_ps(vP00, vLTX), _mm_mul_ps(vP01, vLTY)), _mm_load_ps(aPTX + u)));
+			_mm_store_ps(aLTY + u, _mm_add_ps(_mm_add_ps(_mm_mul_ps(vP10, vLTX), _mm_mul_ps(vP11, vLTY)), _mm_load_ps(aPTY + u)));
+		}
+#else
+		// Local upper 2x2 - see BoneInstance::ComputeWorldTransform().
+		for (UInt32 u = 0u; u < uLanes; ++u)
+		{
+			aL10[u] = Sin(aRX[u]) * aL00[u];
+			aL00[u] = Cos(aRX[u]) * aL00[u];
+			aL11[u] = Sin(aRY[u]) * aL01[u];
+			aL01[u] = Cos(aRY[u]) * aL01[u];
+		}
+
+		// World transform, mParent * mLocal. Results are written back
+		// into the local arrays.
+		for (UInt32 u = 0u; u < uLanes; ++u)
+		{
+			Float32 const f00 = aP00[u] * aL00[u] + aP01[u] * aL10[u];
+			Float32 const f01 = aP00[u] * aL01[u] + aP01[u] * aL11[u];
+			Float32 const f10 = aP10[u] * aL00[u] + aP11[u] * aL10[u];
+			Float32 const f11 = aP10[u] * aL01[u] + aP11[u] * aL11[u];
+			Float32 const fTX = aP00[u] * aLTX[u] + aP01[u] * aLTY[u] + aPTX[u];
+			Float32 const fTY = aP10[u] * aLTX[u] + aP11[u] * aLTY[u] + aPTY[u];
+
+			aL00[u] = f00;
+			aL01[u] = f01;
+			aL10[u] = f10;
+			aL11[u] = f11;
+			aLTX[u] = fTX;
+			aLTY[u] = fTY;
+		}
+#endif // /#if SEOUL_ANIMATION2D_SSE_POSE
+
+		// Scatter.
+		for (UInt32 u = 0u; u < uLanes; ++u)
+		{
+			auto& r = m_vSkinningPalette[piBlock[u]];
+			r.M00 = aL00[u];
+			r.M01 = aL01[u];
+			r.M10 = aL10[u];
+			r.M11 = aL11[u];
+			r.TX = aLTX[u];
+			r.TY = aLTY[u];
+		}
+	}
+}
+
 void DataInstance::InternalPoseBone(
 	Int16 iBone,
 	Float fPositionX,
@@ -1068,6 +2065,40 @@ break_outer:
 		stateC.m_fShearY);
 }
 
+/**
+ * Scratch buffers of path constraint solving. Shared by all path
+ * constraints posed on a thread, instead of each PathInstance
+ * owning its own set of growable buffers.
+ */
+struct PathScratch SEOUL_SEALED
+{
+	typedef Vector<Float32, MemoryBudgets::Animation2D> Floats;
+	typedef FixedArray<Float32, 10> Segments;
+
+	PathScratch()
+		: m_vCurves()
+		, m_vLengths()
+		, m_vPositions()
+		, m_aSegments()
+		, m_vSpaces()
+		, m_vWorld()
+	{
+	}
+
+	Floats m_vCurves;
+	Floats m_vLengths;
+	Floats m_vPositions;
+	Segments m_aSegments;
+	Floats m_vSpaces;
+	Floats m_vWorld;
+}; // struct PathScratch
+
+static PathScratch& GetPathScratch()
+{
+	static thread_local PathScratch s_Scratch;
+	return s_Scratch;
+}
+
 /**
  * Part of path constraint application.
  *
@@ -1087,8 +2118,8 @@ void DataInstance::InternalPosePathConstraint(Int16 iPath)
 	}
 
 	auto const& data = m_pData->GetPaths()[iPath];
-	auto const pPathAttachment = InternalGetPathAttachment(data.m_iTarget);
-	if (!pPathAttachment.IsValid())
+	auto const pPathAttachment = InternalGetPathAttachment(iPath);
+	if (nullptr == pPathAttachment)
 	{
 		return;
 	}
@@ -1100,10 +2131,11 @@ void DataInstance::InternalPosePathConstraint(Int16 iPath)
 	UInt32 const uBones = data.m_viBones.GetSize();
 	UInt32 const uSpaces = (bTangents ? uBones : (uBones + 1u));
 
-	state.m_vSpaces.Clear();
-	state.m_vSpaces.Resize(uSpaces);
-	auto& vSpaces = state.m_vSpaces;
-	auto& vLengths = state.m_vLengths;
+	auto& scratch = GetPathScratch();
+	scratch.m_vSpaces.Clear();
+	scratch.m_vSpaces.Resize(uSpaces);
+	auto& vSpaces = scratch.m_vSpaces;
+	auto& vLengths = scratch.m_vLengths;
 	Float32 const fSpacing = state.m_fSpacing;
 	if (bScale || !bPercentSpacing)
 	{
@@ -1334,12 +2366,12 @@ static void AddCurvePosition(Float32 p, Float32 x1, Float32 y1, Float32 cx1, Flo
  */
 static inline const PathAttachment::Vertices& ResolveVertices(
 	const DataInstance& instance,
-	const SharedPtr<PathAttachment const>& p)
+	PathAttachment const* p)
 {
 	auto const slot = p->GetSlot();
 	auto const id = p->GetId();
 
-	DeformKey const key(kDefaultSkin /* TODO: Need to use the active skin. */, slot, id);
+	DeformKey const key(instance.GetActiveSkin(), slot, id);
 
 	CheckedPtr<DataInstance::DeformData> pData;
 	(void)instance.GetDeforms().GetValue(key, pData);
@@ -1364,7 +2396,7 @@ static void TransformToWorld(
 	const DataInstance& instance,
 	const DataInstance::SkinningPalette& vPalette,
 	const Matrix2x3& m,
-	const SharedPtr<PathAttachment const>& pPathAttachment,
+	PathAttachment const* pPathAttachment,
 	UInt32 uStart,
 	UInt32 uCount,
 	Vector<Float, MemoryBudgets::Animation2D>& rvOut,
@@ -1429,7 +2461,7 @@ static void TransformToWorld(
  */
 Float32 const* DataInstance::InternalPosePathConstraintPoints(
 	Int16 iPath,
-	const SharedPtr<PathAttachment const>& pPathAttachment,
+	PathAttachment const* pPathAttachment,
 	UInt32 uSpaces,
 	Bool bTangents,
 	Bool bPosition,
@@ -1443,14 +2475,15 @@ Float32 const* DataInstance::InternalPosePathConstraintPoints(
 	auto& state = m_vPaths[iPath];
 	auto const& mWorld = m_vSkinningPalette[m_pData->GetSlots()[data.m_iTarget].m_iBone];
 
+	auto& scratch = GetPathScratch();
 	Float32 fPosition = state.m_fPosition;
-	auto& vSpaces = state.m_vSpaces;
+	auto& vSpaces = scratch.m_vSpaces;
 
-	state.m_vPositions.Clear();
-	state.m_vPositions.Resize(uSpaces * 3u + 2u);
-	auto& vOutput = state.m_vPositions;
+	scratch.m_vPositions.Clear();
+	scratch.m_vPositions.Resize(uSpaces * 3u + 2u);
+	auto& vOutput = scratch.m_vPositions;
 
-	auto& vWorld = state.m_vWorld;
+	auto& vWorld = scratch.m_vWorld;
 	vWorld.Clear();
 	Bool const bClosed = (pPathAttachment->GetClosed());
 	UInt32 uVertexComponents = (pPathAttachment->GetVertexCount());
@@ -1583,7 +2616,7 @@ Float32 const* DataInstance::InternalPosePathConstraintPoints(
 	}
 
 	// Curve vLengths.
-	auto& vCurves = state.m_vCurves;
+	auto& vCurves = scratch.m_vCurves;
 	vCurves.Clear();
 	vCurves.Resize(iCurveCount);
 	fPathLength = 0;
@@ -1653,7 +2686,7 @@ Float32 const* DataInstance::InternalPosePathConstraintPoints(
 		}
 	}
 
-	auto& aSegments = state.m_aSegments;
+	auto& aSegments = scratch.m_aSegments;
 	Float32 fCurveLength = 0;
 	for (Int32 i = 0, o = 0, iCurve = 0, segment = 0; i < (Int32)uSpaces; i++, o += 3)
 	{
@@ -2126,6 +3159,19 @@ void DataInstance::InternalPoseTransformConstraintRelativeLocal(Int16 iTransform
 	}
 }
 
+UInt32 DataInstanceSetupPose::GetHeapSize() const
+{
+	return
+		Animation2D::GetHeapSize(m_vBones) +
+		Animation2D::GetHeapSize(m_vDrawOrder) +
+		Animation2D::GetHeapSize(m_vIk) +
+		Animation2D::GetHeapSize(m_vPaths) +
+		Animation2D::GetHeapSize(m_vSkinningPalette) +
+		Animation2D::GetHeapSize(m_vSlots) +
+		Animation2D::GetHeapSize(m_vSlotAttachments) +
+		Animation2D::GetHeapSize(m_vTransformConstraintStates);
+}
+
 } // namespace Animation2D
 
 } // namespace Seoul
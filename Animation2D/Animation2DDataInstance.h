@@ -10,6 +10,7 @@
 #ifndef ANIMATION2D_DATA_INSTANCE_H
 #define ANIMATION2D_DATA_INSTANCE_H
 
+#include "AnimationClipSettings.h"
 #include "Delegate.h"
 #include "HashTable.h"
 #include "Matrix2x3.h"
@@ -17,15 +18,26 @@
 #include "ScopedPtr.h"
 #include "SharedPtr.h"
 #include "StandardVertex2D.h"
+#include "ThreadId.h"
 #include "Vector.h"
 #include "Vector2D.h"
 namespace Seoul { namespace Animation { class EventInterface; } }
+namespace Seoul { namespace Animation2D { class Attachment; } }
+namespace Seoul { namespace Animation2D { class BakedClip; } }
 namespace Seoul { namespace Animation2D { struct Cache; } }
+namespace Seoul { namespace Animation2D { class Clip; } }
+namespace Seoul { namespace Animation2D { class ClipInstance; } }
 namespace Seoul { namespace Animation2D { class DataDefinition; } }
+namespace Seoul { namespace Animation2D { struct DataInstanceSetupPose; } }
 namespace Seoul { namespace Animation2D { struct BoneDefinition; } }
 namespace Seoul { namespace Animation2D { struct IkDefinition; } }
+namespace Seoul { namespace Animation2D { struct KeyFrameEvent; } }
+namespace Seoul { namespace Animation2D { enum class LodLevel : Int32; } }
 namespace Seoul { namespace Animation2D { class PathAttachment; } }
+namespace Seoul { namespace Animation2D { struct PoseSnapshot; } }
+namespace Seoul { namespace Animation2D { class PoseSnapshotBuffer; } }
 namespace Seoul { namespace Animation2D { struct PathDefinition; } }
+namespace Seoul { namespace Animation2D { struct SkinningTarget; } }
 namespace Seoul { namespace Animation2D { struct SlotDataDefinition; } }
 namespace Seoul { namespace Animation2D { struct TransformConstraintDefinition; } }
 
@@ -158,16 +170,9 @@ struct IkInstance SEOUL_SEALED
 
 struct PathInstance SEOUL_SEALED
 {
-	typedef Vector<Float32, MemoryBudgets::Animation2D> Floats;
-	typedef FixedArray<Float32, 10> Segments;
-
 	PathInstance()
-		: m_vCurves()
-		, m_vLengths()
-		, m_vPositions()
-		, m_aSegments()
-		, m_vSpaces()
-		, m_vWorld()
+		: m_AttachmentId()
+		, m_pAttachment(nullptr)
 		, m_fPosition(0.0f)
 		, m_fPositionMix(1.0f)
 		, m_fRotationMix(1.0f)
@@ -177,12 +182,10 @@ struct PathInstance SEOUL_SEALED
 
 	PathInstance& Assign(const PathDefinition& data);
 
-	Floats m_vCurves;
-	Floats m_vLengths;
-	Floats m_vPositions;
-	Segments m_aSegments;
-	Floats m_vSpaces;
-	Floats m_vWorld;
+	// Resolved path attachment of the target slot, valid
+	// while the attachment of the slot is m_AttachmentId.
+	HString m_AttachmentId;
+	PathAttachment const* m_pAttachment;
 	Float32 m_fPosition;
 	Float32 m_fPositionMix;
 	Float32 m_fRotationMix;
@@ -228,9 +231,29 @@ struct TransformConstraintInstance SEOUL_SEALED
 	Float m_fShearMix;
 }; // struct TransformConstraintInstance
 
+/**
+ * An event queued for dispatch by DataInstance::FlushEvents(). Timeline
+ * events refer to their key frame, which is owned by a Clip - the queue
+ * retains that Clip until the event is flushed (see DataInstance::QueueEvent()).
+ * Completion events (no key frame) carry only an id.
+ */
+struct EventRecord SEOUL_SEALED
+{
+	EventRecord(KeyFrameEvent const* pKeyFrame = nullptr, HString id = HString())
+		: m_pKeyFrame(pKeyFrame)
+		, m_Id(id)
+	{
+	}
+
+	KeyFrameEvent const* m_pKeyFrame;
+	HString m_Id;
+}; // struct EventRecord
+
 } // namespace Animation2D
 template <> struct CanMemCpy<Animation2D::BoneInstance> { static const Bool Value = true; };
+template <> struct CanMemCpy<Animation2D::EventRecord> { static const Bool Value = true; };
 template <> struct CanMemCpy<Animation2D::IkInstance> { static const Bool Value = true; };
+template <> struct CanMemCpy<Animation2D::PathInstance> { static const Bool Value = true; };
 template <> struct CanMemCpy<Animation2D::SlotInstance> { static const Bool Value = true; };
 template <> struct CanMemCpy<Animation2D::TransformConstraintInstance> { static const Bool Value = true; };
 
@@ -253,17 +276,71 @@ struct DefaultHashTableKeyTraits<Animation2D::DeformKey>
 namespace Animation2D
 {
 
+/** Breakdown of the memory footprint of one or more DataInstances, in bytes. */
+struct DataInstanceMemoryUsage SEOUL_SEALED
+{
+	DataInstanceMemoryUsage()
+		: m_uInstance(0u)
+		, m_uCache(0u)
+		, m_uClipInstances(0u)
+		, m_uDeforms(0u)
+		, m_uPaths(0u)
+		, m_uPose(0u)
+		, m_uSnapshots(0u)
+	{
+	}
+
+	DataInstanceMemoryUsage& operator+=(const DataInstanceMemoryUsage& b)
+	{
+		m_uInstance += b.m_uInstance;
+		m_uCache += b.m_uCache;
+		m_uClipInstances += b.m_uClipInstances;
+		m_uDeforms += b.m_uDeforms;
+		m_uPaths += b.m_uPaths;
+		m_uPose += b.m_uPose;
+		m_uSnapshots += b.m_uSnapshots;
+		return *this;
+	}
+
+	UInt32 GetTotal() const
+	{
+		return m_uInstance + m_uCache + m_uClipInstances + m_uDeforms + m_uPaths + m_uPose + m_uSnapshots;
+	}
+
+	// sizeof(DataInstance).
+	UInt32 m_uInstance;
+	// Animation accumulator tables and queued events.
+	UInt32 m_uCache;
+	// Pooled (inactive) ClipInstances.
+	UInt32 m_uClipInstances;
+	// Deform buffers and their reference counts.
+	UInt32 m_uDeforms;
+	// Path constraint state and scratch buffers.
+	UInt32 m_uPaths;
+	// Bones, slots, constraints, draw order and skinning palette.
+	UInt32 m_uPose;
+	// Published pose snapshots, see DataInstance::SetSnapshotsEnabled().
+	UInt32 m_uSnapshots;
+}; // struct DataInstanceMemoryUsage
+
 class DataInstance SEOUL_SEALED
 {
 public:
 	typedef Vector<BoneInstance, MemoryBudgets::Animation2D> BoneInstances;
+	typedef Vector<CheckedPtr<ClipInstance>, MemoryBudgets::Animation2D> ClipInstancePool;
 	typedef Vector<Float, MemoryBudgets::Animation2D> DeformData;
+	typedef Vector<CheckedPtr<DeformData>, MemoryBudgets::Animation2D> DeformPool;
 	typedef HashTable<DeformKey, CheckedPtr<DeformData>, MemoryBudgets::Animation2D> Deforms;
 	typedef HashTable<DeformKey, Int32, MemoryBudgets::Animation2D> DeformReferences;
 	typedef Vector<Int16, MemoryBudgets::Animation2D> DrawOrder;
+	typedef Vector<SharedPtr<Clip>, MemoryBudgets::Animation2D> EventClips;
+	typedef Vector<EventRecord, MemoryBudgets::Animation2D> EventQueue;
 	typedef Vector<IkInstance, MemoryBudgets::Animation2D> IkInstances;
 	typedef Vector<PathInstance, MemoryBudgets::Animation2D> PathInstances;
 	typedef Vector<Matrix2x3, MemoryBudgets::Animation2D> SkinningPalette;
+	typedef Vector<HString, MemoryBudgets::Animation2D> SlotAttachmentIds;
+	typedef Vector<Attachment const*, MemoryBudgets::Animation2D> SlotAttachments;
+	typedef Vector<UInt32, MemoryBudgets::Animation2D> SlotMask;
 	typedef Vector<SlotInstance, MemoryBudgets::Animation2D> SlotInstances;
 	typedef Vector<TransformConstraintInstance, MemoryBudgets::Animation2D> TransformConstraintStates;
 
@@ -272,6 +349,19 @@ public:
 
 	DataInstance* Clone() const;
 
+	// Memory footprint of this instance, by category.
+	void GetMemoryUsage(DataInstanceMemoryUsage& r) const;
+
+	// Pooled construction of ClipInstances bound to this DataInstance.
+	// Instances must be returned with ReleaseClipInstance(). Once the
+	// pool is warm, acquiring an instance allocates nothing in the
+	// common case.
+	CheckedPtr<ClipInstance> AcquireClipInstance(const SharedPtr<Clip>& pClip, const Animation::ClipSettings& settings);
+	void ReleaseClipInstance(CheckedPtr<ClipInstance>& rp);
+
+	// Number of ClipInstances currently acquired and not yet released.
+	UInt32 GetActiveClipInstanceCount() const { return m_uActiveClipInstances; }
+
 	const BoneInstances& GetBones() const { return m_vBones; }
 	BoneInstances& GetBones() { return m_vBones; }
 
@@ -282,9 +372,20 @@ public:
 	const SharedPtr<Animation::EventInterface>& GetEventInterface() const { return m_pEventInterface; }
 	const SharedPtr<DataDefinition const>& GetData() const { return m_pData; }
 
+	// The skin used to resolve the attachments and deforms of this instance.
+	HString GetActiveSkin() const;
+
 	const Deforms& GetDeforms() const { return m_tDeforms; }
 	Deforms& GetDeforms() { return m_tDeforms; }
 
+	// Activate the deform buffer of key, sized to uSize. Buffers are taken
+	// from a pool owned by this instance. rbActivated is true if key
+	// was not already active, in which case the buffer contents are undefined.
+	DeformData& ActivateDeform(const DeformKey& key, UInt32 uSize, Bool& rbActivated);
+
+	// Return the deform buffer of key, if active, to the pool.
+	void DeactivateDeform(const DeformKey& key);
+
 	const DeformReferences& GetDeformReferences() const { return m_tDeformReferences; }
 	DeformReferences& GetDeformReferences() { return m_tDeformReferences; }
 
@@ -296,38 +397,243 @@ public:
 	const PathInstances& GetPaths() const { return m_vPaths; }
 	PathInstances& GetPaths() { return m_vPaths; }
 
-	const SkinningPalette& GetSkinningPalette() const { return m_vSkinningPalette; }
+	// Poses the instance first if its pose is out of date (e.g. with
+	// lazy posing, see SetPoseLazy()).
+	const SkinningPalette& GetSkinningPalette()
+	{
+		Pose();
+		return m_vSkinningPalette;
+	}
+
+	// Const access, for consumers that cannot pose (e.g. while other
+	// instances are being posed). The pose must be up to date - State::Tick()
+	// poses unless posing is lazy or deferred, otherwise call Pose() first.
+	const SkinningPalette& GetSkinningPalette() const
+	{
+		SEOUL_ASSERT(!m_bPoseDirty);
+		return m_vSkinningPalette;
+	}
 
 	const SlotInstances& GetSlots() const { return m_vSlots; }
 	SlotInstances& GetSlots() { return m_vSlots; }
 
+	// Resolved attachment of each slot (in the active skin), parallel
+	// to GetSlots(). nullptr if a slot has no attachment. Updated by
+	// ApplyCache() only for slots whose attachment id changed. Attachments
+	// are owned by the (immutable) definition, so the raw pointers remain
+	// valid for the life of this instance.
+	const SlotAttachments& GetSlotAttachments() const { return m_vSlotAttachments; }
+	Attachment const* GetSlotAttachment(Int16 iSlot) const { return m_vSlotAttachments[iSlot]; }
+
+	// One bit per slot, set if the attachment of the slot changed
+	// during the most recent ApplyCache(). All bits are set on a
+	// newly constructed instance.
+	const SlotMask& GetChangedSlots() const { return m_vChangedSlots; }
+	Bool IsSlotAttachmentChanged(Int16 iSlot) const
+	{
+		return (0u != (m_vChangedSlots[(UInt32)iSlot >> 5u] & (1u << ((UInt32)iSlot & 31u))));
+	}
+
 	const TransformConstraintStates& GetTransformConstraintStates() const { return m_vTransformConstraintStates; }
 	TransformConstraintStates& GetTransformConstraintStates() { return m_vTransformConstraintStates; }
 
 	// Apply the current state of the animation cache to the instance state. This also resets the cache.
+	// Skipped (the instance is asleep) when the clips that contributed to the cache are
+	// held in the same constant state as when it was last applied.
 	void ApplyCache();
 
+	// Deferred posing - marks the clip evaluation of the current frame as
+	// complete (called by State::Tick()). See SetPoseDeferred().
+	void MarkCacheEvaluated() { m_bCacheEvaluated = true; }
+
+	// Called by ClipInstance::Evaluate() before it accumulates into the cache.
+	// Discards the cache of a previous frame that was never applied.
+	void DiscardUnappliedCache();
+
+	// Force the next ApplyCache() to apply the cache. Must be called after
+	// modifying the state of this instance other than by clip evaluation.
+	void Wake();
+
+	// Copy the pose state (bones, constraints, slots, draw order
+	// and skinning palette) of this instance to r.
+	void CapturePose(DataInstanceSetupPose& r) const;
+
+	// Alternative to ApplyCache() and posing for a frame. Sets the state
+	// of this instance to pose, which must have been captured from an
+	// instance of the same definition. This also resets the cache.
+	void ApplyPose(const DataInstanceSetupPose& pose);
+
+	// Baked clip playback - the next ApplyCache() sets the skinning
+	// palette, slots and draw order of this instance to the state of
+	// pClip at fTime, in place of posing. Only valid when the clip is
+	// the sole contributor to the cache (see GetActiveClipInstanceCount()),
+	// and the clip must still be evaluated into the cache.
+	void SetBakedPose(const SharedPtr<BakedClip>& pClip, Float fTime);
+
+	// CPU skin the mesh attached to iSlot into target, with the deform of
+	// the mesh (if any) applied. The pose must be up to date (see Pose()).
+	// Returns the number of vertices written, 0 if iSlot has no mesh.
+	UInt32 SkinSlot(Int16 iSlot, const SkinningTarget& target) const;
+
+	// Apply any pending pose changes - nop if the pose is up to date.
+	void Pose()
+	{
+		if (m_bPoseDirty)
+		{
+			PoseSkinningPalette();
+		}
+	}
+
+	// True if the state of the instance has changed since the
+	// skinning palette was last posed.
+	Bool IsPoseDirty() const { return m_bPoseDirty; }
+
 	// Prepare the skinning palette state of this instance for query and render.
 	// Applies any animation changes made until now to the active skinning
-	// palette.
+	// palette. Unconditional, prefer Pose().
 	void PoseSkinningPalette();
 
+	// Equivalent to PoseSkinningPalette() on each instance. All instances
+	// must share the same DataDefinition and LodLevel - the pose task list is walked once
+	// and each task is applied to the entire batch before the next.
+	static void PoseSkinningPaletteBatch(DataInstance* const* ppInstances, UInt32 uInstances);
+
+	// Level of detail of this instance, see LodLevel. At reduced
+	// levels of detail, clips are sampled every GetLodEvaluationInterval()
+	// frames - the pose is held in between.
+	LodLevel GetLod() const { return m_eLod; }
+	void SetLod(LodLevel eLod)
+	{
+		m_eLod = eLod;
+		m_uLodFrame = 0u;
+		Wake();
+	}
+	static UInt32 GetLodEvaluationInterval(LodLevel eLod);
+
+	// True if clip timelines should be sampled on the current frame.
+	// Events are dispatched on every frame regardless.
+	Bool IsLodEvaluationFrame() const { return (0u == m_uLodFrame); }
+
+	// True if deform timelines should be applied at the current level of detail.
+	Bool IsLodDeformEnabled() const;
+
+	// When true, the owner of this instance is responsible for applying
+	// the animation cache and posing (e.g. via Manager::PoseBatch()) and
+	// State::Tick() is a nop. The cache must be applied once per frame,
+	// between State::Tick() and the next evaluation. A frame whose cache
+	// is not applied by then (e.g. a skipped batch) is discarded by the
+	// next evaluation, so its channels are never applied twice.
+	Bool IsPoseDeferred() const { return m_bPoseDeferred; }
+	void SetPoseDeferred(Bool bPoseDeferred) { m_bPoseDeferred = bPoseDeferred; }
+
+	// When true, State::Tick() applies the animation cache but does not
+	// pose. The pose is computed on the next Pose() or non-const
+	// GetSkinningPalette(), typically only when the instance is rendered,
+	// so culled instances only pay for clip evaluation. Off by default.
+	Bool IsPoseLazy() const { return m_bPoseLazy; }
+	void SetPoseLazy(Bool bPoseLazy) { m_bPoseLazy = bPoseLazy; }
+
+	// When true, clip time and blend weights are quantized and, if posing
+	// is also deferred, Manager::PoseBatch() may assign this instance a pose
+	// computed for another instance that sampled the same clips at the same
+	// times and weights. The state of a shared instance should only be
+	// modified by its clips.
+	Bool IsPoseShared() const { return m_bPoseShared; }
+	void SetPoseShared(Bool bPoseShared) { m_bPoseShared = bPoseShared; }
+
+	// When true, events (timeline events and clip completion) are queued
+	// during evaluation instead of dispatched, and dispatched in order on
+	// the next call to FlushEvents(), typically once per frame after all
+	// instances have been ticked. Queued events are discarded if the
+	// instance is destroyed before they are flushed.
+	Bool AreEventsDeferred() const { return m_bEventsDeferred; }
+	void SetEventsDeferred(Bool bEventsDeferred) { m_bEventsDeferred = bEventsDeferred; }
+
+	// When true, clips record the range over which their output is
+	// constant, and ApplyCache() skips applying and posing a frame that
+	// is identical to the previous frame (the instance is asleep). Off
+	// by default, since the state of an asleep instance is not reset,
+	// so state modified outside of clips is not restored.
+	Bool IsSleepEnabled() const { return m_bSleepEnabled; }
+	void SetSleepEnabled(Bool bSleepEnabled) { m_bSleepEnabled = bSleepEnabled; }
+
+	// Queue an event for FlushEvents(). keyFrame must be owned by pClip,
+	// which is retained until the event is flushed, so the clip can be
+	// released (and evicted) by its ClipInstance in the meantime.
+	void QueueEvent(const SharedPtr<Clip>& pClip, const KeyFrameEvent& keyFrame);
+	void QueueEvent(HString id) { m_vEvents.PushBack(EventRecord(nullptr, id)); }
+
+	// Dispatch and clear all queued events. Handlers must not destroy this instance.
+	void FlushEvents();
+
+	const EventQueue& GetQueuedEvents() const { return m_vEvents; }
+
+	// Manager only - true from Manager::BeginPoseBatch() until
+	// Manager::WaitForPoseBatch() for each instance of the batch.
+	// The main thread must not tick, apply or pose the instance
+	// while it is set (see SEOUL_ANIMATION2D_ASSERT_NOT_IN_POSE_BATCH).
+	Bool IsInPoseBatch() const { return m_bInPoseBatch; }
+	void SetInPoseBatch(Bool bInPoseBatch) { m_bInPoseBatch = bInPoseBatch; }
+
+	// When enabled, the render state of this instance (skinning palette,
+	// slots, attachments, draw order and deforms) is copied into a snapshot
+	// at the end of each pose (PoseSkinningPalette(), PoseSkinningPaletteBatch(),
+	// ApplyPose() and baked playback, see SetBakedPose()). A consumer on another thread reads
+	// the snapshots via AcquireSnapshot() instead of the live state.
+	Bool AreSnapshotsEnabled() const { return m_pSnapshots.IsValid(); }
+	void SetSnapshotsEnabled(Bool bEnabled);
+
+	// Single consumer only - the most recently completed pose, or nullptr if
+	// snapshots are disabled or no pose has completed since they were
+	// enabled. The snapshot is valid until the next call, or until snapshots
+	// are disabled or this instance is destroyed. Lock free, never blocks
+	// posing of this instance.
+	PoseSnapshot const* AcquireSnapshot() const;
+
 private:
 	ScopedPtr<Cache> const m_pCache;
 	SharedPtr<DataDefinition const> const m_pData;
 	SharedPtr<Animation::EventInterface> const m_pEventInterface;
 	BoneInstances m_vBones;
 	Deforms m_tDeforms;
+	DeformPool m_vDeformPool;
 	DeformReferences m_tDeformReferences;
 	DrawOrder m_vDrawOrder;
 	IkInstances m_vIk;
 	PathInstances m_vPaths;
 	SkinningPalette m_vSkinningPalette;
 	SlotInstances m_vSlots;
+	SlotAttachmentIds m_vSlotAttachmentIds;
+	SlotAttachments m_vSlotAttachments;
+	SlotMask m_vChangedSlots;
 	TransformConstraintStates m_vTransformConstraintStates;
+	ClipInstancePool m_vClipInstancePool;
+	UInt32 m_uActiveClipInstances;
+	EventQueue m_vEvents;
+	EventClips m_vEventClips;
+	ScopedPtr<PoseSnapshotBuffer> m_pSnapshots;
+	SharedPtr<BakedClip> m_pBakedPose;
+	Float32 m_fBakedPoseTime;
+	LodLevel m_eLod;
+	UInt32 m_uLodFrame;
+	Bool m_bPoseDeferred;
+	Bool m_bPoseLazy;
+	Bool m_bPoseDirty;
+	Bool m_bPoseShared;
+	Bool m_bEventsDeferred;
+	Bool m_bSleepEnabled;
+	Bool m_bInPoseBatch;
+	Bool m_bCacheEvaluated;
 
 	void InternalConstruct();
-	SharedPtr<PathAttachment const> InternalGetPathAttachment(Int16 iTarget) const;
+	void InternalApplyBakedPose(const BakedClip& clip, Float fTime);
+	void InternalPublishSnapshot();
+	void InternalPoseSkinningPalette();
+	static void InternalPoseSkinningPaletteBatch(DataInstance* const* ppInstances, UInt32 uInstances);
+	Attachment const* InternalResolveSlotAttachment(Int16 iSlot, HString attachmentId) const;
+	void InternalUpdateSlotAttachments();
+	PathAttachment const* InternalGetPathAttachment(Int16 iPath);
+	PathAttachment const* InternalResolvePathAttachment(Int16 iTarget, HString attachmentId) const;
 	void InternalPoseBone(Int16 iBone);
 	void InternalPoseBone(
 		Int16 iBone,
@@ -338,13 +644,14 @@ private:
 		Float fScaleY,
 		Float fShearX,
 		Float fShearY);
+	void InternalPoseBoneRun(Int16 iRun);
 	void InternalPoseIk(Int16 iIk);
 	void InternalPoseIk1(Int16 iParent, const Vector2D& vTarget, Float fAlpha, Bool bCompress, Bool bStretch, Bool bUniform);
 	void InternalPoseIk2(Int16 iParent, Int16 iChild, const Vector2D& vTarget, Float fAlpha, Float fBendDirection, Bool bStretch, Float fSoftness);
 	void InternalPosePathConstraint(Int16 iPath);
 	Float32 const* InternalPosePathConstraintPoints(
 		Int16 iPath,
-		const SharedPtr<PathAttachment const>& pPathAttachment,
+		PathAttachment const* pPathAttachment,
 		UInt32 uSpaces,
 		Bool bTangents,
 		Bool bPosition,
@@ -358,6 +665,44 @@ private:
 	SEOUL_DISABLE_COPY(DataInstance);
 }; // class DataInstance
 
+// Instances of an in-flight parallel pose batch are only modified by
+// the (worker thread) pose jobs of the batch - see Manager::BeginPoseBatch().
+#define SEOUL_ANIMATION2D_ASSERT_NOT_IN_POSE_BATCH(instance) \
+	SEOUL_ASSERT(!(instance).IsInPoseBatch() || !IsMainThread())
+
+/**
+ * Initial state of every DataInstance of a DataDefinition, including
+ * the posed skinning palette. Computed once by the loader (see
+ * DataDefinition::ComputeSetupPose()), so that constructing a
+ * DataInstance is a copy of these arrays.
+ */
+struct DataInstanceSetupPose SEOUL_SEALED
+{
+	DataInstanceSetupPose()
+		: m_vBones()
+		, m_vDrawOrder()
+		, m_vIk()
+		, m_vPaths()
+		, m_vSkinningPalette()
+		, m_vSlots()
+		, m_vSlotAttachments()
+		, m_vTransformConstraintStates()
+	{
+	}
+
+	DataInstance::BoneInstances m_vBones;
+	DataInstance::DrawOrder m_vDrawOrder;
+	DataInstance::IkInstances m_vIk;
+	DataInstance::PathInstances m_vPaths;
+	DataInstance::SkinningPalette m_vSkinningPalette;
+	DataInstance::SlotInstances m_vSlots;
+	DataInstance::SlotAttachments m_vSlotAttachments;
+	DataInstance::TransformConstraintStates m_vTransformConstraintStates;
+
+	// Heap footprint of the arrays of this pose, in bytes.
+	UInt32 GetHeapSize() const;
+}; // struct DataInstanceSetupPose
+
 } // namespace Animation2D
 
 } // namespace Seoul
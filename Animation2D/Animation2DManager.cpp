@@ -8,26 +8,267 @@
 
 #include "AnimationNetworkDefinitionManager.h"
 #include "Animation2DData.h"
+#include "Animation2DDataInstance.h"
 #include "Animation2DManager.h"
 #include "Animation2DNetworkInstance.h"
+#include "Animation2DPoseCache.h"
+#include "Animation2DProfile.h"
 #include "Animation2DState.h"
+#include "HashSet.h"
+#include "JobsJob.h"
+#include "ThreadId.h"
 
 #if SEOUL_WITH_ANIMATION_2D
 
 namespace Seoul::Animation2D
 {
 
+namespace
+{
+
+/** Number of instances posed by a single job of Manager::BeginPoseBatch(). */
+static const UInt32 kuInstancesPerPoseJob = 32u;
+
+/** Utility used to group instances by their shared DataDefinition and level of detail. */
+struct PoseBatchEntry SEOUL_SEALED
+{
+	SharedPtr<NetworkInstance> m_pNetwork;
+	DataDefinition const* m_pData;
+	DataInstance* m_pInstance;
+	LodLevel m_eLod;
+
+	Bool operator<(const PoseBatchEntry& b) const
+	{
+		return (m_pData == b.m_pData
+			? (m_eLod < b.m_eLod)
+			: (m_pData < b.m_pData));
+	}
+
+	Bool IsSameGroup(const PoseBatchEntry& b) const
+	{
+		return (m_pData == b.m_pData && m_eLod == b.m_eLod);
+	}
+}; // struct PoseBatchEntry
+
+typedef Vector<PoseBatchEntry, MemoryBudgets::Animation2D> PoseBatchEntries;
+typedef Vector<DataInstance*, MemoryBudgets::Animation2D> PoseBatchInstances;
+
+/** First instance of a group to miss in the pose cache with a given key - it is posed and its pose shared. */
+struct SharedPoseLeader SEOUL_SEALED
+{
+	PoseCacheKey m_Key;
+	DataInstance* m_pInstance;
+}; // struct SharedPoseLeader
+
+/** Instance of a group that shares the pose of a leader of the same group. */
+struct SharedPoseFollower SEOUL_SEALED
+{
+	DataInstance* m_pInstance;
+	UInt32 m_uLeader;
+}; // struct SharedPoseFollower
+
+typedef Vector<SharedPoseLeader, MemoryBudgets::Animation2D> SharedPoseLeaders;
+typedef Vector<SharedPoseFollower, MemoryBudgets::Animation2D> SharedPoseFollowers;
+
+/** @return The index of the leader in v with key, or v.GetSize() if not found. */
+static UInt32 FindSharedPoseLeader(const SharedPoseLeaders& v, const PoseCacheKey& key)
+{
+	UInt32 const uSize = v.GetSize();
+	for (UInt32 i = 0u; i < uSize; ++i)
+	{
+		if (v[i].m_Key == key)
+		{
+			return i;
+		}
+	}
+
+	return uSize;
+}
+
+/**
+ * Gather the ready instances of vInstances into rv, sorted such that
+ * instances which share a DataDefinition and LodLevel are contiguous.
+ */
+static void GatherPoseBatch(const Manager::Instances& vInstances, PoseBatchEntries& rv)
+{
+	rv.Clear();
+	rv.Reserve(vInstances.GetSize());
+	for (auto const& p : vInstances)
+	{
+		if (!p.IsValid() || !p->IsReady())
+		{
+			continue;
+		}
+
+		PoseBatchEntry entry;
+		entry.m_pNetwork = p;
+		entry.m_pData = p->GetData().GetPtr();
+		entry.m_pInstance = &p->GetState();
+		entry.m_eLod = entry.m_pInstance->GetLod();
+		rv.PushBack(entry);
+	}
+
+	// Group by definition.
+	QuickSort(rv.Begin(), rv.End());
+}
+
+/**
+ * Apply and pose a group of instances that share a DataDefinition.
+ * Instances that defer posing also defer application of their
+ * animation cache, so that is applied here first. Instances with
+ * an up-to-date pose are skipped. ppInstances is reordered.
+ *
+ * Instances with shared posing take their pose from rCache on a hit.
+ * On a miss, only the first instance with a given key is posed, and
+ * its pose is inserted into rCache and copied to the others.
+ */
+static void PoseGroup(PoseCache& rCache, DataInstance** ppInstances, UInt32 uInstances)
+{
+	SharedPoseLeaders vLeaders;
+	SharedPoseFollowers vFollowers;
+
+	// Apply deferred caches and compact the group
+	// to only those instances with a dirty pose.
+	UInt32 uDirty = 0u;
+	for (UInt32 i = 0u; i < uInstances; ++i)
+	{
+		auto p = ppInstances[i];
+		if (p->IsPoseDeferred())
+		{
+			PoseCacheKey key;
+			if (PoseCache::GetKey(*p, key))
+			{
+				auto const pEntry(rCache.Find(key));
+				if (pEntry.IsValid())
+				{
+					p->ApplyPose(pEntry->GetPose());
+					continue;
+				}
+
+				UInt32 const uLeader = FindSharedPoseLeader(vLeaders, key);
+				if (uLeader < vLeaders.GetSize())
+				{
+					SharedPoseFollower follower;
+					follower.m_pInstance = p;
+					follower.m_uLeader = uLeader;
+					vFollowers.PushBack(follower);
+					continue;
+				}
+
+				SharedPoseLeader leader;
+				leader.m_Key = key;
+				leader.m_pInstance = p;
+				vLeaders.PushBack(leader);
+			}
+
+			p->ApplyCache();
+		}
+
+		if (p->IsPoseDirty())
+		{
+			ppInstances[uDirty++] = p;
+		}
+	}
+
+	DataInstance::PoseSkinningPaletteBatch(ppInstances, uDirty);
+
+	// Share the poses of leaders.
+	if (!vLeaders.IsEmpty())
+	{
+		Vector<SharedPtr<PoseCacheEntry>, MemoryBudgets::Animation2D> vEntries;
+		vEntries.Reserve(vLeaders.GetSize());
+		for (auto const& e : vLeaders)
+		{
+			vEntries.PushBack(rCache.Insert(e.m_Key, *e.m_pInstance));
+		}
+
+		for (auto const& e : vFollowers)
+		{
+			e.m_pInstance->ApplyPose(vEntries[e.m_uLeader]->GetPose());
+		}
+	}
+}
+
+/**
+ * Invoke rFunc(uBegin, uEnd) for each run of entries in v that
+ * share a definition and level of detail. Runs are split to be no larger than uMaxRun.
+ */
+template <typename FUNC>
+static void ForEachPoseGroup(const PoseBatchEntries& v, UInt32 uMaxRun, FUNC& rFunc)
+{
+	UInt32 const uSize = v.GetSize();
+	UInt32 uBegin = 0u;
+	while (uBegin < uSize)
+	{
+		UInt32 uEnd = uBegin + 1u;
+		while (
+			uEnd < uSize &&
+			(uEnd - uBegin) < uMaxRun &&
+			v[uEnd].IsSameGroup(v[uBegin]))
+		{
+			++uEnd;
+		}
+
+		rFunc(uBegin, uEnd);
+		uBegin = uEnd;
+	}
+}
+
+/**
+ * Job used to pose a group of instances on a worker thread. The
+ * instances are retained by the Manager until WaitForPoseBatch()
+ * (see Manager::m_vPoseBatch), not by the job.
+ */
+class PoseJob SEOUL_SEALED : public Jobs::Job
+{
+public:
+	PoseJob(PoseCache& rCache, const PoseBatchEntries& v, UInt32 uBegin, UInt32 uEnd)
+		: m_rCache(rCache)
+		, m_vInstances()
+	{
+		m_vInstances.Reserve(uEnd - uBegin);
+		for (UInt32 i = uBegin; i < uEnd; ++i)
+		{
+			m_vInstances.PushBack(v[i].m_pInstance);
+		}
+	}
+
+	~PoseJob()
+	{
+		WaitUntilJobIsNotRunning();
+	}
+
+private:
+	SEOUL_DISABLE_COPY(PoseJob);
+	SEOUL_REFERENCE_COUNTED_SUBCLASS(PoseJob);
+
+	PoseCache& m_rCache;
+	PoseBatchInstances m_vInstances;
+
+	virtual void InternalExecuteJob(Jobs::State& reNextState, ThreadId& rNextThreadId) SEOUL_OVERRIDE
+	{
+		PoseGroup(m_rCache, m_vInstances.Data(), m_vInstances.GetSize());
+		reNextState = Jobs::State::kComplete;
+	}
+}; // class PoseJob
+
+} // namespace anonymous
+
 Manager::Manager()
 	: m_DataContent()
 #if !SEOUL_SHIP
 	, m_vInstances()
 	, m_Mutex()
 #endif // /#if !SEOUL_SHIP
+	, m_vPoseJobs()
+	, m_vPoseBatch()
+	, m_PoseCache()
 {
 }
 
 Manager::~Manager()
 {
+	WaitForPoseBatch();
 }
 
 /** Get a copy of the current list of network instances. */
@@ -39,6 +280,220 @@ void Manager::GetActiveNetworkInstances(Instances& rvInstances) const
 #endif // /#if !SEOUL_SHIP
 }
 
+/**
+ * Populate r with the memory footprint of the ready instances of
+ * vInstances and of each distinct DataDefinition they reference.
+ */
+void Manager::GetMemoryUsage(const Instances& vInstances, MemoryUsage& r)
+{
+	r = MemoryUsage();
+
+	HashSet<DataDefinition const*, MemoryBudgets::Animation2D> set;
+	for (auto const& p : vInstances)
+	{
+		if (!p.IsValid() || !p->IsReady())
+		{
+			continue;
+		}
+
+		DataInstanceMemoryUsage usage;
+		p->GetState().GetMemoryUsage(usage);
+		r.m_Instances += usage;
+		++r.m_uInstanceCount;
+
+		auto const& pData = p->GetData();
+		if (pData.IsValid() && set.Insert(pData.GetPtr()).Second)
+		{
+			r.m_uDefinitions += pData->GetMemoryUsage();
+			++r.m_uDefinitionCount;
+		}
+	}
+}
+
+/**
+ * Flush the queued events of the ready instances of vInstances. Events
+ * are dispatched instance by instance, in the order of vInstances, and
+ * in queue order within an instance, so dispatch order is deterministic.
+ */
+void Manager::FlushEvents(const Instances& vInstances)
+{
+	for (auto const& p : vInstances)
+	{
+		if (p.IsValid() && p->IsReady())
+		{
+			p->GetState().FlushEvents();
+		}
+	}
+}
+
+/**
+ * Release unused resident clips of each distinct DataDefinition
+ * referenced by the ready instances of vInstances.
+ *
+ * @return The total number of clips released.
+ */
+UInt32 Manager::EvictUnusedClips(const Instances& vInstances)
+{
+	UInt32 uReturn = 0u;
+
+	HashSet<DataDefinition const*, MemoryBudgets::Animation2D> set;
+	for (auto const& p : vInstances)
+	{
+		if (!p.IsValid() || !p->IsReady())
+		{
+			continue;
+		}
+
+		auto const& pData = p->GetData();
+		if (!pData.IsValid() || !set.Insert(pData.GetPtr()).Second)
+		{
+			continue;
+		}
+
+		uReturn += pData->EvictUnusedClips();
+	}
+
+	return uReturn;
+}
+
+#if SEOUL_ANIMATION2D_PROFILING
+/**
+ * Populate rv with the counters of each distinct DataDefinition
+ * referenced by the ready instances of vInstances.
+ */
+void Manager::GetProfiles(const Instances& vInstances, Profiles& rv)
+{
+	rv.Clear();
+
+	HashSet<DataDefinition const*, MemoryBudgets::Animation2D> set;
+	for (auto const& p : vInstances)
+	{
+		if (!p.IsValid() || !p->IsReady())
+		{
+			continue;
+		}
+
+		auto const& pData = p->GetData();
+		if (!pData.IsValid() || !set.Insert(pData.GetPtr()).Second)
+		{
+			continue;
+		}
+
+		Profile profile;
+		profile.m_FilePath = pData->GetFilePath();
+		profile.m_Frame = pData->GetProfile().GetFrame();
+		pData->GetProfile().GetTotal(profile.m_Total);
+		rv.PushBack(profile);
+	}
+}
+
+void Manager::GetGlobalProfile(ProfileSnapshot& rFrame, ProfileSnapshot& rTotal)
+{
+	auto const& stats = ProfileStats::GetGlobal();
+	rFrame = stats.GetFrame();
+	stats.GetTotal(rTotal);
+}
+#endif // /#if SEOUL_ANIMATION2D_PROFILING
+
+/**
+ * Pose all ready instances in vInstances. Instances are grouped by their
+ * DataDefinition and each group is posed with
+ * DataInstance::PoseSkinningPaletteBatch(), so the pose task list of a
+ * definition is walked once for all of its instances.
+ *
+ * Typically used in conjunction with DataInstance::SetPoseDeferred(), in
+ * which case the animation cache of the instance is also applied here.
+ */
+void Manager::PoseBatch(const Instances& vInstances)
+{
+	PoseBatchEntries vEntries;
+	GatherPoseBatch(vInstances, vEntries);
+	if (vEntries.IsEmpty())
+	{
+		return;
+	}
+
+	PoseBatchInstances vBatch;
+	vBatch.Reserve(vEntries.GetSize());
+	for (auto const& e : vEntries)
+	{
+		vBatch.PushBack(e.m_pInstance);
+	}
+
+	// Pose each run of instances that share a definition.
+	auto const func = [&](UInt32 uBegin, UInt32 uEnd)
+	{
+		PoseGroup(m_PoseCache, vBatch.Get(uBegin), uEnd - uBegin);
+	};
+	ForEachPoseGroup(vEntries, UInt32Max, func);
+}
+
+/**
+ * Parallel variant of PoseBatch(). Groups of instances are posed
+ * on worker threads of the job system. The caller must call
+ * WaitForPoseBatch() before accessing the state of any instance
+ * in vInstances (e.g. DataInstance::GetSkinningPalette()). Instances
+ * are retained until then, so they can be released in the meantime,
+ * but must not be ticked, applied or posed (this is asserted).
+ *
+ * Instances do not share mutable state, so no synchronization is
+ * needed between groups. The posing phase (ApplyCache() and
+ * PoseSkinningPalette()) does not dispatch animation events.
+ */
+void Manager::BeginPoseBatch(const Instances& vInstances)
+{
+	SEOUL_ASSERT(IsMainThread());
+
+	// Complete any outstanding batch first.
+	WaitForPoseBatch();
+
+	PoseBatchEntries vEntries;
+	GatherPoseBatch(vInstances, vEntries);
+	if (vEntries.IsEmpty())
+	{
+		return;
+	}
+
+	// Retain and mark the instances of the batch before any job is started.
+	m_vPoseBatch.Reserve(vEntries.GetSize());
+	for (auto const& e : vEntries)
+	{
+		e.m_pInstance->SetInPoseBatch(true);
+		m_vPoseBatch.PushBack(e.m_pNetwork);
+	}
+
+	auto func = [&](UInt32 uBegin, UInt32 uEnd)
+	{
+		SharedPtr<Jobs::Job> pJob(SEOUL_NEW(MemoryBudgets::Animation2D) PoseJob(m_PoseCache, vEntries, uBegin, uEnd));
+		pJob->StartJob();
+		m_vPoseJobs.PushBack(pJob);
+	};
+	ForEachPoseGroup(vEntries, kuInstancesPerPoseJob, func);
+}
+
+/**
+ * Fence for BeginPoseBatch(). On return, all instances passed to the
+ * most recent call to BeginPoseBatch() have been fully posed and are
+ * no longer retained by this Manager.
+ */
+void Manager::WaitForPoseBatch()
+{
+	SEOUL_ASSERT(IsMainThread());
+
+	for (auto const& pJob : m_vPoseJobs)
+	{
+		pJob->WaitUntilJobIsNotRunning();
+	}
+	m_vPoseJobs.Clear();
+
+	// Instances can now be released and modified.
+	for (auto const& p : m_vPoseBatch)
+	{
+		p->GetState().SetInPoseBatch(false);
+	}
+	m_vPoseBatch.Clear();
+}
+
 /** @return A new network instance. In development builds, instances are tracked for debugging purposes. */
 SharedPtr<Animation2D::NetworkInstance> Manager::CreateInstance(
 	const AnimationNetworkContentHandle& hNetwork,
@@ -88,6 +543,14 @@ SharedPtr<Animation2D::NetworkInstance> Manager::CreateInstance(
 /** Per-frame maintenance. */
 void Manager::Tick(Float fDeltaTimeInSeconds)
 {
+	// Release shared poses of definitions that have been unloaded or reloaded.
+	m_PoseCache.Prune();
+
+#if SEOUL_ANIMATION2D_PROFILING
+	// Roll hot path counters into their per-frame values.
+	ProfileStats::EndFrameAll();
+#endif // /#if SEOUL_ANIMATION2D_PROFILING
+
 	// Prune stale instances.
 #if !SEOUL_SHIP
 	{
@@ -12,10 +12,13 @@
 
 #include "AnimationNetworkDefinition.h"
 #include "Animation2DDataDefinition.h"
+#include "Animation2DDataInstance.h"
+#include "Animation2DPoseCache.h"
 #include "ContentStore.h"
 #include "Delegate.h"
 #include "Singleton.h"
 namespace Seoul { namespace Animation { class EventInterface; } }
+namespace Seoul { namespace Jobs { class Job; } }
 namespace Seoul { namespace Animation2D { class NetworkInstance; } }
 
 #if SEOUL_WITH_ANIMATION_2D
@@ -29,6 +32,43 @@ public:
 	typedef Delegate<void(HString name)> EventCallback;
 	typedef Vector<SharedPtr<Animation2D::NetworkInstance>, MemoryBudgets::Animation2D> Instances;
 
+	/** Memory footprint of a set of instances and of the definitions they reference, in bytes. */
+	struct MemoryUsage SEOUL_SEALED
+	{
+		MemoryUsage()
+			: m_Instances()
+			, m_uDefinitions(0u)
+			, m_uDefinitionCount(0u)
+			, m_uInstanceCount(0u)
+		{
+		}
+
+		UInt32 GetTotal() const { return m_Instances.GetTotal() + m_uDefinitions; }
+
+		DataInstanceMemoryUsage m_Instances;
+		UInt32 m_uDefinitions;
+		UInt32 m_uDefinitionCount;
+		UInt32 m_uInstanceCount;
+	}; // struct MemoryUsage
+
+#if SEOUL_ANIMATION2D_PROFILING
+	/** Hot path counters of a single DataDefinition, see GetProfiles(). */
+	struct Profile SEOUL_SEALED
+	{
+		Profile()
+			: m_FilePath()
+			, m_Frame()
+			, m_Total()
+		{
+		}
+
+		FilePath m_FilePath;
+		ProfileSnapshot m_Frame;
+		ProfileSnapshot m_Total;
+	}; // struct Profile
+	typedef Vector<Profile, MemoryBudgets::Animation2D> Profiles;
+#endif // /#if SEOUL_ANIMATION2D_PROFILING
+
 	Manager();
 	~Manager();
 
@@ -53,6 +93,46 @@ public:
 	// Get a copy of the current list of network instances.
 	void GetActiveNetworkInstances(Instances& rvInstances) const;
 
+	// Memory footprint of the ready instances of vInstances. Definitions
+	// shared by multiple instances are counted once. In development builds,
+	// combine with GetActiveNetworkInstances() for a global total.
+	static void GetMemoryUsage(const Instances& vInstances, MemoryUsage& r);
+
+#if SEOUL_ANIMATION2D_PROFILING
+	// Hot path counters of each distinct DataDefinition referenced by the
+	// ready instances of vInstances. Frame values cover the most recent Tick().
+	static void GetProfiles(const Instances& vInstances, Profiles& rv);
+
+	// Hot path counters of the entire module, including load stages that
+	// precede the existence of a DataDefinition.
+	static void GetGlobalProfile(ProfileSnapshot& rFrame, ProfileSnapshot& rTotal);
+#endif // /#if SEOUL_ANIMATION2D_PROFILING
+
+	// Dispatch the deferred events (see DataInstance::SetEventsDeferred())
+	// of each ready instance of vInstances, in order.
+	static void FlushEvents(const Instances& vInstances);
+
+	// Release the resident clips of each distinct DataDefinition referenced
+	// by the ready instances of vInstances that no clip instance is using
+	// (see DataDefinition::EvictUnusedClips()). The owner of the instances
+	// calls this, e.g. once per frame or in response to low memory.
+	// Returns the total number of clips released.
+	static UInt32 EvictUnusedClips(const Instances& vInstances);
+
+	// Pose all ready instances of vInstances, batched by shared DataDefinition.
+	// Instances with shared posing enabled (see DataInstance::SetPoseShared())
+	// take their pose from the shared pose cache when possible.
+	void PoseBatch(const Instances& vInstances);
+
+	// Parallel PoseBatch() - posing is performed on worker threads. WaitForPoseBatch()
+	// must be called before accessing the pose state of any instance in vInstances.
+	void BeginPoseBatch(const Instances& vInstances);
+	void WaitForPoseBatch();
+
+	// Cache of poses shared between instances, see DataInstance::SetPoseShared().
+	const PoseCache& GetPoseCache() const { return m_PoseCache; }
+	PoseCache& GetPoseCache() { return m_PoseCache; }
+
 	// Per-frame maintenance.
 	void Tick(Float fDeltaTimeInSeconds);
 
@@ -65,6 +145,12 @@ private:
 	Mutex m_Mutex;
 #endif // /#if !SEOUL_SHIP
 
+	typedef Vector<SharedPtr<Jobs::Job>, MemoryBudgets::Animation2D> PoseJobs;
+	PoseJobs m_vPoseJobs;
+	// Instances of the in-flight pose batch, retained until WaitForPoseBatch().
+	Instances m_vPoseBatch;
+	PoseCache m_PoseCache;
+
 	SEOUL_DISABLE_COPY(Manager);
 }; // class Manager
 
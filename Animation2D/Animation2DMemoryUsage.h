@@ -0,0 +1,70 @@
+/**
+ * \file Animation2DMemoryUsage.h
+ * \brief Utilities to compute the heap footprint of Animation2D
+ * data. Used for content memory accounting and memory telemetry.
+ *
+ * Copyright (c) 2016-2022 Demiurge Studios Inc. All rights reserved.
+ */
+
+#pragma once
+#ifndef ANIMATION2D_MEMORY_USAGE_H
+#define ANIMATION2D_MEMORY_USAGE_H
+
+#include "HashTable.h"
+#include "Prereqs.h"
+#include "SeoulString.h"
+#include "Vector.h"
+
+#if SEOUL_WITH_ANIMATION_2D
+
+namespace Seoul::Animation2D
+{
+
+/** @return The size of the heap buffer of v, excluding any memory owned by its elements. */
+template <typename T, int MEMORY_BUDGETS>
+static inline UInt32 GetHeapSize(const Vector<T, MEMORY_BUDGETS>& v)
+{
+	return (UInt32)(v.GetCapacity() * sizeof(T));
+}
+
+/** @return GetHeapSize(v) plus the result of func(e) for each element e of v. */
+template <typename T, int MEMORY_BUDGETS, typename FUNC>
+static inline UInt32 GetHeapSize(const Vector<T, MEMORY_BUDGETS>& v, const FUNC& func)
+{
+	UInt32 uReturn = GetHeapSize(v);
+	for (auto const& e : v)
+	{
+		uReturn += func(e);
+	}
+	return uReturn;
+}
+
+/** @return The size of the heap buffer of t, excluding any memory owned by its values. */
+template <typename K, typename V, int MEMORY_BUDGETS, typename TRAITS>
+static inline UInt32 GetHeapSize(const HashTable<K, V, MEMORY_BUDGETS, TRAITS>& t)
+{
+	return (UInt32)(t.GetCapacity() * (sizeof(K) + sizeof(V)));
+}
+
+/** @return GetHeapSize(t) plus the result of func(v) for each value v of t. */
+template <typename K, typename V, int MEMORY_BUDGETS, typename TRAITS, typename FUNC>
+static inline UInt32 GetHeapSize(const HashTable<K, V, MEMORY_BUDGETS, TRAITS>& t, const FUNC& func)
+{
+	UInt32 uReturn = GetHeapSize(t);
+	for (auto const& e : t)
+	{
+		uReturn += func(e.Second);
+	}
+	return uReturn;
+}
+
+static inline UInt32 GetHeapSize(const String& s)
+{
+	return s.GetCapacity();
+}
+
+} // namespace Seoul::Animation2D
+
+#endif // /#if SEOUL_WITH_ANIMATION_2D
+
+#endif // include guard
@@ -10,8 +10,10 @@
 #include "AnimationEventInterface.h"
 #include "AnimationNetworkInstance.h"
 #include "AnimationPlayClipDefinition.h"
+#include "Animation2DBakedClip.h"
 #include "Animation2DClipInstance.h"
 #include "Animation2DData.h"
+#include "Animation2DDataInstance.h"
 #include "Animation2DPlayClipInstance.h"
 #include "Animation2DState.h"
 #include "Logger.h"
@@ -29,20 +31,30 @@ PlayClipInstance::PlayClipInstance(
 	, m_r(r)
 	, m_pPlayClip(pPlayClip)
 	, m_pClipInstance()
+	, m_pBakedClip()
 	, m_fTime(0.0f)
 	, m_bDone(false)
 {
-	auto pClip = static_cast<const Data&>(m_r.GetDataInterface()).GetPtr()->GetClip(m_pPlayClip->GetName());
+	auto const& pData = static_cast<const Data&>(m_r.GetDataInterface()).GetPtr();
+	auto pClip = pData->GetClip(m_pPlayClip->GetName());
 	if (!pClip.IsValid())
 	{
 		SEOUL_WARN("Network %s refers to non-existent animation clip: %s", r.GetNetworkHandle().GetKey().CStr(), m_pPlayClip->GetName().CStr());
 		return;
 	}
-	m_pClipInstance.Reset(SEOUL_NEW(MemoryBudgets::Animation2D) ClipInstance(static_cast<State&>(r.GetStateInterface()).GetInstance(), pClip, settings));
+	m_pClipInstance = static_cast<State&>(r.GetStateInterface()).GetInstance().AcquireClipInstance(pClip, settings);
+
+	// The clip instance is still used for events and timing.
+	m_pBakedClip = pData->GetBakedClip(m_pPlayClip->GetName());
 }
 
 PlayClipInstance::~PlayClipInstance()
 {
+	// Return the clip instance to the pool of its DataInstance.
+	if (m_pClipInstance.IsValid())
+	{
+		m_pClipInstance->GetInstance().ReleaseClipInstance(m_pClipInstance);
+	}
 }
 
 Float PlayClipInstance::GetCurrentMaxTime() const
@@ -113,7 +125,16 @@ void PlayClipInstance::OnComplete()
 		auto pEventInterface(m_r.GetEventInterface());
 		if (pEventInterface.IsValid())
 		{
-			pEventInterface->DispatchEvent(m_pPlayClip->GetOnComplete(), 0, 0.0f, String());
+			auto& rInstance = static_cast<State&>(m_r.GetStateInterface()).GetInstance();
+			if (rInstance.AreEventsDeferred())
+			{
+				rInstance.QueueEvent(m_pPlayClip->GetOnComplete());
+			}
+			else
+			{
+				static const String ksEmpty;
+				pEventInterface->DispatchEvent(m_pPlayClip->GetOnComplete(), 0, 0.0f, ksEmpty);
+			}
 		}
 	}
 }
@@ -185,6 +206,16 @@ Bool PlayClipInstance::Tick(Float fDeltaTimeInSeconds, Float fAlpha, Bool bBlend
 	// Apply instance (sampled) evaluations.
 	m_pClipInstance->Evaluate(m_fTime, fAlpha, bBlendDiscreteState);
 
+	// Baked clips replace posing when this is the only clip of the
+	// instance (so the sole evaluator of the network) at full weight.
+	// Any other clip contributes to the cache, which a baked pose
+	// cannot include.
+	auto& rInstance = m_pClipInstance->GetInstance();
+	if (m_pBakedClip.IsValid() && fAlpha >= 1.0f && 1u == rInstance.GetActiveClipInstanceCount())
+	{
+		rInstance.SetBakedPose(m_pBakedClip, m_fTime);
+	}
+
 	// If not looping and not done, check if we've hit the end of the clip.
 	if (!m_bDone && !m_pPlayClip->GetLoop() && m_fTime >= m_pClipInstance->GetMaxTime())
 	{
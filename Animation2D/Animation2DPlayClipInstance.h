@@ -13,9 +13,10 @@
 
 #include "AnimationClipSettings.h"
 #include "AnimationNodeInstance.h"
-#include "ScopedPtr.h"
+#include "CheckedPtr.h"
 namespace Seoul { namespace Animation { class NetworkInstance; } }
 namespace Seoul { namespace Animation { class PlayClipDefinition; } }
+namespace Seoul { namespace Animation2D { class BakedClip; } }
 namespace Seoul { namespace Animation2D { class ClipInstance; } }
 
 #if SEOUL_WITH_ANIMATION_2D
@@ -59,7 +60,8 @@ private:
 	Animation::ClipSettings const m_Settings;
 	Animation::NetworkInstance& m_r;
 	SharedPtr<Animation::PlayClipDefinition const> m_pPlayClip;
-	ScopedPtr<ClipInstance> m_pClipInstance;
+	CheckedPtr<ClipInstance> m_pClipInstance;
+	SharedPtr<BakedClip> m_pBakedClip;
 	Float32 m_fTime;
 	Bool m_bDone;
 
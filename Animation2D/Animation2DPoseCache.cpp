@@ -0,0 +1,182 @@
+/**
+ * \file Animation2DPoseCache.cpp
+ * \brief Bounded, least-recently-used cache of posed DataInstance state.
+ * Used by the Manager to share a single pose between instances that
+ * sample the same clips at the same (quantized) times and weights.
+ *
+ * Copyright (c) 2016-2022 Demiurge Studios Inc. All rights reserved.
+ */
+
+#include "Animation2DClipDefinition.h"
+#include "Animation2DDataDefinition.h"
+#include "Animation2DMemoryUsage.h"
+#include "Animation2DPoseCache.h"
+#include "SeoulMath.h"
+
+#if SEOUL_WITH_ANIMATION_2D
+
+namespace Seoul::Animation2D
+{
+
+PoseCacheEntry::PoseCacheEntry(const PoseCacheKey& key, const DataInstance& instance)
+	: m_pData(instance.GetData())
+	, m_apClips()
+	, m_Pose()
+{
+	auto const& signature = key.m_Signature;
+	for (UInt32 i = 0u; i < signature.m_uSamples; ++i)
+	{
+		m_apClips[i] = SharedPtr<Clip const>(signature.m_aSamples[i].m_pClip);
+	}
+
+	instance.CapturePose(m_Pose);
+}
+
+PoseCacheEntry::~PoseCacheEntry()
+{
+}
+
+PoseCache::PoseCache(UInt32 uCapacity /* = kuDefaultCapacity */)
+	: m_tEntries()
+	, m_uCapacity(Max(uCapacity, 1u))
+	, m_uClock(0u)
+	, m_Mutex()
+{
+}
+
+PoseCache::~PoseCache()
+{
+}
+
+/**
+ * @return True and populate rKey if instance can share its pose for the
+ * current frame. An instance qualifies if it has opted in to both shared
+ * and deferred posing, is due for evaluation at its level of detail, and
+ * all of its accumulated state this frame came from recorded clip samples.
+ */
+Bool PoseCache::GetKey(const DataInstance& instance, PoseCacheKey& rKey)
+{
+	if (!instance.IsPoseShared() ||
+		!instance.IsPoseDeferred() ||
+		!instance.IsLodEvaluationFrame())
+	{
+		return false;
+	}
+
+	auto const& signature = instance.GetCache().m_Signature;
+	if (!signature.IsValid())
+	{
+		return false;
+	}
+
+	rKey.m_pData = instance.GetData().GetPtr();
+	rKey.m_eLod = instance.GetLod();
+	rKey.m_Signature = signature;
+	return true;
+}
+
+SharedPtr<PoseCacheEntry> PoseCache::Find(const PoseCacheKey& key)
+{
+	Lock lock(m_Mutex);
+
+	auto p = m_tEntries.Find(key);
+	if (nullptr == p)
+	{
+		return SharedPtr<PoseCacheEntry>();
+	}
+
+	p->m_uLastUse = ++m_uClock;
+	return p->m_p;
+}
+
+SharedPtr<PoseCacheEntry> PoseCache::Insert(const PoseCacheKey& key, const DataInstance& instance)
+{
+	// Capture outside the lock, the pose arrays can be large.
+	SharedPtr<PoseCacheEntry> pEntry(SEOUL_NEW(MemoryBudgets::Animation2D) PoseCacheEntry(key, instance));
+
+	Lock lock(m_Mutex);
+
+	// Another thread may have inserted the same pose, prefer the existing entry.
+	auto p = m_tEntries.Find(key);
+	if (nullptr != p)
+	{
+		p->m_uLastUse = ++m_uClock;
+		return p->m_p;
+	}
+
+	if (m_tEntries.GetSize() >= m_uCapacity)
+	{
+		InternalEvictLeastRecentlyUsed();
+	}
+
+	Entry entry;
+	entry.m_p = pEntry;
+	entry.m_uLastUse = ++m_uClock;
+	SEOUL_VERIFY(m_tEntries.Insert(key, entry).Second);
+	return pEntry;
+}
+
+void PoseCache::Clear()
+{
+	Lock lock(m_Mutex);
+	m_tEntries.Clear();
+}
+
+void PoseCache::Prune()
+{
+	Lock lock(m_Mutex);
+
+	Vector<PoseCacheKey, MemoryBudgets::Animation2D> vStale;
+	for (auto const& e : m_tEntries)
+	{
+		if (e.Second.m_p->GetData().IsUnique())
+		{
+			vStale.PushBack(e.First);
+		}
+	}
+
+	for (auto const& key : vStale)
+	{
+		(void)m_tEntries.Erase(key);
+	}
+}
+
+UInt32 PoseCache::GetMemoryUsage() const
+{
+	Lock lock(m_Mutex);
+	return GetHeapSize(m_tEntries, [](const Entry& e) { return e.m_p->GetMemoryUsage(); });
+}
+
+UInt32 PoseCache::GetSize() const
+{
+	Lock lock(m_Mutex);
+	return m_tEntries.GetSize();
+}
+
+/** Evict the entry with the oldest use. Only called on insertion into a full cache. */
+void PoseCache::InternalEvictLeastRecentlyUsed()
+{
+	Bool bFound = false;
+	PoseCacheKey oldest;
+	UInt32 uOldestAge = 0u;
+	for (auto const& e : m_tEntries)
+	{
+		// Age is relative to the current clock, so wrap is harmless.
+		UInt32 const uAge = (m_uClock - e.Second.m_uLastUse);
+		if (!bFound || uAge > uOldestAge)
+		{
+			bFound = true;
+			oldest = e.First;
+			uOldestAge = uAge;
+		}
+	}
+
+	if (bFound)
+	{
+		(void)m_tEntries.Erase(oldest);
+	}
+}
+
+} // namespace Seoul::Animation2D
+
+#endif // /#if SEOUL_WITH_ANIMATION_2D
@@ -0,0 +1,181 @@
+/**
+ * \file Animation2DPoseCache.h
+ * \brief Bounded, least-recently-used cache of posed DataInstance state.
+ * Used by the Manager to share a single pose between instances that
+ * sample the same clips at the same (quantized) times and weights.
+ *
+ * Copyright (c) 2016-2022 Demiurge Studios Inc. All rights reserved.
+ */
+
+#pragma once
+#ifndef ANIMATION2D_POSE_CACHE_H
+#define ANIMATION2D_POSE_CACHE_H
+
+#include "Animation2DCache.h"
+#include "Animation2DDataDefinition.h"
+#include "Animation2DDataInstance.h"
+#include "FixedArray.h"
+#include "HashTable.h"
+#include "Mutex.h"
+#include "SharedPtr.h"
+namespace Seoul { namespace Animation2D { class Clip; } }
+
+#if SEOUL_WITH_ANIMATION_2D
+
+namespace Seoul
+{
+
+namespace Animation2D
+{
+
+struct PoseCacheKey SEOUL_SEALED
+{
+	PoseCacheKey()
+		: m_pData(nullptr)
+		, m_eLod(LodLevel::kFull)
+		, m_Signature()
+	{
+	}
+
+	Bool operator==(const PoseCacheKey& b) const
+	{
+		return (
+			m_pData == b.m_pData &&
+			m_eLod == b.m_eLod &&
+			m_Signature == b.m_Signature);
+	}
+
+	Bool operator!=(const PoseCacheKey& b) const
+	{
+		return !(*this == b);
+	}
+
+	UInt32 GetHash() const
+	{
+		UInt32 uReturn = m_Signature.GetHash();
+		IncrementalHash(uReturn, (UInt32)(size_t)m_pData);
+		IncrementalHash(uReturn, (UInt32)m_eLod);
+		return uReturn;
+	}
+
+	// Identity only - the definition is retained by the PoseCacheEntry
+	// of the key, so its address cannot be reused while the entry is cached.
+	DataDefinition const* m_pData;
+	// Levels of detail pose with different task lists (see
+	// DataDefinition::GetPoseTasks()), so poses are never shared across them.
+	LodLevel m_eLod;
+	CacheSignature m_Signature;
+}; // struct PoseCacheKey
+static inline UInt32 GetHash(const PoseCacheKey& key)
+{
+	return key.GetHash();
+}
+
+} // namespace Animation2D
+
+template <>
+struct DefaultHashTableKeyTraits<Animation2D::PoseCacheKey>
+{
+	inline static Float GetLoadFactor()
+	{
+		return 0.75f;
+	}
+
+	inline static Animation2D::PoseCacheKey GetNullKey()
+	{
+		return Animation2D::PoseCacheKey();
+	}
+
+	static const Bool kCheckHashBeforeEquals = true;
+};
+
+namespace Animation2D
+{
+
+class PoseCacheEntry SEOUL_SEALED
+{
+public:
+	PoseCacheEntry(const PoseCacheKey& key, const DataInstance& instance);
+	~PoseCacheEntry();
+
+	const SharedPtr<DataDefinition const>& GetData() const { return m_pData; }
+	const DataInstanceSetupPose& GetPose() const { return m_Pose; }
+
+	// Total memory footprint of this entry, in bytes.
+	UInt32 GetMemoryUsage() const { return (UInt32)sizeof(*this) + m_Pose.GetHeapSize(); }
+
+private:
+	SEOUL_REFERENCE_COUNTED(PoseCacheEntry);
+
+	// The definition and clips are retained, so that the
+	// addresses in the key of this entry cannot be reused
+	// by other definitions or clips while it is cached.
+	SharedPtr<DataDefinition const> const m_pData;
+	FixedArray<SharedPtr<Clip const>, CacheSignature::kuMaxSamples> m_apClips;
+	DataInstanceSetupPose m_Pose;
+
+	SEOUL_DISABLE_COPY(PoseCacheEntry);
+}; // class PoseCacheEntry
+
+class PoseCache SEOUL_SEALED
+{
+public:
+	static const UInt32 kuDefaultCapacity = 64u;
+
+	PoseCache(UInt32 uCapacity = kuDefaultCapacity);
+	~PoseCache();
+
+	// All methods are thread-safe.
+
+	// Populate rKey with the key of the current frame of instance. Returns
+	// false if instance is not eligible for shared posing this frame.
+	static Bool GetKey(const DataInstance& instance, PoseCacheKey& rKey);
+
+	// Return the entry of key, or an invalid pointer on a miss.
+	SharedPtr<PoseCacheEntry> Find(const PoseCacheKey& key);
+
+	// Capture the (posed) state of instance as the entry of key. The least
+	// recently used entry is evicted if the cache is full.
+	SharedPtr<PoseCacheEntry> Insert(const PoseCacheKey& key, const DataInstance& instance);
+
+	// Evict all entries.
+	void Clear();
+
+	// Evict entries of definitions that are no longer referenced
+	// outside of this cache (e.g. after a hot reload).
+	void Prune();
+
+	UInt32 GetMemoryUsage() const;
+	UInt32 GetSize() const;
+
+private:
+	struct Entry SEOUL_SEALED
+	{
+		Entry()
+			: m_p()
+			, m_uLastUse(0u)
+		{
+		}
+
+		SharedPtr<PoseCacheEntry> m_p;
+		UInt32 m_uLastUse;
+	}; // struct Entry
+	typedef HashTable<PoseCacheKey, Entry, MemoryBudgets::Animation2D> Entries;
+
+	Entries m_tEntries;
+	UInt32 const m_uCapacity;
+	UInt32 m_uClock;
+	Mutex m_Mutex;
+
+	void InternalEvictLeastRecentlyUsed();
+
+	SEOUL_DISABLE_COPY(PoseCache);
+}; // class PoseCache
+
+} // namespace Animation2D
+
+} // namespace Seoul
+
+#endif // /#if SEOUL_WITH_ANIMATION_2D
+
+#endif // include guard
@@ -0,0 +1,120 @@
+/**
+ * \file Animation2DPoseSnapshot.cpp
+ * \brief Immutable copy of the render state of a DataInstance,
+ * published at the end of posing into a triple buffer. A single
+ * consumer (e.g. the render thread) acquires the most recently
+ * published snapshot without locks and without copies, so posing of
+ * frame N+1 can overlap rendering of frame N.
+ *
+ * Copyright (c) 2016-2022 Demiurge Studios Inc. All rights reserved.
+ */
+
+#include "Animation2DMemoryUsage.h"
+#include "Animation2DPoseSnapshot.h"
+
+#if SEOUL_WITH_ANIMATION_2D
+
+namespace Seoul::Animation2D
+{
+
+/** Linear search, instances rarely have more than a few active deforms. */
+Float32 const* PoseSnapshot::FindDeform(const DeformKey& key, UInt32& ruSize) const
+{
+	for (auto const& e : m_vDeforms)
+	{
+		if (e.m_Key == key)
+		{
+			ruSize = e.m_uSize;
+			return m_vDeformData.Data() + e.m_uOffset;
+		}
+	}
+
+	ruSize = 0u;
+	return nullptr;
+}
+
+UInt32 PoseSnapshot::GetHeapSize() const
+{
+	return
+		Animation2D::GetHeapSize(m_vDeforms) +
+		Animation2D::GetHeapSize(m_vDeformData) +
+		Animation2D::GetHeapSize(m_vDrawOrder) +
+		Animation2D::GetHeapSize(m_vSkinningPalette) +
+		Animation2D::GetHeapSize(m_vSlots) +
+		Animation2D::GetHeapSize(m_vSlotAttachments);
+}
+
+/**
+ * Buffer 0 is the producer's, 1 is ready (but not fresh, nothing
+ * has been published) and 2 is the consumer's.
+ */
+PoseSnapshotBuffer::PoseSnapshotBuffer()
+	: m_a()
+	, m_Ready(1)
+	, m_uBack(0u)
+	, m_uFront(2u)
+	, m_bAcquired(false)
+{
+}
+
+PoseSnapshotBuffer::~PoseSnapshotBuffer()
+{
+}
+
+/**
+ * Exchange the back buffer with the ready buffer and mark it fresh.
+ * The compare-and-set is a full barrier, so the writes to the back
+ * buffer are visible to the consumer before its index is.
+ */
+void PoseSnapshotBuffer::Publish()
+{
+	Atomic32Type const iNew = ((Atomic32Type)m_uBack | kiFresh);
+	Atomic32Type iOld = m_Ready;
+	while (true)
+	{
+		Atomic32Type const iPrev = m_Ready.CompareAndSet(iNew, iOld);
+		if (iPrev == iOld)
+		{
+			break;
+		}
+		iOld = iPrev;
+	}
+
+	m_uBack = (UInt32)(iOld & kiIndexMask);
+}
+
+/**
+ * If a fresh snapshot is ready, exchange it with the front buffer.
+ * Otherwise, the front buffer is still the most recent snapshot.
+ */
+PoseSnapshot const* PoseSnapshotBuffer::Acquire()
+{
+	Atomic32Type iOld = m_Ready;
+	while (0 != (iOld & kiFresh))
+	{
+		Atomic32Type const iPrev = m_Ready.CompareAndSet((Atomic32Type)m_uFront, iOld);
+		if (iPrev == iOld)
+		{
+			m_uFront = (UInt32)(iOld & kiIndexMask);
+			m_bAcquired = true;
+			break;
+		}
+		iOld = iPrev;
+	}
+
+	return (m_bAcquired ? &m_a[m_uFront] : nullptr);
+}
+
+UInt32 PoseSnapshotBuffer::GetHeapSize() const
+{
+	UInt32 uReturn = 0u;
+	for (UInt32 i = 0u; i < m_a.GetSize(); ++i)
+	{
+		uReturn += m_a[i].GetHeapSize();
+	}
+	return uReturn;
+}
+
+} // namespace Seoul::Animation2D
+
+#endif // /#if SEOUL_WITH_ANIMATION_2D
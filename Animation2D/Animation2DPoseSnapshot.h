@@ -0,0 +1,117 @@
+/**
+ * \file Animation2DPoseSnapshot.h
+ * \brief Immutable copy of the render state of a DataInstance,
+ * published at the end of posing into a triple buffer. A single
+ * consumer (e.g. the render thread) acquires the most recently
+ * published snapshot without locks and without copies, so posing of
+ * frame N+1 can overlap rendering of frame N.
+ *
+ * Copyright (c) 2016-2022 Demiurge Studios Inc. All rights reserved.
+ */
+
+#pragma once
+#ifndef ANIMATION2D_POSE_SNAPSHOT_H
+#define ANIMATION2D_POSE_SNAPSHOT_H
+
+#include "Animation2DDataInstance.h"
+#include "Atomic32.h"
+#include "FixedArray.h"
+#include "Prereqs.h"
+#include "Vector.h"
+
+#if SEOUL_WITH_ANIMATION_2D
+
+namespace Seoul::Animation2D
+{
+
+/** An active deform of a snapshot, see PoseSnapshot::m_vDeformData. */
+struct PoseSnapshotDeform SEOUL_SEALED
+{
+	PoseSnapshotDeform(const DeformKey& key = DeformKey(), UInt32 uOffset = 0u, UInt32 uSize = 0u)
+		: m_Key(key)
+		, m_uOffset(uOffset)
+		, m_uSize(uSize)
+	{
+	}
+
+	DeformKey m_Key;
+	UInt32 m_uOffset;
+	UInt32 m_uSize;
+}; // struct PoseSnapshotDeform
+
+struct PoseSnapshot SEOUL_SEALED
+{
+	typedef Vector<PoseSnapshotDeform, MemoryBudgets::Animation2D> Deforms;
+
+	PoseSnapshot()
+		: m_vDeforms()
+		, m_vDeformData()
+		, m_vDrawOrder()
+		, m_vSkinningPalette()
+		, m_vSlots()
+		, m_vSlotAttachments()
+		, m_uFrame(0u)
+	{
+	}
+
+	// Deform buffer of key, or nullptr if key has no active deform.
+	Float32 const* FindDeform(const DeformKey& key, UInt32& ruSize) const;
+
+	// Heap footprint of the arrays of this snapshot, in bytes.
+	UInt32 GetHeapSize() const;
+
+	// Active deforms, flattened into a single buffer.
+	Deforms m_vDeforms;
+	DataInstance::DeformData m_vDeformData;
+	DataInstance::DrawOrder m_vDrawOrder;
+	DataInstance::SkinningPalette m_vSkinningPalette;
+	DataInstance::SlotInstances m_vSlots;
+	DataInstance::SlotAttachments m_vSlotAttachments;
+	// Incremented on each publish of the owning instance.
+	UInt32 m_uFrame;
+}; // struct PoseSnapshot
+
+/**
+ * Single producer, single consumer triple buffer of PoseSnapshot. The
+ * producer fills GetBack() and then calls Publish(), the consumer calls
+ * Acquire(). Neither side ever blocks or waits on the other, and the
+ * snapshot returned by Acquire() is not modified until the next Acquire().
+ */
+class PoseSnapshotBuffer SEOUL_SEALED
+{
+public:
+	PoseSnapshotBuffer();
+	~PoseSnapshotBuffer();
+
+	// Producer only.
+	PoseSnapshot& GetBack() { return m_a[m_uBack]; }
+	void Publish();
+
+	// Consumer only. The most recently published snapshot, or
+	// nullptr if no snapshot has been published yet.
+	PoseSnapshot const* Acquire();
+
+	UInt32 GetHeapSize() const;
+
+private:
+	// Set in m_Ready when its buffer has not yet been acquired.
+	static const Atomic32Type kiFresh = 4;
+	static const Atomic32Type kiIndexMask = 3;
+
+	FixedArray<PoseSnapshot, 3u> m_a;
+	// Index of the most recently published buffer, | kiFresh.
+	Atomic32 m_Ready;
+	// Producer only.
+	UInt32 m_uBack;
+	// Consumer only.
+	UInt32 m_uFront;
+	Bool m_bAcquired;
+
+	SEOUL_DISABLE_COPY(PoseSnapshotBuffer);
+}; // class PoseSnapshotBuffer
+
+} // namespace Seoul::Animation2D
+
+#endif // /#if SEOUL_WITH_ANIMATION_2D
+
+#endif // include guard
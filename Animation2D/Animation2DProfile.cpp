@@ -0,0 +1,135 @@
+/**
+ * \file Animation2DProfile.cpp
+ * \brief Lightweight instrumentation of the Animation2D hot paths.
+ * Counters are accumulated per DataDefinition and globally, rolled
+ * into per-frame values by Manager::Tick(), and compiled out entirely
+ * when SEOUL_ANIMATION2D_PROFILING is 0 (the default).
+ *
+ * Copyright (c) 2016-2022 Demiurge Studios Inc. All rights reserved.
+ */
+
+#include "Animation2DProfile.h"
+#include "Mutex.h"
+#include "Vector.h"
+
+#if SEOUL_WITH_ANIMATION_2D
+
+namespace Seoul::Animation2D
+{
+
+Byte const* ToString(ProfileCounter e)
+{
+	switch (e)
+	{
+	case ProfileCounter::kEvaluate: return "Evaluate";
+	case ProfileCounter::kEventDispatch: return "EventDispatch";
+	case ProfileCounter::kApplyCache: return "ApplyCache";
+	case ProfileCounter::kPose: return "Pose";
+	case ProfileCounter::kPoseBone: return "PoseBone";
+	case ProfileCounter::kPoseBoneRun: return "PoseBoneRun";
+	case ProfileCounter::kPoseIk: return "PoseIk";
+	case ProfileCounter::kPosePath: return "PosePath";
+	case ProfileCounter::kPoseTransform: return "PoseTransform";
+	case ProfileCounter::kLoadRead: return "LoadRead";
+	case ProfileCounter::kLoadDecompress: return "LoadDecompress";
+	case ProfileCounter::kLoadDeserialize: return "LoadDeserialize";
+	case ProfileCounter::kLoadSetupPose: return "LoadSetupPose";
+	default:
+		return "Unknown";
+	};
+}
+
+#if SEOUL_ANIMATION2D_PROFILING
+
+namespace
+{
+
+typedef Vector<ProfileStats*, MemoryBudgets::Animation2D> Registry;
+
+// Function statics, stats can be constructed during static initialization.
+Mutex& GetRegistryMutex()
+{
+	static Mutex s_Mutex;
+	return s_Mutex;
+}
+
+Registry& GetRegistry()
+{
+	static Registry s_v;
+	return s_v;
+}
+
+} // namespace anonymous
+
+ProfileStats::ProfileStats()
+	: m_aCalls()
+	, m_aTicks()
+	, m_Frame()
+	, m_LastTotal()
+{
+	Lock lock(GetRegistryMutex());
+	GetRegistry().PushBack(this);
+}
+
+ProfileStats::~ProfileStats()
+{
+	Lock lock(GetRegistryMutex());
+	auto& rv = GetRegistry();
+	for (UInt32 i = 0u; i < rv.GetSize(); ++i)
+	{
+		if (rv[i] == this)
+		{
+			rv[i] = rv.Back();
+			rv.PopBack();
+			break;
+		}
+	}
+}
+
+ProfileStats& ProfileStats::GetGlobal()
+{
+	static ProfileStats s_Global;
+	return s_Global;
+}
+
+/** Called once per frame by Manager::Tick(). */
+void ProfileStats::EndFrameAll()
+{
+	Lock lock(GetRegistryMutex());
+	for (auto p : GetRegistry())
+	{
+		p->EndFrame();
+	}
+}
+
+void ProfileStats::GetTotal(ProfileSnapshot& r) const
+{
+	for (UInt32 i = 0u; i < (UInt32)ProfileCounter::COUNT; ++i)
+	{
+		r.m_aSamples[i].m_iCalls = (Int64)m_aCalls[i];
+		r.m_aSamples[i].m_iTicks = (Int64)m_aTicks[i];
+	}
+}
+
+/**
+ * Counters are only ever incremented, so the frame values are
+ * the difference of the current and previous totals. Adds that
+ * race with this read are attributed to the next frame.
+ */
+void ProfileStats::EndFrame()
+{
+	ProfileSnapshot total;
+	GetTotal(total);
+	for (UInt32 i = 0u; i < (UInt32)ProfileCounter::COUNT; ++i)
+	{
+		m_Frame.m_aSamples[i].m_iCalls = total.m_aSamples[i].m_iCalls - m_LastTotal.m_aSamples[i].m_iCalls;
+		m_Frame.m_aSamples[i].m_iTicks = total.m_aSamples[i].m_iTicks - m_LastTotal.m_aSamples[i].m_iTicks;
+	}
+	m_LastTotal = total;
+}
+
+#endif // /#if SEOUL_ANIMATION2D_PROFILING
+
+} // namespace Seoul::Animation2D
+
+#endif // /#if SEOUL_WITH_ANIMATION_2D
@@ -0,0 +1,246 @@
+/**
+ * \file Animation2DProfile.h
+ * \brief Lightweight instrumentation of the Animation2D hot paths.
+ * Counters are accumulated per DataDefinition and globally, rolled
+ * into per-frame values by Manager::Tick(), and compiled out entirely
+ * when SEOUL_ANIMATION2D_PROFILING is 0 (the default).
+ *
+ * Copyright (c) 2016-2022 Demiurge Studios Inc. All rights reserved.
+ */
+
+#pragma once
+#ifndef ANIMATION2D_PROFILE_H
+#define ANIMATION2D_PROFILE_H
+
+#include "Atomic64.h"
+#include "FixedArray.h"
+#include "Prereqs.h"
+#include "SeoulProfiler.h"
+#include "SeoulTime.h"
+
+// Opt-in - counters are shared atomics, which contend when many
+// threads pose at once, so they are not enabled by build type.
+#ifndef SEOUL_ANIMATION2D_PROFILING
+#	define SEOUL_ANIMATION2D_PROFILING 0
+#endif
+
+#if SEOUL_WITH_ANIMATION_2D
+
+namespace Seoul::Animation2D
+{
+
+enum class ProfileCounter : UInt32
+{
+	kEvaluate,
+	kEventDispatch,
+	kApplyCache,
+	kPose,
+	kPoseBone,
+	kPoseBoneRun,
+	kPoseIk,
+	kPosePath,
+	kPoseTransform,
+	kLoadRead,
+	kLoadDecompress,
+	kLoadDeserialize,
+	kLoadSetupPose,
+	COUNT,
+};
+
+// Stable, human readable name of e (e.g. for telemetry keys).
+Byte const* ToString(ProfileCounter e);
+
+struct ProfileSample SEOUL_SEALED
+{
+	ProfileSample()
+		: m_iCalls(0)
+		, m_iTicks(0)
+	{
+	}
+
+	Double GetMilliseconds() const { return SeoulTime::ConvertTicksToMilliseconds(m_iTicks); }
+
+	Int64 m_iCalls;
+	Int64 m_iTicks;
+}; // struct ProfileSample
+
+struct ProfileSnapshot SEOUL_SEALED
+{
+	typedef FixedArray<ProfileSample, (UInt32)ProfileCounter::COUNT> Samples;
+
+	ProfileSnapshot()
+		: m_aSamples()
+	{
+	}
+
+	const ProfileSample& Get(ProfileCounter e) const { return m_aSamples[(UInt32)e]; }
+
+	Samples m_aSamples;
+}; // struct ProfileSnapshot
+
+#if SEOUL_ANIMATION2D_PROFILING
+
+/**
+ * Counters of a single DataDefinition (or of the entire
+ * module, see GetGlobal()). Add() is thread-safe and lock
+ * free, all other methods are main thread only.
+ */
+class ProfileStats SEOUL_SEALED
+{
+public:
+	ProfileStats();
+	~ProfileStats();
+
+	// Counters of all definitions, including stages that occur
+	// before a definition exists (e.g. file read).
+	static ProfileStats& GetGlobal();
+
+	// Roll the counters of all live stats into their per-frame values.
+	static void EndFrameAll();
+
+	void Add(ProfileCounter e, Int64 iTicks, Int64 iCalls = 1)
+	{
+		m_aCalls[(UInt32)e] += iCalls;
+		m_aTicks[(UInt32)e] += iTicks;
+	}
+
+	// Values accumulated between the two most recent calls to EndFrameAll().
+	const ProfileSnapshot& GetFrame() const { return m_Frame; }
+
+	// Values accumulated over the lifetime of these stats.
+	void GetTotal(ProfileSnapshot& r) const;
+
+private:
+	FixedArray<Atomic64, (UInt32)ProfileCounter::COUNT> m_aCalls;
+	FixedArray<Atomic64, (UInt32)ProfileCounter::COUNT> m_aTicks;
+	ProfileSnapshot m_Frame;
+	ProfileSnapshot m_LastTotal;
+
+	void EndFrame();
+
+	SEOUL_DISABLE_COPY(ProfileStats);
+}; // class ProfileStats
+
+/** Times its scope into the global stats and, if defined, into pStats. */
+class ProfileScope SEOUL_SEALED
+{
+public:
+	ProfileScope(ProfileStats* pStats, ProfileCounter e)
+		: m_pStats(pStats)
+		, m_e(e)
+		, m_iStart(SeoulTime::GetGameTimeInTicks())
+	{
+	}
+
+	~ProfileScope()
+	{
+		auto const iTicks = (SeoulTime::GetGameTimeInTicks() - m_iStart);
+		ProfileStats::GetGlobal().Add(m_e, iTicks);
+		if (nullptr != m_pStats)
+		{
+			m_pStats->Add(m_e, iTicks);
+		}
+	}
+
+private:
+	ProfileStats* const m_pStats;
+	ProfileCounter const m_e;
+	Int64 const m_iStart;
+
+	SEOUL_DISABLE_COPY(ProfileScope);
+}; // class ProfileScope
+
+/**
+ * Breaks down a walk of the pose task list by task type. Each call to
+ * Next() ends the previous task, so there is a single timer query per task,
+ * and counters are committed once, on destruction.
+ */
+class ProfilePoseTasks SEOUL_SEALED
+{
+public:
+	ProfilePoseTasks(ProfileStats* pStats)
+		: m_pStats(pStats)
+		, m_uCurrent(kuNone)
+		, m_iLast(SeoulTime::GetGameTimeInTicks())
+	{
+		for (UInt32 i = 0u; i < (UInt32)ProfileCounter::COUNT; ++i)
+		{
+			m_aCalls[i] = 0;
+			m_aTicks[i] = 0;
+		}
+	}
+
+	~ProfilePoseTasks()
+	{
+		InternalNext(kuNone);
+		auto& rGlobal = ProfileStats::GetGlobal();
+		for (UInt32 i = 0u; i < (UInt32)ProfileCounter::COUNT; ++i)
+		{
+			if (0 == m_aCalls[i])
+			{
+				continue;
+			}
+
+			rGlobal.Add((ProfileCounter)i, m_aTicks[i], m_aCalls[i]);
+			if (nullptr != m_pStats)
+			{
+				m_pStats->Add((ProfileCounter)i, m_aTicks[i], m_aCalls[i]);
+			}
+		}
+	}
+
+	void Next(ProfileCounter e)
+	{
+		InternalNext((UInt32)e);
+	}
+
+private:
+	static const UInt32 kuNone = (UInt32)ProfileCounter::COUNT;
+
+	ProfileStats* const m_pStats;
+	Int64 m_aCalls[(UInt32)ProfileCounter::COUNT];
+	Int64 m_aTicks[(UInt32)ProfileCounter::COUNT];
+	UInt32 m_uCurrent;
+	Int64 m_iLast;
+
+	void InternalNext(UInt32 u)
+	{
+		auto const iNow = SeoulTime::GetGameTimeInTicks();
+		if (kuNone != m_uCurrent)
+		{
+			m_aTicks[m_uCurrent] += (iNow - m_iLast);
+		}
+		if (kuNone != u)
+		{
+			++m_aCalls[u];
+		}
+		m_uCurrent = u;
+		m_iLast = iNow;
+	}
+
+	SEOUL_DISABLE_COPY(ProfilePoseTasks);
+}; // class ProfilePoseTasks
+
+// Time the enclosing scope as counter, with a profiler marker of name.
+// At most one per scope.
+#	define SEOUL_ANIMATION2D_PROFILE(name, pStats, counter) \
+		SEOUL_PROF(name); \
+		::Seoul::Animation2D::ProfileScope animation2DProfileScope((pStats), (counter))
+#	define SEOUL_ANIMATION2D_PROFILE_POSE_TASKS(pStats) \
+		::Seoul::Animation2D::ProfilePoseTasks animation2DProfilePoseTasks((pStats))
+#	define SEOUL_ANIMATION2D_PROFILE_POSE_TASK(counter) \
+		animation2DProfilePoseTasks.Next((counter))
+
+#else // !SEOUL_ANIMATION2D_PROFILING
+
+#	define SEOUL_ANIMATION2D_PROFILE(name, pStats, counter) ((void)0)
+#	define SEOUL_ANIMATION2D_PROFILE_POSE_TASKS(pStats) ((void)0)
+#	define SEOUL_ANIMATION2D_PROFILE_POSE_TASK(counter) ((void)0)
+
+#endif // /#if SEOUL_ANIMATION2D_PROFILING
+
+} // namespace Seoul::Animation2D
+
+#endif // /#if SEOUL_WITH_ANIMATION_2D
+
+#endif // include guard
@@ -9,8 +9,10 @@
 #define ANIMATION_2D_BINARY_UTIL_H
 
 #include "Animation2DAttachment.h"
+#include "Animation2DBakedClip.h"
 #include "Animation2DClipDefinition.h"
 #include "Animation2DDataDefinition.h"
+#include "Matrix2x3.h"
 #include "Path.h"
 #include "StreamBuffer.h"
 
@@ -20,27 +22,164 @@ namespace Seoul::Animation2D
 {
 
 static const UInt32 kuAnimation2DBinarySignature = 0x480129d0;
-static const UInt32 kuAnimation2DBinaryVersion = 2u;
+static const UInt32 kuAnimation2DBinaryVersion = 10u;
 
 template <typename T> struct NeedsDirSeparatorFixup;
 template <> struct NeedsDirSeparatorFixup<HString> { static const Bool Value = false; };
 template <> struct NeedsDirSeparatorFixup<FilePathRelativeFilename> { static const Bool Value = true; };
 
+/**
+ * Types with no padding and no handles (e.g. HString), whose in-memory
+ * layout is also their serialized layout. Vectors of these types are
+ * read and written with a single bulk copy, instead of element by element.
+ *
+ * This is a faster copy, not a zero-copy or memory-mapped format - the
+ * decompressed file is still deserialized into Vector and HashTable
+ * containers that own their data. An offset-based layout used in place
+ * would still need:
+ * - HString tables resolved without interning each string at load.
+ * - view types for DataDefinition and Clip in place of the containers
+ *   (and the HashTable lookups built on them).
+ * - attachments (SharedPtr<Attachment>, linked meshes) resolved from
+ *   offsets instead of allocated per entry.
+ * - DataContentLoader reading uncompressed data in place, instead of
+ *   into a second buffer.
+ */
+template <typename T> struct ReadWriteAsBytes { static const Bool Value = false; };
+template <> struct ReadWriteAsBytes<BezierCurve> { static const Bool Value = true; };
+template <> struct ReadWriteAsBytes<Edge> { static const Bool Value = true; };
+template <> struct ReadWriteAsBytes<Float32> { static const Bool Value = true; };
+template <> struct ReadWriteAsBytes<Int16> { static const Bool Value = true; };
+template <> struct ReadWriteAsBytes<KeyFrame2D> { static const Bool Value = true; };
+template <> struct ReadWriteAsBytes<KeyFrameColor> { static const Bool Value = true; };
+template <> struct ReadWriteAsBytes<KeyFramePathMix> { static const Bool Value = true; };
+template <> struct ReadWriteAsBytes<KeyFramePathPosition> { static const Bool Value = true; };
+template <> struct ReadWriteAsBytes<KeyFramePathSpacing> { static const Bool Value = true; };
+template <> struct ReadWriteAsBytes<KeyFrameRotation> { static const Bool Value = true; };
+template <> struct ReadWriteAsBytes<KeyFrameScale> { static const Bool Value = true; };
+template <> struct ReadWriteAsBytes<KeyFrameTransform> { static const Bool Value = true; };
+template <> struct ReadWriteAsBytes<KeyFrameTwoColor> { static const Bool Value = true; };
+template <> struct ReadWriteAsBytes<Matrix2x3> { static const Bool Value = true; };
+template <> struct ReadWriteAsBytes<MeshAttachmentBoneLink> { static const Bool Value = true; };
+template <> struct ReadWriteAsBytes<PoseBoneRun> { static const Bool Value = true; };
+template <> struct ReadWriteAsBytes<RGBA> { static const Bool Value = true; };
+template <> struct ReadWriteAsBytes<SkinningLayout::Block> { static const Bool Value = true; };
+template <> struct ReadWriteAsBytes<SkinningLayout::Group> { static const Bool Value = true; };
+template <> struct ReadWriteAsBytes<SkinningLayout::Influence> { static const Bool Value = true; };
+template <> struct ReadWriteAsBytes<UInt16> { static const Bool Value = true; };
+template <> struct ReadWriteAsBytes<UInt32> { static const Bool Value = true; };
+template <> struct ReadWriteAsBytes<UInt8> { static const Bool Value = true; };
+template <> struct ReadWriteAsBytes<Vector2D> { static const Bool Value = true; };
+
+// Clip evaluation rounds times to 1e-4 seconds, quantized key
+// frame times must be within half of that.
+static const Float32 kfQuantizeTimeTolerance = 0.5e-4f;
+
+/**
+ * Key frame types that can be written with 16-bit quantized times and
+ * values (see ReadWriteUtil::SetQuantizeTolerance()). Values are the
+ * kuValues contiguous Float32 members starting at Get(). Quantization
+ * only compresses the serialized form - tracks are decoded into full
+ * precision key frames on read.
+ *
+ * Types with members other than the values (e.g. the Bool flags of
+ * KeyFrameIk) override kbFlags, GetFlags() and SetFlags() so that
+ * those members are carried in a byte per key.
+ */
+struct QuantizeTraitsBase
+{
+	static const Bool kbFlags = false;
+	template <typename T> static UInt8 GetFlags(const T&) { return 0u; }
+	template <typename T> static void SetFlags(T&, UInt8) {}
+};
+template <typename T> struct QuantizeTraits;
+template <> struct QuantizeTraits<KeyFrame2D> : public QuantizeTraitsBase
+{
+	static const UInt32 kuValues = 2u;
+	static Float32* Get(KeyFrame2D& r) { return &r.m_fX; }
+	static Float32 const* Get(const KeyFrame2D& r) { return &r.m_fX; }
+};
+template <> struct QuantizeTraits<KeyFrameRotation> : public QuantizeTraitsBase
+{
+	static const UInt32 kuValues = 1u;
+	static Float32* Get(KeyFrameRotation& r) { return &r.m_fAngleInDegrees; }
+	static Float32 const* Get(const KeyFrameRotation& r) { return &r.m_fAngleInDegrees; }
+};
+template <> struct QuantizeTraits<KeyFrameScale> : public QuantizeTraitsBase
+{
+	static const UInt32 kuValues = 2u;
+	static Float32* Get(KeyFrameScale& r) { return &r.m_fX; }
+	static Float32 const* Get(const KeyFrameScale& r) { return &r.m_fX; }
+};
+template <> struct QuantizeTraits<KeyFrameIk> : public QuantizeTraitsBase
+{
+	static const UInt32 kuValues = 2u;
+	static Float32* Get(KeyFrameIk& r) { return &r.m_fMix; }
+	static Float32 const* Get(const KeyFrameIk& r) { return &r.m_fMix; }
+
+	static const Bool kbFlags = true;
+	static UInt8 GetFlags(const KeyFrameIk& r)
+	{
+		return (UInt8)((r.m_bBendPositive ? 1u : 0u) | (r.m_bCompress ? 2u : 0u) | (r.m_bStretch ? 4u : 0u));
+	}
+	static void SetFlags(KeyFrameIk& r, UInt8 u)
+	{
+		r.m_bBendPositive = (0u != (1u & u));
+		r.m_bCompress = (0u != (2u & u));
+		r.m_bStretch = (0u != (4u & u));
+	}
+};
+template <> struct QuantizeTraits<KeyFramePathMix> : public QuantizeTraitsBase
+{
+	static const UInt32 kuValues = 2u;
+	static Float32* Get(KeyFramePathMix& r) { return &r.m_fPositionMix; }
+	static Float32 const* Get(const KeyFramePathMix& r) { return &r.m_fPositionMix; }
+};
+template <> struct QuantizeTraits<KeyFramePathPosition> : public QuantizeTraitsBase
+{
+	static const UInt32 kuValues = 1u;
+	static Float32* Get(KeyFramePathPosition& r) { return &r.m_fPosition; }
+	static Float32 const* Get(const KeyFramePathPosition& r) { return &r.m_fPosition; }
+};
+template <> struct QuantizeTraits<KeyFramePathSpacing> : public QuantizeTraitsBase
+{
+	static const UInt32 kuValues = 1u;
+	static Float32* Get(KeyFramePathSpacing& r) { return &r.m_fSpacing; }
+	static Float32 const* Get(const KeyFramePathSpacing& r) { return &r.m_fSpacing; }
+};
+template <> struct QuantizeTraits<KeyFrameTransform> : public QuantizeTraitsBase
+{
+	static const UInt32 kuValues = 4u;
+	static Float32* Get(KeyFrameTransform& r) { return &r.m_fPositionMix; }
+	static Float32 const* Get(const KeyFrameTransform& r) { return &r.m_fPositionMix; }
+};
+
 class ReadWriteUtil SEOUL_SEALED
 {
 public:
 	ReadWriteUtil(StreamBuffer& rBuffer, Platform ePlatform)
 		: m_r(rBuffer)
 		, m_ePlatform(ePlatform)
+		, m_fQuantizeTolerance(0.0f)
 	{
 	}
 
 	ReadWriteUtil(StreamBuffer& rBuffer)
 		: m_r(rBuffer)
 		, m_ePlatform(PeekPlatform(rBuffer))
+		, m_fQuantizeTolerance(0.0f)
 	{
 	}
 
+	Platform GetPlatform() const { return m_ePlatform; }
+
+	// Write only - when > 0, bone key frames are written with 16-bit
+	// quantized times and values, per track, if the error of every
+	// value of the track is within this tolerance. Reading needs no
+	// setting, the format is recorded per track.
+	Float32 GetQuantizeTolerance() const { return m_fQuantizeTolerance; }
+	void SetQuantizeTolerance(Float32 f) { m_fQuantizeTolerance = f; }
+
 	Bool Read(Float32& r)
 	{
 		return m_r.Read(r);
@@ -95,6 +234,9 @@ public:
 		bReturn = bReturn && m_r.Read(r.m_fFPS);
 		bReturn = bReturn && m_r.Read(r.m_fHeight);
 		bReturn = bReturn && m_r.Read(r.m_fWidth);
+		bReturn = bReturn && m_r.Read(r.m_fBakeSampleRate);
+		bReturn = bReturn && Read(r.m_vBakeClips);
+		bReturn = bReturn && m_r.Read(r.m_fQuantizeTolerance);
 		return bReturn;
 	}
 
@@ -103,6 +245,7 @@ public:
 	{
 		UInt32 u = 0u;
 		if (!m_r.Read(u)) { return false; }
+		if (!CanRead((UInt64)u)) { return false; }
 		t.Reserve(u);
 		t.Clear();
 		for (UInt32 i = 0u; i < u; ++i)
@@ -123,6 +266,7 @@ public:
 	{
 		UInt32 u = 0u;
 		if (!m_r.Read(u)) { return false; }
+		if (!CanRead((UInt64)u)) { return false; }
 		t.Reserve(u);
 		t.Clear();
 		for (UInt32 i = 0u; i < u; ++i)
@@ -143,6 +287,20 @@ public:
 	{
 		UInt32 u = 0u;
 		if (!m_r.Read(u)) { return false; }
+
+		// Bulk copy of types with matching in-memory and serialized layouts.
+		if (ReadWriteAsBytes<T>::Value)
+		{
+			UInt64 const zSizeInBytes = ((UInt64)u * (UInt64)sizeof(T));
+			if (!CanRead(zSizeInBytes)) { return false; }
+
+			r.Clear();
+			r.Resize(u);
+			return (0u == u || m_r.Read(r.Data(), (UInt32)zSizeInBytes));
+		}
+
+		// Every element occupies at least one byte.
+		if (!CanRead((UInt64)u)) { return false; }
 		r.Reserve(u);
 		r.Clear();
 		for (UInt32 i = 0u; i < u; ++i)
@@ -156,6 +314,26 @@ public:
 		return true;
 	}
 
+	Bool Read(SharedPtr<BakedClip>& r)
+	{
+		SharedPtr<BakedClip> p(SEOUL_NEW(MemoryBudgets::Animation2D) BakedClip);
+		if (p->Load(*this))
+		{
+			r.Swap(p);
+			return true;
+		}
+
+		return false;
+	}
+
+	Bool Read(ClipBounds& r)
+	{
+		Bool bReturn = true;
+		bReturn = bReturn && Read(r.m_vMin);
+		bReturn = bReturn && Read(r.m_vMax);
+		return bReturn;
+	}
+
 	Bool Read(SharedPtr<Clip>& r)
 	{
 		SharedPtr<Clip> p(SEOUL_NEW(MemoryBudgets::Animation2D) Clip);
@@ -216,6 +394,14 @@ public:
 		return bReturn;
 	}
 
+	Bool Read(PoseBoneRun& r)
+	{
+		Bool bReturn = true;
+		bReturn = bReturn && Read(r.m_uOffset);
+		bReturn = bReturn && Read(r.m_uCount);
+		return bReturn;
+	}
+
 	Bool Read(RGBA& r)
 	{
 		return m_r.Read(r.m_Value);
@@ -318,6 +504,33 @@ public:
 		return bReturn;
 	}
 
+	Bool Read(SkinningLayout::Block& r)
+	{
+		Bool bReturn = true;
+		for (UInt32 i = 0u; i < SkinningLayout::kuLanes; ++i)
+		{
+			bReturn = bReturn && Read(r.m_auVertex[i]);
+		}
+		return bReturn;
+	}
+
+	Bool Read(SkinningLayout::Group& r)
+	{
+		Bool bReturn = true;
+		bReturn = bReturn && Read(r.m_uBlocks);
+		bReturn = bReturn && Read(r.m_uInfluences);
+		return bReturn;
+	}
+
+	Bool Read(SkinningLayout::Influence& r)
+	{
+		Bool bReturn = true;
+		for (UInt32 i = 0u; i < SkinningLayout::kuLanes; ++i) { bReturn = bReturn && Read(r.m_afWeight[i]); }
+		for (UInt32 i = 0u; i < SkinningLayout::kuLanes; ++i) { bReturn = bReturn && Read(r.m_auBone[i]); }
+		for (UInt32 i = 0u; i < SkinningLayout::kuLanes; ++i) { bReturn = bReturn && Read(r.m_auSource[i]); }
+		return bReturn;
+	}
+
 	Bool Read(SharedPtr<Attachment>& r, const HashTable<HString, SharedPtr<Attachment>, MemoryBudgets::Animation2D>& t)
 	{
 		AttachmentType eType = AttachmentType::kBitmap;
@@ -356,10 +569,10 @@ public:
 	Bool Read(BoneKeyFrames& r)
 	{
 		Bool bReturn = true;
-		bReturn = bReturn && Read(r.m_vRotation);
-		bReturn = bReturn && Read(r.m_vScale);
-		bReturn = bReturn && Read(r.m_vShear);
-		bReturn = bReturn && Read(r.m_vTranslation);
+		bReturn = bReturn && ReadQuantizable(r.m_vRotation);
+		bReturn = bReturn && ReadQuantizable(r.m_vScale);
+		bReturn = bReturn && ReadQuantizable(r.m_vShear);
+		bReturn = bReturn && ReadQuantizable(r.m_vTranslation);
 		return bReturn;
 	}
 
@@ -371,12 +584,23 @@ public:
 		return bReturn;
 	}
 
+	// Ik and transform tracks (the values of the Clip tables).
+	Bool Read(KeyFramesIk& r)
+	{
+		return ReadQuantizable(r);
+	}
+
+	Bool Read(KeyFramesTransform& r)
+	{
+		return ReadQuantizable(r);
+	}
+
 	Bool Read(PathKeyFrames& r)
 	{
 		Bool bReturn = true;
-		bReturn = bReturn && Read(r.m_vMix);
-		bReturn = bReturn && Read(r.m_vPosition);
-		bReturn = bReturn && Read(r.m_vSpacing);
+		bReturn = bReturn && ReadQuantizable(r.m_vMix);
+		bReturn = bReturn && ReadQuantizable(r.m_vPosition);
+		bReturn = bReturn && ReadQuantizable(r.m_vSpacing);
 		return bReturn;
 	}
 
@@ -603,6 +827,9 @@ public:
 		m_r.Write(v.m_fFPS);
 		m_r.Write(v.m_fHeight);
 		m_r.Write(v.m_fWidth);
+		m_r.Write(v.m_fBakeSampleRate);
+		if (!Write(v.m_vBakeClips)) { return false; }
+		m_r.Write(v.m_fQuantizeTolerance);
 		return true;
 	}
 
@@ -654,6 +881,17 @@ public:
 	Bool Write(const Vector<T, MemoryBudgets::Animation2D>& v)
 	{
 		m_r.Write(v.GetSize());
+
+		// Bulk copy of types with matching in-memory and serialized layouts.
+		if (ReadWriteAsBytes<T>::Value)
+		{
+			if (!v.IsEmpty())
+			{
+				m_r.Write(v.Data(), v.GetSizeInBytes());
+			}
+			return true;
+		}
+
 		for (auto const& e : v)
 		{
 			if (!Write(e)) { return false; }
@@ -710,11 +948,32 @@ public:
 		return bReturn;
 	}
 
+	Bool Write(const PoseBoneRun& r)
+	{
+		Bool bReturn = true;
+		bReturn = bReturn && Write(r.m_uOffset);
+		bReturn = bReturn && Write(r.m_uCount);
+		return bReturn;
+	}
+
 	Bool Write(const RGBA& r)
 	{
 		return Write(r.m_Value);
 	}
 
+	Bool Write(const SharedPtr<BakedClip>& p)
+	{
+		return p->Save(*this);
+	}
+
+	Bool Write(const ClipBounds& r)
+	{
+		Bool bReturn = true;
+		bReturn = bReturn && Write(r.m_vMin);
+		bReturn = bReturn && Write(r.m_vMax);
+		return bReturn;
+	}
+
 	Bool Write(const SharedPtr<Clip>& p)
 	{
 		return p->Save(*this);
@@ -811,6 +1070,33 @@ public:
 		return bReturn;
 	}
 
+	Bool Write(const SkinningLayout::Block& r)
+	{
+		Bool bReturn = true;
+		for (UInt32 i = 0u; i < SkinningLayout::kuLanes; ++i)
+		{
+			bReturn = bReturn && Write(r.m_auVertex[i]);
+		}
+		return bReturn;
+	}
+
+	Bool Write(const SkinningLayout::Group& r)
+	{
+		Bool bReturn = true;
+		bReturn = bReturn && Write(r.m_uBlocks);
+		bReturn = bReturn && Write(r.m_uInfluences);
+		return bReturn;
+	}
+
+	Bool Write(const SkinningLayout::Influence& r)
+	{
+		Bool bReturn = true;
+		for (UInt32 i = 0u; i < SkinningLayout::kuLanes; ++i) { bReturn = bReturn && Write(r.m_afWeight[i]); }
+		for (UInt32 i = 0u; i < SkinningLayout::kuLanes; ++i) { bReturn = bReturn && Write(r.m_auBone[i]); }
+		for (UInt32 i = 0u; i < SkinningLayout::kuLanes; ++i) { bReturn = bReturn && Write(r.m_auSource[i]); }
+		return bReturn;
+	}
+
 	Bool Write(const MeshAttachmentBoneLink& r)
 	{
 		Bool bReturn = true;
@@ -842,10 +1128,10 @@ public:
 	Bool Write(const BoneKeyFrames& r)
 	{
 		Bool bReturn = true;
-		bReturn = bReturn && Write(r.m_vRotation);
-		bReturn = bReturn && Write(r.m_vScale);
-		bReturn = bReturn && Write(r.m_vShear);
-		bReturn = bReturn && Write(r.m_vTranslation);
+		bReturn = bReturn && WriteQuantizable(r.m_vRotation);
+		bReturn = bReturn && WriteQuantizable(r.m_vScale);
+		bReturn = bReturn && WriteQuantizable(r.m_vShear);
+		bReturn = bReturn && WriteQuantizable(r.m_vTranslation);
 		return bReturn;
 	}
 
@@ -857,12 +1143,23 @@ public:
 		return bReturn;
 	}
 
+	// Ik and transform tracks (the values of the Clip tables).
+	Bool Write(const KeyFramesIk& v)
+	{
+		return WriteQuantizable(v);
+	}
+
+	Bool Write(const KeyFramesTransform& v)
+	{
+		return WriteQuantizable(v);
+	}
+
 	Bool Write(const PathKeyFrames& r)
 	{
 		Bool bReturn = true;
-		bReturn = bReturn && Write(r.m_vMix);
-		bReturn = bReturn && Write(r.m_vPosition);
-		bReturn = bReturn && Write(r.m_vSpacing);
+		bReturn = bReturn && WriteQuantizable(r.m_vMix);
+		bReturn = bReturn && WriteQuantizable(r.m_vPosition);
+		bReturn = bReturn && WriteQuantizable(r.m_vSpacing);
 		return bReturn;
 	}
 
@@ -1219,10 +1516,201 @@ private:
 		Table m_tTable;
 	}; // class StringTable
 
+	// Checked in 64-bits, so that (corrupt) counts cannot wrap the
+	// size and pass the check, before sizing containers with them.
+	Bool CanRead(UInt64 zSizeInBytes) const
+	{
+		return ((UInt64)m_r.GetOffset() + zSizeInBytes <= (UInt64)m_r.GetTotalDataSizeInBytes());
+	}
+
+	// Format of a quantizable key frame track, see WriteQuantizable().
+	static const UInt8 kuKeyFramesFloat = 0u;
+	static const UInt8 kuKeyFramesQuantized = 1u;
+	// Set in the curve type byte of a quantized key frame that is
+	// followed by a curve data offset (always for Bezier keys).
+	static const UInt8 kuCurveDataOffsetFlag = 0x80;
+
+	static UInt16 Quantize(Float32 f, Float32 fMin, Float32 fMax)
+	{
+		if (!(fMax > fMin)) { return 0u; }
+		auto const fT = Clamp((f - fMin) / (fMax - fMin), 0.0f, 1.0f);
+		return (UInt16)(fT * 65535.0f + 0.5f);
+	}
+
+	static Float32 Dequantize(UInt16 u, Float32 fMin, Float32 fMax)
+	{
+		return (65535u == u ? fMax : fMin + (fMax - fMin) * ((Float32)u / 65535.0f));
+	}
+
+	/**
+	 * Read a track written by WriteQuantizable(), in either format.
+	 * Quantized tracks are decoded into full precision key frames.
+	 */
+	template <typename T>
+	Bool ReadQuantizable(Vector<T, MemoryBudgets::Animation2D>& r)
+	{
+		typedef QuantizeTraits<T> Traits;
+		static const UInt32 kuChannels = Traits::kuValues + 1u;
+
+		UInt8 uFormat = 0u;
+		if (!m_r.Read(uFormat)) { return false; }
+		// Explicitly the Vector<> template, the KeyFramesIk and
+		// KeyFramesTransform overloads would recurse back here.
+		if (kuKeyFramesFloat == uFormat) { return Read<T>(r); }
+		if (kuKeyFramesQuantized != uFormat) { return false; }
+
+		UInt32 u = 0u;
+		if (!m_r.Read(u)) { return false; }
+
+		// Channel 0 is time, followed by the values.
+		Float32 afMin[kuChannels];
+		Float32 afMax[kuChannels];
+		for (UInt32 i = 0u; i < kuChannels; ++i)
+		{
+			if (!m_r.Read(afMin[i])) { return false; }
+			if (!m_r.Read(afMax[i])) { return false; }
+		}
+
+		// Each key is at least its channels, its curve type and
+		// (optionally) its flags.
+		if (!CanRead((UInt64)u * (UInt64)(kuChannels * sizeof(UInt16) + sizeof(UInt8) + (Traits::kbFlags ? sizeof(UInt8) : 0u)))) { return false; }
+		r.Clear();
+		r.Resize(u);
+		for (auto& e : r)
+		{
+			UInt16 uValue = 0u;
+			if (!m_r.Read(uValue)) { return false; }
+			e.m_fTime = Dequantize(uValue, afMin[0], afMax[0]);
+
+			auto pValues = Traits::Get(e);
+			for (UInt32 i = 1u; i < kuChannels; ++i)
+			{
+				if (!m_r.Read(uValue)) { return false; }
+				pValues[i - 1u] = Dequantize(uValue, afMin[i], afMax[i]);
+			}
+			if (Traits::kbFlags)
+			{
+				UInt8 uFlags = 0u;
+				if (!m_r.Read(uFlags)) { return false; }
+				Traits::SetFlags(e, uFlags);
+			}
+
+			UInt8 uType = 0u;
+			if (!m_r.Read(uType)) { return false; }
+			UInt32 uOffset = 0u;
+			if (0u != (kuCurveDataOffsetFlag & uType))
+			{
+				if (!m_r.Read(uOffset)) { return false; }
+				if (uOffset >= (1u << 30u)) { return false; }
+			}
+			uType &= ~kuCurveDataOffsetFlag;
+			if (uType > (UInt8)CurveType::kBezier) { return false; }
+			e.m_uCurveType = uType;
+			e.m_uCurveDataOffset = uOffset;
+		}
+
+		return true;
+	}
+
+	/**
+	 * Write v quantized, if quantization is enabled and the error of
+	 * every time and value is within tolerance, otherwise at full
+	 * precision. Times must also keep their order, so that evaluation
+	 * never sees two keys at the same time.
+	 */
+	template <typename T>
+	Bool WriteQuantizable(const Vector<T, MemoryBudgets::Animation2D>& v)
+	{
+		typedef QuantizeTraits<T> Traits;
+		static const UInt32 kuChannels = Traits::kuValues + 1u;
+
+		Float32 afMin[kuChannels];
+		Float32 afMax[kuChannels];
+		Bool bQuantize = (m_fQuantizeTolerance > 0.0f && v.GetSize() > 1u);
+		if (bQuantize)
+		{
+			for (UInt32 i = 0u; i < kuChannels; ++i)
+			{
+				afMin[i] = FloatMax;
+				afMax[i] = -FloatMax;
+			}
+			for (auto const& e : v)
+			{
+				afMin[0] = Min(afMin[0], e.m_fTime);
+				afMax[0] = Max(afMax[0], e.m_fTime);
+				auto const pValues = Traits::Get(e);
+				for (UInt32 i = 1u; i < kuChannels; ++i)
+				{
+					afMin[i] = Min(afMin[i], pValues[i - 1u]);
+					afMax[i] = Max(afMax[i], pValues[i - 1u]);
+				}
+			}
+
+			UInt16 uPrevTime = 0u;
+			for (UInt32 uKey = 0u; bQuantize && uKey < v.GetSize(); ++uKey)
+			{
+				auto const& e = v[uKey];
+				auto const uTime = Quantize(e.m_fTime, afMin[0], afMax[0]);
+				bQuantize = bQuantize && (Abs(Dequantize(uTime, afMin[0], afMax[0]) - e.m_fTime) <= kfQuantizeTimeTolerance);
+				bQuantize = bQuantize && (0u == uKey || uTime > uPrevTime || e.m_fTime == v[uKey - 1u].m_fTime);
+				uPrevTime = uTime;
+
+				auto const pValues = Traits::Get(e);
+				for (UInt32 i = 1u; i < kuChannels; ++i)
+				{
+					auto const f = pValues[i - 1u];
+					bQuantize = bQuantize && (Abs(Dequantize(Quantize(f, afMin[i], afMax[i]), afMin[i], afMax[i]) - f) <= m_fQuantizeTolerance);
+				}
+			}
+		}
+
+		if (!bQuantize)
+		{
+			m_r.Write(kuKeyFramesFloat);
+			return Write<T>(v);
+		}
+
+		m_r.Write(kuKeyFramesQuantized);
+		m_r.Write(v.GetSize());
+		for (UInt32 i = 0u; i < kuChannels; ++i)
+		{
+			m_r.Write(afMin[i]);
+			m_r.Write(afMax[i]);
+		}
+		for (auto const& e : v)
+		{
+			m_r.Write(Quantize(e.m_fTime, afMin[0], afMax[0]));
+			auto const pValues = Traits::Get(e);
+			for (UInt32 i = 1u; i < kuChannels; ++i)
+			{
+				m_r.Write(Quantize(pValues[i - 1u], afMin[i], afMax[i]));
+			}
+			if (Traits::kbFlags)
+			{
+				m_r.Write(Traits::GetFlags(e));
+			}
+
+			UInt8 uType = (UInt8)e.m_uCurveType;
+			Bool const bOffset = (CurveType::kBezier == e.GetCurveType() || 0u != e.m_uCurveDataOffset);
+			if (bOffset)
+			{
+				uType |= kuCurveDataOffsetFlag;
+			}
+			m_r.Write(uType);
+			if (bOffset)
+			{
+				m_r.Write((UInt32)e.m_uCurveDataOffset);
+			}
+		}
+
+		return true;
+	}
+
 	StreamBuffer& m_r;
 	Platform const m_ePlatform;
 	StringTable<HString> m_HStrings;
 	StringTable<FilePathRelativeFilename> m_RelativePaths;
+	Float32 m_fQuantizeTolerance;
 }; // class ReadWriteUtil
 
 inline static void Obfuscate(
@@ -0,0 +1,352 @@
+/**
+ * \file Animation2DSkinning.cpp
+ * \brief CPU skinning of Animation2D meshes. A SkinningLayout is a
+ * flattened, pre-sorted form of the bone links of a MeshAttachment,
+ * built at cook time and serialized with the mesh. The skinning kernel
+ * consumes it in blocks of 4 vertices and writes posed positions
+ * directly into caller memory (e.g. a mapped vertex buffer).
+ *
+ * Copyright (c) 2016-2022 Demiurge Studios Inc. All rights reserved.
+ */
+
+#include "Animation2DAttachment.h"
+#include "Animation2DReadWriteUtil.h"
+#include "Animation2DSkinning.h"
+#include "SeoulMath.h"
+
+#if SEOUL_WITH_ANIMATION_2D
+
+// SSE is baseline on all x64 targets, otherwise we fall back to the
+// scalar kernel, which the compiler is free to vectorize.
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#	define SEOUL_ANIMATION2D_SSE_SKINNING 1
+#	include <xmmintrin.h>
+#else
+#	define SEOUL_ANIMATION2D_SSE_SKINNING 0
+#endif
+
+namespace Seoul::Animation2D
+{
+
+/** Write a single skinned position to target. */
+static inline void WritePosition(const SkinningTarget& target, UInt32 uVertex, Float32 fX, Float32 fY)
+{
+	auto p = (Float32*)((Byte*)target.m_pVertices + (size_t)uVertex * (size_t)target.m_uStride + (size_t)target.m_uOffset);
+	p[0] = fX;
+	p[1] = fY;
+}
+
+SkinningLayout::SkinningLayout()
+	: m_vBlocks()
+	, m_vGroups()
+	, m_vInfluences()
+	, m_uRequiredBones(0u)
+	, m_uSources(0u)
+	, m_uVertices(0u)
+{
+}
+
+SkinningLayout::~SkinningLayout()
+{
+}
+
+/**
+ * Vertices are grouped by influence count, so the kernel has no
+ * per-vertex branching, and then packed into blocks of kuLanes
+ * vertices with influences stored structure-of-arrays. A partial
+ * final block of a group repeats its last vertex, which writes
+ * the same value twice instead of requiring a masked store.
+ */
+void SkinningLayout::Build(UInt16 const* puCounts, UInt32 uVertices, MeshAttachmentBoneLink const* pLinks)
+{
+	Clear();
+	if (0u == uVertices)
+	{
+		return;
+	}
+
+	// Offset of the first link of each vertex, and the largest group.
+	Vector<UInt32, MemoryBudgets::Animation2D> vuFirst;
+	vuFirst.Resize(uVertices);
+	UInt32 uMaxCount = 0u;
+	UInt32 uLinks = 0u;
+	for (UInt32 i = 0u; i < uVertices; ++i)
+	{
+		vuFirst[i] = uLinks;
+		uLinks += puCounts[i];
+		uMaxCount = Max(uMaxCount, (UInt32)puCounts[i]);
+	}
+
+	for (UInt32 i = 0u; i < uLinks; ++i)
+	{
+		m_uRequiredBones = Max(m_uRequiredBones, pLinks[i].m_uIndex + 1u);
+	}
+
+	// Vertices of each group, in vertex order.
+	Vector<UInt32, MemoryBudgets::Animation2D> vuGroup;
+	vuGroup.Reserve(uVertices);
+	for (UInt32 uCount = 0u; uCount <= uMaxCount; ++uCount)
+	{
+		vuGroup.Clear();
+		for (UInt32 i = 0u; i < uVertices; ++i)
+		{
+			if (puCounts[i] == uCount)
+			{
+				vuGroup.PushBack(i);
+			}
+		}
+
+		if (vuGroup.IsEmpty())
+		{
+			continue;
+		}
+
+		Group group;
+		group.m_uBlocks = (vuGroup.GetSize() + kuLanes - 1u) / kuLanes;
+		group.m_uInfluences = uCount;
+		m_vGroups.PushBack(group);
+
+		for (UInt32 uBlock = 0u; uBlock < group.m_uBlocks; ++uBlock)
+		{
+			Block block;
+			for (UInt32 uLane = 0u; uLane < kuLanes; ++uLane)
+			{
+				UInt32 const uIndex = Min(uBlock * kuLanes + uLane, vuGroup.GetSize() - 1u);
+				block.m_auVertex[uLane] = vuGroup[uIndex];
+			}
+			m_vBlocks.PushBack(block);
+
+			for (UInt32 k = 0u; k < uCount; ++k)
+			{
+				Influence influence;
+				for (UInt32 uLane = 0u; uLane < kuLanes; ++uLane)
+				{
+					UInt32 const uLink = vuFirst[block.m_auVertex[uLane]] + k;
+					influence.m_afWeight[uLane] = pLinks[uLink].m_fWeight;
+					influence.m_auBone[uLane] = pLinks[uLink].m_uIndex;
+					influence.m_auSource[uLane] = uLink;
+				}
+				m_vInfluences.PushBack(influence);
+			}
+		}
+	}
+
+	m_uSources = uLinks;
+	m_uVertices = uVertices;
+}
+
+void SkinningLayout::Clear()
+{
+	m_vBlocks.Clear();
+	m_vGroups.Clear();
+	m_vInfluences.Clear();
+	m_uRequiredBones = 0u;
+	m_uSources = 0u;
+	m_uVertices = 0u;
+}
+
+/**
+ * Read a layout written by Save(). The kernel walks the layout without
+ * bounds checks, so this fails unless the groups, blocks and influences
+ * are consistent and every lane is in range - the vertex of a block must
+ * be < GetVertexCount(), and the bone and source of an influence must be
+ * < GetRequiredBones() and < GetSourceCount() respectively.
+ */
+Bool SkinningLayout::Load(ReadWriteUtil& r)
+{
+	Clear();
+
+	Bool bReturn = true;
+	bReturn = bReturn && r.Read(m_vBlocks);
+	bReturn = bReturn && r.Read(m_vGroups);
+	bReturn = bReturn && r.Read(m_vInfluences);
+	bReturn = bReturn && r.Read(m_uRequiredBones);
+	bReturn = bReturn && r.Read(m_uSources);
+	bReturn = bReturn && r.Read(m_uVertices);
+	if (!bReturn)
+	{
+		Clear();
+		return false;
+	}
+
+	// 64-bit, so corrupt counts cannot wrap into a match.
+	UInt64 uBlocks = 0u;
+	UInt64 uInfluences = 0u;
+	for (auto const& group : m_vGroups)
+	{
+		uBlocks += (UInt64)group.m_uBlocks;
+		uInfluences += (UInt64)group.m_uBlocks * (UInt64)group.m_uInfluences;
+	}
+
+	if (uBlocks != (UInt64)m_vBlocks.GetSize() || uInfluences != (UInt64)m_vInfluences.GetSize())
+	{
+		Clear();
+		return false;
+	}
+
+	for (auto const& block : m_vBlocks)
+	{
+		for (UInt32 uLane = 0u; uLane < kuLanes; ++uLane)
+		{
+			if (block.m_auVertex[uLane] >= m_uVertices)
+			{
+				Clear();
+				return false;
+			}
+		}
+	}
+
+	for (auto const& influence : m_vInfluences)
+	{
+		for (UInt32 uLane = 0u; uLane < kuLanes; ++uLane)
+		{
+			if (influence.m_auBone[uLane] >= m_uRequiredBones ||
+				influence.m_auSource[uLane] >= m_uSources)
+			{
+				Clear();
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+Bool SkinningLayout::Save(ReadWriteUtil& r) const
+{
+	Bool bReturn = true;
+	bReturn = bReturn && r.Write(m_vBlocks);
+	bReturn = bReturn && r.Write(m_vGroups);
+	bReturn = bReturn && r.Write(m_vInfluences);
+	bReturn = bReturn && r.Write(m_uRequiredBones);
+	bReturn = bReturn && r.Write(m_uSources);
+	bReturn = bReturn && r.Write(m_uVertices);
+	return bReturn;
+}
+
+/**
+ * Computes, for each vertex, sum(w * (palette[bone] * source)). pSource
+ * is usually the bone local vertices of the mesh - when the mesh is
+ * deformed, it is the deform buffer, which replaces those vertices in
+ * the same pass (deform data is absolute, not an offset).
+ */
+void SkinningLayout::Skin(
+	Matrix2x3 const* pPalette,
+	Float32 const* pSource,
+	const SkinningTarget& target) const
+{
+	auto pBlock = m_vBlocks.Begin();
+	auto pInfluence = m_vInfluences.Begin();
+	for (auto const& group : m_vGroups)
+	{
+		for (UInt32 uBlock = 0u; uBlock < group.m_uBlocks; ++uBlock, ++pBlock)
+		{
+#if SEOUL_ANIMATION2D_SSE_SKINNING
+			__m128 vX = _mm_setzero_ps();
+			__m128 vY = _mm_setzero_ps();
+			for (UInt32 k = 0u; k < group.m_uInfluences; ++k, ++pInfluence)
+			{
+				auto const& m0 = pPalette[pInfluence->m_auBone[0]];
+				auto const& m1 = pPalette[pInfluence->m_auBone[1]];
+				auto const& m2 = pPalette[pInfluence->m_auBone[2]];
+				auto const& m3 = pPalette[pInfluence->m_auBone[3]];
+				auto const s0 = pSource + 2u * pInfluence->m_auSource[0];
+				auto const s1 = pSource + 2u * pInfluence->m_auSource[1];
+				auto const s2 = pSource + 2u * pInfluence->m_auSource[2];
+				auto const s3 = pSource + 2u * pInfluence->m_auSource[3];
+
+				__m128 const vW = _mm_loadu_ps(pInfluence->m_afWeight);
+				__m128 const vSX = _mm_setr_ps(s0[0], s1[0], s2[0], s3[0]);
+				__m128 const vSY = _mm_setr_ps(s0[1], s1[1], s2[1], s3[1]);
+
+				__m128 vTX = _mm_mul_ps(_mm_setr_ps(m0.M00, m1.M00, m2.M00, m3.M00), vSX);
+				vTX = _mm_add_ps(vTX, _mm_mul_ps(_mm_setr_ps(m0.M01, m1.M01, m2.M01, m3.M01), vSY));
+				vTX = _mm_add_ps(vTX, _mm_setr_ps(m0.M02, m1.M02, m2.M02, m3.M02));
+
+				__m128 vTY = _mm_mul_ps(_mm_setr_ps(m0.M10, m1.M10, m2.M10, m3.M10), vSX);
+				vTY = _mm_add_ps(vTY, _mm_mul_ps(_mm_setr_ps(m0.M11, m1.M11, m2.M11, m3.M11), vSY));
+				vTY = _mm_add_ps(vTY, _mm_setr_ps(m0.M12, m1.M12, m2.M12, m3.M12));
+
+				vX = _mm_add_ps(vX, _mm_mul_ps(vW, vTX));
+				vY = _mm_add_ps(vY, _mm_mul_ps(vW, vTY));
+			}
+
+			Float32 afX[kuLanes];
+			Float32 afY[kuLanes];
+			_mm_storeu_ps(afX, vX);
+			_mm_storeu_ps(afY, vY);
+#else
+			Float32 afX[kuLanes] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			Float32 afY[kuLanes] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			for (UInt32 k = 0u; k < group.m_uInfluences; ++k, ++pInfluence)
+			{
+				for (UInt32 uLane = 0u; uLane < kuLanes; ++uLane)
+				{
+					auto const& m = pPalette[pInfluence->m_auBone[uLane]];
+					auto const s = pSource + 2u * pInfluence->m_auSource[uLane];
+					auto const fW = pInfluence->m_afWeight[uLane];
+					afX[uLane] += fW * (m.M00 * s[0] + m.M01 * s[1] + m.M02);
+					afY[uLane] += fW * (m.M10 * s[0] + m.M11 * s[1] + m.M12);
+				}
+			}
+#endif // /#if SEOUL_ANIMATION2D_SSE_SKINNING
+
+			for (UInt32 uLane = 0u; uLane < kuLanes; ++uLane)
+			{
+				WritePosition(target, pBlock->m_auVertex[uLane], afX[uLane], afY[uLane]);
+			}
+		}
+	}
+}
+
+void SkinningLayout::Transform(
+	const Matrix2x3& m,
+	Float32 const* pSource,
+	UInt32 uVertices,
+	const SkinningTarget& target)
+{
+	UInt32 i = 0u;
+
+#if SEOUL_ANIMATION2D_SSE_SKINNING
+	__m128 const vM00 = _mm_set1_ps(m.M00);
+	__m128 const vM01 = _mm_set1_ps(m.M01);
+	__m128 const vM02 = _mm_set1_ps(m.M02);
+	__m128 const vM10 = _mm_set1_ps(m.M10);
+	__m128 const vM11 = _mm_set1_ps(m.M11);
+	__m128 const vM12 = _mm_set1_ps(m.M12);
+	for (; i + kuLanes <= uVertices; i += kuLanes)
+	{
+		// Deinterleave 4 (x, y) pairs.
+		__m128 const vA = _mm_loadu_ps(pSource + 2u * i + 0u);
+		__m128 const vB = _mm_loadu_ps(pSource + 2u * i + 4u);
+		__m128 const vSX = _mm_shuffle_ps(vA, vB, _MM_SHUFFLE(2, 0, 2, 0));
+		__m128 const vSY = _mm_shuffle_ps(vA, vB, _MM_SHUFFLE(3, 1, 3, 1));
+
+		__m128 const vX = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vM00, vSX), _mm_mul_ps(vM01, vSY)), vM02);
+		__m128 const vY = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vM10, vSX), _mm_mul_ps(vM11, vSY)), vM12);
+
+		Float32 afX[kuLanes];
+		Float32 afY[kuLanes];
+		_mm_storeu_ps(afX, vX);
+		_mm_storeu_ps(afY, vY);
+		for (UInt32 uLane = 0u; uLane < kuLanes; ++uLane)
+		{
+			WritePosition(target, i + uLane, afX[uLane], afY[uLane]);
+		}
+	}
+#endif // /#if SEOUL_ANIMATION2D_SSE_SKINNING
+
+	for (; i < uVertices; ++i)
+	{
+		auto const s = pSource + 2u * i;
+		WritePosition(
+			target,
+			i,
+			m.M00 * s[0] + m.M01 * s[1] + m.M02,
+			m.M10 * s[0] + m.M11 * s[1] + m.M12);
+	}
+}
+
+} // namespace Seoul::Animation2D
+
+#endif // /#if SEOUL_WITH_ANIMATION_2D
@@ -0,0 +1,137 @@
+/**
+ * \file Animation2DSkinning.h
+ * \brief CPU skinning of Animation2D meshes. A SkinningLayout is a
+ * flattened, pre-sorted form of the bone links of a MeshAttachment,
+ * built at cook time and serialized with the mesh. The skinning kernel consumes it in blocks of
+ * 4 vertices and writes posed positions directly into caller memory
+ * (e.g. a mapped vertex buffer).
+ *
+ * Copyright (c) 2016-2022 Demiurge Studios Inc. All rights reserved.
+ */
+
+#pragma once
+#ifndef ANIMATION2D_SKINNING_H
+#define ANIMATION2D_SKINNING_H
+
+#include "Animation2DMemoryUsage.h"
+#include "Matrix2x3.h"
+#include "Prereqs.h"
+#include "Vector.h"
+namespace Seoul { namespace Animation2D { struct MeshAttachmentBoneLink; } }
+namespace Seoul { namespace Animation2D { class ReadWriteUtil; } }
+
+#if SEOUL_WITH_ANIMATION_2D
+
+namespace Seoul::Animation2D
+{
+
+/**
+ * Destination of skinned positions. Position i is written as 2
+ * floats at ((Byte*)m_pVertices + i * m_uStride + m_uOffset).
+ * Other bytes of each vertex are not read or written, so the
+ * target can be write-combined memory.
+ */
+struct SkinningTarget SEOUL_SEALED
+{
+	SkinningTarget(void* pVertices = nullptr, UInt32 uStride = 0u, UInt32 uOffset = 0u)
+		: m_pVertices(pVertices)
+		, m_uStride(uStride)
+		, m_uOffset(uOffset)
+	{
+	}
+
+	void* m_pVertices;
+	UInt32 m_uStride;
+	UInt32 m_uOffset;
+}; // struct SkinningTarget
+
+class SkinningLayout SEOUL_SEALED
+{
+public:
+	static const UInt32 kuLanes = 4u;
+
+	// Output vertices of a block. Padding lanes
+	// repeat the last vertex of the block.
+	struct Block SEOUL_SEALED
+	{
+		UInt32 m_auVertex[kuLanes];
+	}; // struct Block
+
+	// One influence of each lane of a block. m_auSource is the
+	// index of the bone local position (in Vector2D units) in
+	// the vertices (or deform) of the mesh.
+	struct Influence SEOUL_SEALED
+	{
+		Float32 m_afWeight[kuLanes];
+		UInt32 m_auBone[kuLanes];
+		UInt32 m_auSource[kuLanes];
+	}; // struct Influence
+
+	// A run of blocks that all have the same influence count.
+	struct Group SEOUL_SEALED
+	{
+		UInt32 m_uBlocks;
+		UInt32 m_uInfluences;
+	}; // struct Group
+
+	typedef Vector<Block, MemoryBudgets::Animation2D> Blocks;
+	typedef Vector<Group, MemoryBudgets::Animation2D> Groups;
+	typedef Vector<Influence, MemoryBudgets::Animation2D> Influences;
+
+	SkinningLayout();
+	~SkinningLayout();
+
+	// Build from puCounts (one influence count per vertex)
+	// and pLinks (the influences of all vertices, in order).
+	void Build(UInt16 const* puCounts, UInt32 uVertices, MeshAttachmentBoneLink const* pLinks);
+	void Clear();
+
+	// Direct to binary support.
+	Bool Load(ReadWriteUtil& r);
+	Bool Save(ReadWriteUtil& r) const;
+
+	// Compute the weighted positions of all vertices into target. pSource
+	// are the bone local positions of the mesh (or its deform), as float pairs.
+	// pPalette must have at least GetRequiredBones() entries.
+	void Skin(
+		Matrix2x3 const* pPalette,
+		Float32 const* pSource,
+		const SkinningTarget& target) const;
+
+	// Transform uVertices positions of pSource by m into target. Used by meshes
+	// that have no bone links and follow the bone of their slot.
+	static void Transform(
+		const Matrix2x3& m,
+		Float32 const* pSource,
+		UInt32 uVertices,
+		const SkinningTarget& target);
+
+	UInt32 GetHeapSize() const
+	{
+		return
+			Animation2D::GetHeapSize(m_vBlocks) +
+			Animation2D::GetHeapSize(m_vGroups) +
+			Animation2D::GetHeapSize(m_vInfluences);
+	}
+
+	UInt32 GetRequiredBones() const { return m_uRequiredBones; }
+	UInt32 GetSourceCount() const { return m_uSources; }
+	UInt32 GetVertexCount() const { return m_uVertices; }
+	Bool IsEmpty() const { return (0u == m_uVertices); }
+
+private:
+	Blocks m_vBlocks;
+	Groups m_vGroups;
+	Influences m_vInfluences;
+	UInt32 m_uRequiredBones;
+	UInt32 m_uSources;
+	UInt32 m_uVertices;
+
+	SEOUL_DISABLE_COPY(SkinningLayout);
+}; // class SkinningLayout
+
+} // namespace Seoul::Animation2D
+
+#endif // /#if SEOUL_WITH_ANIMATION_2D
+
+#endif // include guard
@@ -27,12 +27,24 @@ State::~State()
 
 void State::Tick(Float fDeltaTimeInSeconds)
 {
-	// Apply the animation cache prior to pose.
+	SEOUL_ANIMATION2D_ASSERT_NOT_IN_POSE_BATCH(*m_pInstance);
+
+	// Applying the cache and posing is the responsibility of the owner
+	// when deferred (e.g. batched posing via Manager::PoseBatch()).
+	if (m_pInstance->IsPoseDeferred())
+	{
+		m_pInstance->MarkCacheEvaluated();
+		return;
+	}
+
+	// Apply the animation cache. This marks the pose as dirty.
 	m_pInstance->ApplyCache();
 
-	// TODO: Break this out into a separate Pose(), so it
-	// is only called if actually rendering a frame.
-	m_pInstance->PoseSkinningPalette();
+	// Lazy posing is computed on query instead (see DataInstance::SetPoseLazy()).
+	if (!m_pInstance->IsPoseLazy())
+	{
+		m_pInstance->Pose();
+	}
 }
 
 } // namespace Seoul::Animation2D